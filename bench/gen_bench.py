@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+###############################################################################
+#
+#               PVSim Verilog Simulator Benchmark Generator
+#
+# Writes a synthetic benchmark design <kind>_<size>.v and its <kind>_<size>.psim
+# workload. Each kind stresses one part of the simulator, and its size scales
+# the design's signal or instance count:
+#
+#   chain       a deep chain of zero-delay gates, toggled from one input
+#   pipeline    a 32-bit registered pipeline of size stage instances
+#   counters    size instances of a counter feeding a small FSM
+#   fanout      clock and reset trees driving size flip-flops
+#   memory      a size-word memory, sqrt(size) words written and read per cycle
+#   tristate    a bus with size tri-state drivers, enabled in turn
+#
+# usage: gen_bench.py <kind> <size> [<cycles>] [<dir>]
+#
+# This file is part of PVSim.
+#
+###############################################################################
+
+import sys, os
+
+kinds = ["chain", "pipeline", "counters", "fanout", "memory", "tristate"]
+
+# The clock period is 10 ns; each design runs for a fixed number of cycles.
+period = 10
+
+def header(kind, size):
+    return ("// PVSim benchmark: %s, size %d (generated by gen_bench.py)\n\n"
+            "`timescale 1 ns / 100 ps\n\n" % (kind, size))
+
+def clockAndReset(out):
+    out.append("    reg         ErrFlag;\n")
+    out.append("    reg         Clk;\n")
+    out.append("    reg         Rst;\n")
+    out.append("    always #%d Clk = ~Clk;\n\n" % (period / 2))
+
+def finish(out, cycles, check):
+    out.append("    initial begin\n")
+    out.append("        Clk = 0;\n")
+    out.append("        Rst = 1;\n")
+    out.append("        #%d Rst = 0;\n" % (2 * period))
+    out.append("        #%d;\n" % (cycles * period))
+    out.append("        $display(\"%s\", %s);\n" % check)
+    out.append("        $display(\"<done>\");\n")
+    out.append("    end\n")
+    out.append("endmodule\n")
+
+#------------------------------------------------------------------------------
+# A chain of size XOR gates: every input edge ripples the length of the chain.
+
+def genChain(size, cycles):
+    out = [header("chain", size), "module main;\n"]
+    clockAndReset(out)
+    out.append("    wire        c0 = Clk;\n")
+    for i in range(1, size + 1):
+        if i % 2:
+            out.append("    wire        c%d = c%d ^ Rst;\n" % (i, i - 1))
+        else:
+            out.append("    wire        c%d = ~c%d;\n" % (i, i - 1))
+    out.append("\n")
+    finish(out, cycles, ("chain end = %b", "c%d" % size))
+    return out
+
+#------------------------------------------------------------------------------
+# A 32-bit pipeline of size register stage instances, each adding one.
+
+def genPipeline(size, cycles):
+    out = [header("pipeline", size)]
+    out.append("""module stage(Clk, In, Out);
+input               Clk;
+input       [31:0]  In;
+output reg  [31:0]  Out;
+
+    always @(posedge Clk)
+        Out <= In + 32'd1;
+endmodule
+
+""")
+    out.append("module main;\n")
+    clockAndReset(out)
+    out.append("    reg [31:0]  In;\n")
+    out.append("    always @(posedge Clk)\n")
+    out.append("        In <= Rst ? 32'd0 : In + 32'd1;\n\n")
+    out.append("    wire [31:0] P0 = In;\n")
+    for i in range(1, size + 1):
+        out.append("    wire [31:0] P%d;\n" % i)
+        out.append("    stage       s%d(Clk, P%d, P%d);\n" % (i, i - 1, i))
+    out.append("\n")
+    finish(out, cycles, ("pipeline out = %h", "P%d" % size))
+    return out
+
+#------------------------------------------------------------------------------
+# size instances of an 8-bit counter driving a 4-state FSM.
+
+def genCounters(size, cycles):
+    out = [header("counters", size)]
+    out.append("""module counter(Clk, Rst, Q);
+input               Clk;
+input               Rst;
+output reg  [7:0]   Q;
+
+    always @(posedge Clk)
+        Q <= Rst ? 8'd0 : Q + 8'd1;
+endmodule
+
+module fsm(Clk, Rst, In, State);
+input               Clk;
+input               Rst;
+input       [7:0]   In;
+output reg  [1:0]   State;
+
+    always @(posedge Clk) begin
+        if (Rst)
+            State <= 2'd0;
+        else
+            case (State)
+                2'd0: if (In[0]) State <= 2'd1;
+                2'd1: if (In[1]) State <= 2'd2;
+                2'd2: if (In[2]) State <= 2'd3;
+                2'd3: State <= 2'd0;
+            endcase
+    end
+endmodule
+
+module unit(Clk, Rst, State);
+input               Clk;
+input               Rst;
+output      [1:0]   State;
+
+    wire [7:0]  Q;
+    counter     cnt0(Clk, Rst, Q);
+    fsm         fsm0(Clk, Rst, Q, State);
+endmodule
+
+""")
+    out.append("module main;\n")
+    clockAndReset(out)
+    for i in range(size):
+        out.append("    wire [1:0]  S%d;\n" % i)
+        out.append("    unit        u%d(Clk, Rst, S%d);\n" % (i, i))
+    out.append("\n")
+    finish(out, cycles, ("fsm state = %d", "S%d" % (size - 1)))
+    return out
+
+#------------------------------------------------------------------------------
+# A clock and a reset buffered through two levels of trees to size toggling
+# flip-flops.
+
+def genFanout(size, cycles):
+    out = [header("fanout", size), "module main;\n"]
+    clockAndReset(out)
+    nBranches = max(1, int(size ** 0.5))
+    for b in range(nBranches):
+        out.append("    wire        Clk%d = Clk;\n" % b)
+        out.append("    wire        Rst%d = Rst;\n" % b)
+    for i in range(size):
+        b = i % nBranches
+        out.append("    reg         F%d;\n" % i)
+        out.append("    always @(posedge Clk%d) F%d <= Rst%d ? 1'b0 : ~F%d;\n"
+                   % (b, i, b, i))
+    out.append("\n")
+    finish(out, cycles, ("last flop = %b", "F%d" % (size - 1)))
+    return out
+
+#------------------------------------------------------------------------------
+# A size-word by 32-bit memory. On every clock, about the square root of size
+# words spread evenly across it are written, and the words written on the
+# clock before read back, moving on by one word each clock, so that the words
+# touched per clock and in all grow with the memory.
+
+def genMemory(size, cycles):
+    nPorts = max(1, int(size ** 0.5))
+    stride = size // nPorts
+    out = [header("memory", size), "module main;\n"]
+    clockAndReset(out)
+    out.append("    reg [31:0]  Mem[0:%d];\n" % (size - 1))
+    out.append("    reg [31:0]  Adr, Sum, Acc;\n")
+    out.append("    integer     i;\n\n")
+    out.append("    always @(posedge Clk) begin\n")
+    out.append("        if (Rst) begin\n")
+    out.append("            Adr <= 32'd0;\n")
+    out.append("            Sum <= 32'd0;\n")
+    out.append("        end\n")
+    out.append("        else begin\n")
+    out.append("            Acc = Sum;\n")
+    out.append("            for (i = 0; i < %d; i = i + 1) begin\n" % nPorts)
+    out.append("                Mem[Adr + i * %d] = Adr ^ Acc;\n" % stride)
+    out.append("                if (Adr != 32'd0)\n")
+    out.append("                    Acc = Acc + Mem[Adr + i * %d - 1];\n"
+               % stride)
+    out.append("            end\n")
+    out.append("            Sum <= Acc;\n")
+    out.append("            Adr <= (Adr == 32'd%d) ? 32'd0 : Adr + 32'd1;\n"
+               % (stride - 1))
+    out.append("        end\n")
+    out.append("    end\n\n")
+    finish(out, cycles, ("memory sum = %h", "Sum"))
+    return out
+
+#------------------------------------------------------------------------------
+# An 8-bit tri-state bus with size drivers, each enabled when a counter
+# selects it.
+
+def genTristate(size, cycles):
+    out = [header("tristate", size), "module main;\n"]
+    clockAndReset(out)
+    sbits = max(1, (size - 1).bit_length())
+    out.append("    reg [%d:0]  Sel;\n" % (sbits - 1))
+    out.append("    tri [7:0]   Bus;\n")
+    out.append("    pullup      (Bus);\n\n")
+    out.append("    always @(posedge Clk)\n")
+    out.append("        Sel <= (Rst || Sel == %d'd%d) ? %d'd0 : Sel + %d'd1;\n\n"
+               % (sbits, size - 1, sbits, sbits))
+    for i in range(size):
+        out.append("    assign Bus = (Sel == %d'd%d) ? 8'd%d : 8'hz;\n"
+                   % (sbits, i, i % 256))
+    out.append("\n")
+    finish(out, cycles, ("bus = %h", "Bus"))
+    return out
+
+generators = {
+    "chain":    genChain,
+    "pipeline": genPipeline,
+    "counters": genCounters,
+    "fanout":   genFanout,
+    "memory":   genMemory,
+    "tristate": genTristate,
+}
+
+#------------------------------------------------------------------------------
+# Write design <kind>_<size>.v and its .psim into dir, returning the .psim
+# file name.
+
+def generate(kind, size, cycles=1000, dir="."):
+    name = "%s_%d" % (kind, size)
+    out = generators[kind](size, cycles)
+    with open(os.path.join(dir, name + ".v"), "w") as f:
+        f.write("".join(out))
+    psimName = os.path.join(dir, name + ".psim")
+    with open(psimName, "w") as f:
+        f.write("duration %d\n" % ((cycles + 3) * period))
+        f.write("load %s.v\n" % name)
+    return psimName
+
+if __name__ == "__main__":
+    if len(sys.argv) < 3 or sys.argv[1] not in kinds:
+        print("usage: gen_bench.py <kind> <size> [<cycles>] [<dir>]")
+        print("kinds:", " ".join(kinds))
+        sys.exit(1)
+    cycles = int(sys.argv[3]) if len(sys.argv) > 3 else 1000
+    dir = sys.argv[4] if len(sys.argv) > 4 else "."
+    print(generate(sys.argv[1], int(sys.argv[2]), cycles, dir))
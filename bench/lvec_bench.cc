@@ -0,0 +1,164 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Level Vector Kernel Benchmark
+//
+// Times each LVector kernel set this CPU runs (scalar, SSSE3, AVX2) on
+// 32- to 512-bit buses of random Levels, after checking that each set's
+// results match the scalar kernels', and prints ns per operation and the
+// speedup over scalar.
+//
+// usage: lvec_bench [<iterations>]
+//
+// This file is part of PVSim.
+//
+// ****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "LVecOps.h"
+
+const int max_bits = 512;
+const int nWidths = 5;
+const size_t widths[nWidths] = { 32, 64, 128, 256, 512 };
+
+Level   src0[max_bits];
+Level   src1[max_bits];
+Level   known[max_bits];        // only LV_L and LV_H
+Level   dest[max_bits];
+Level   ref[max_bits];
+Level   unaryTable[16];
+Level   binaryTable[12][16];
+volatile size_t sink;           // keeps results from being optimized away
+
+//-----------------------------------------------------------------------------
+
+static double seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//-----------------------------------------------------------------------------
+// Check a kernel set's results against the scalar set's on nBits bits.
+
+static bool check(const LVecOps* ops, const LVecOps* scalar, size_t nBits)
+{
+    bool ok = TRUE;
+    scalar->unaryOp(src0, ref, nBits, unaryTable);
+    ops->unaryOp(src0, dest, nBits, unaryTable);
+    ok &= (memcmp(ref, dest, nBits) == 0);
+    scalar->binaryOp(src0, src1, ref, nBits, binaryTable);
+    ops->binaryOp(src0, src1, dest, nBits, binaryTable);
+    ok &= (memcmp(ref, dest, nBits) == 0);
+    size_t n0, n1;
+    ok &= (ops->countHigh(src0, nBits, &n0) ==
+           scalar->countHigh(src0, nBits, &n1));
+    ok &= (ops->countHigh(known, nBits, &n0) &&
+           scalar->countHigh(known, nBits, &n1) && n0 == n1);
+    ok &= (ops->toInt(known, nBits) == scalar->toInt(known, nBits));
+    size_t value = ((size_t)rand() << 32) ^ rand();
+    scalar->fromInt(value, ref, nBits);
+    ops->fromInt(value, dest, nBits);
+    ok &= (memcmp(ref, dest, nBits) == 0);
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+// Time one kernel on nBits bits, returning ns per call.
+
+enum Kernel { k_unary, k_binary, k_reduce, k_fromInt, k_toInt, k_nKernels };
+const char* kernelNames[k_nKernels] =
+    { "unaryOp", "binaryOp", "uand/uor/uxor", "convIntToLVec",
+      "convLVecToInt" };
+
+static double timeKernel(const LVecOps* ops, Kernel kernel, size_t nBits,
+                         long nIter)
+{
+    size_t n;
+    double start = seconds();
+    for (long i = 0; i < nIter; i++)
+    {
+        switch (kernel)
+        {
+            case k_unary:
+                ops->unaryOp(src0, dest, nBits, unaryTable);
+                break;
+            case k_binary:
+                ops->binaryOp(src0, src1, dest, nBits, binaryTable);
+                break;
+            case k_reduce:
+                ops->countHigh(known, nBits, &n);
+                sink = n;
+                break;
+            case k_fromInt:
+                ops->fromInt(i, dest, nBits);
+                break;
+            case k_toInt:
+                sink = ops->toInt(known, nBits);
+                break;
+            default:
+                break;
+        }
+    }
+    return (seconds() - start) * 1e9 / nIter;
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    long nIter = (argc > 1 ? atol(argv[1]) : 2000000);
+    srand(1);
+    for (int i = 0; i < max_bits; i++)
+    {
+        src0[i] = (Level)(rand() % 12);
+        src1[i] = (Level)(rand() % 12);
+        known[i] = (rand() & 1) ? LV_H : LV_L;
+    }
+    for (int i = 0; i < 16; i++)
+        unaryTable[i] = (Level)(rand() % 12);
+    for (int i = 0; i < 12; i++)
+        for (int j = 0; j < 16; j++)
+            binaryTable[i][j] = (Level)(rand() % 12);
+
+    const LVecOps* const* sets = lvecOpsSets();
+    const LVecOps* scalar = sets[0];
+    for (const LVecOps* const* set = sets + 1; *set; set++)
+        for (int w = 0; w < nWidths; w++)
+            if (!check(*set, scalar, widths[w] - 3) ||
+                !check(*set, scalar, widths[w]))
+            {
+                printf("*** %s kernels differ from scalar at %d bits\n",
+                       (*set)->name, (int)widths[w]);
+                return 1;
+            }
+
+    printf("%-14s %5s", "kernel", "bits");
+    for (const LVecOps* const* set = sets; *set; set++)
+        printf(" %9s ns", (*set)->name);
+    printf("  speedup\n");
+    for (int k = 0; k < k_nKernels; k++)
+    {
+        for (int w = 0; w < nWidths; w++)
+        {
+            size_t nBits = widths[w];
+            if ((k == k_fromInt || k == k_toInt) && nBits > 64)
+                continue;           // integers hold at most 64 bits
+            printf("%-14s %5d", kernelNames[k], (int)nBits);
+            double scalarNS = 0., bestNS = 0.;
+            for (const LVecOps* const* set = sets; *set; set++)
+            {
+                double ns = timeKernel(*set, (Kernel)k, nBits, nIter);
+                printf(" %12.1f", ns);
+                if (set == sets)
+                    scalarNS = ns;
+                bestNS = ns;
+            }
+            printf("  %6.1fx\n", scalarNS / bestNS);
+        }
+    }
+    return 0;
+}
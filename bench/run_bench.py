@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+###############################################################################
+#
+#               PVSim Verilog Simulator Benchmark Runner
+#
+# Generates each benchmark design kind at several sizes, simulates each with
+# pvsimu, and reports its compile, init and simulation times, events per
+# second and peak memory. Results are printed as a table and appended to
+# bench_results.csv, one row per run tagged with the PVSim version and date,
+# so that scaling can be compared from release to release.
+#
+# usage: run_bench.py [-c<cycles>] [<kind>[:<size>,...] ...]
+#
+# This file is part of PVSim.
+#
+###############################################################################
+
+import sys, os, re, time
+import subprocess as sb
+import gen_bench
+
+pvsim = "../pvsimu"
+workDir = "designs"
+resultsFile = "bench_results.csv"
+
+# default sizes for each kind, chosen to run in a few seconds at most
+defSizes = {
+    "chain":    [100, 1000, 4000],
+    "pipeline": [10, 50, 100],
+    "counters": [10, 100, 500],
+    "fanout":   [100, 1000, 3000],
+    "memory":   [64, 256, 1024, 1048576],
+    "tristate": [4, 32, 256],
+}
+defCycles = 200
+
+compilePat = re.compile(r"^\s*\[(\d+) signals, ([0-9.]+) sec\]")
+initPat = re.compile(r"^\s*\[([0-9.]+) sec\]")
+simPat = re.compile(r"^\s*\[([0-9.]+) sec, ([0-9.a-z]+) Kevents/sec")
+errPat = re.compile(r"^// \*\*\* (ERROR|WARNING)")
+
+#------------------------------------------------------------------------------
+# Simulate one .psim file, returning a dict of its measurements.
+
+def runOne(psimName):
+    logName = psimName.replace(".psim", ".out")
+    t0 = time.time()
+    with open(logName, "w") as log:
+        pr = sb.Popen([os.path.abspath(pvsim), os.path.basename(psimName)],
+                      stdout=log, stderr=sb.STDOUT, cwd=workDir)
+        pid, status, usage = os.wait4(pr.pid, 0)
+    wall = time.time() - t0
+    r = {"signals": 0, "compile": 0., "init": 0., "sim": 0.,
+         "kevents": 0., "wall": wall, "rss_kb": usage.ru_maxrss,
+         "status": "ok" if status == 0 else "failed"}
+    sawInit = False
+    for line in open(logName):
+        m = compilePat.match(line)
+        if m:
+            r["signals"] = int(m.group(1))
+            r["compile"] = float(m.group(2))
+            continue
+        if "initializing..." in line:
+            sawInit = True
+            continue
+        m = initPat.match(line)
+        if m and sawInit:
+            r["init"] = float(m.group(1))
+            sawInit = False
+            continue
+        m = simPat.match(line)
+        if m:
+            r["sim"] = float(m.group(1))
+            try:
+                r["kevents"] = float(m.group(2))
+            except ValueError:
+                r["kevents"] = 0.      # too fast to time
+            continue
+        m = errPat.match(line)
+        if m and r["status"] == "ok":
+            r["status"] = m.group(1).lower()
+    return r
+
+#------------------------------------------------------------------------------
+
+def version():
+    try:
+        return sb.check_output([pvsim, "-v"]).decode().strip()
+    except (OSError, sb.CalledProcessError):
+        return "?"
+
+def main(args):
+    cycles = defCycles
+    plan = []
+    for arg in args:
+        if arg.startswith("-c"):
+            cycles = int(arg[2:])
+        elif ":" in arg:
+            kind, sizes = arg.split(":")
+            plan.append((kind, [int(s) for s in sizes.split(",")]))
+        else:
+            plan.append((arg, defSizes[arg]))
+    if not plan:
+        plan = [(kind, defSizes[kind]) for kind in gen_bench.kinds]
+    if not os.path.isdir(workDir):
+        os.mkdir(workDir)
+
+    vers = version()
+    date = time.strftime("%Y-%m-%d %H:%M")
+    newFile = not os.path.exists(resultsFile)
+    results = open(resultsFile, "a")
+    if newFile:
+        results.write("version,date,design,size,cycles,signals,compile_s,"
+                      "init_s,sim_s,kevents_per_s,wall_s,peak_rss_kb,status\n")
+
+    print("PVSim %s benchmarks, %s, %d cycles" % (vers, date, cycles))
+    print("%-10s %7s %8s %9s %8s %8s %10s %10s  %s" %
+          ("design", "size", "signals", "compile", "init", "sim",
+           "Kevents/s", "peak KB", "status"))
+    for kind, sizes in plan:
+        for size in sizes:
+            psimName = gen_bench.generate(kind, size, cycles, workDir)
+            r = runOne(psimName)
+            print("%-10s %7d %8d %9.3f %8.3f %8.3f %10.1f %10d  %s" %
+                  (kind, size, r["signals"], r["compile"], r["init"],
+                   r["sim"], r["kevents"], r["rss_kb"], r["status"]))
+            sys.stdout.flush()
+            results.write("%s,%s,%s,%d,%d,%d,%.3f,%.3f,%.3f,%.1f,%.3f,%d,%s\n"
+                          % (vers, date, kind, size, cycles, r["signals"],
+                             r["compile"], r["init"], r["sim"], r["kevents"],
+                             r["wall"], r["rss_kb"], r["status"]))
+    results.close()
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
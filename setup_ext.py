@@ -12,22 +12,33 @@ ext_modules = [
     Pybind11Extension(
         "pvsimu",
         sources = [
+            "src/Checkpoint.cc",
+            "src/DesignCache.cc",
             "src/EvalSignal.cc",
+            "src/EventHist.cc",
+            "src/LVecOps.cc",
+            "src/MemPages.cc",
             "src/ModelPCode.cc",
+            "src/NativeCode.cc",
             "src/PVSimExtension.cc",
+            "src/Profile.cc",
             "src/SimPalSrc.cc",
             "src/Simulator.cc",
             "src/Src.cc",
+            "src/TestChoices.cc",
             "src/Utils.cc",
             "src/VLCoderPCode.cc",
             "src/VLCompiler.cc",
             "src/VLExpr.cc",
             "src/VLInstance.cc",
             "src/VLModule.cc",
+            "src/VLOptPCode.cc",
             "src/VLSysLib.cc",
             "src/Version.cc"],
         define_macros = [("EXTENSION", None)],
-        extra_compile_args = ["-fshort-enums"],
+        extra_compile_args = ["-fshort-enums", "-pthread"],
+        extra_link_args = ["-pthread"],
+        libraries = ["dl"],
     ),
 ]
 
@@ -0,0 +1,633 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Checkpoint and Restore
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Src.h"
+#include "Model.h"
+#include "Checkpoint.h"
+#include "MemPages.h"
+
+// A checkpoint is written at the top of the main loop, before the tick's
+// events are simulated, so that the sweep bitmap is empty and every model
+// thread is suspended. The design is recompiled from the same sources before
+// restoring, which rebuilds everything static: the signal table, equation and
+// p-code, and the models. Only the state that changes while simulating is
+// saved, in this order:
+//
+//      header, region table, design strings, globals, signal state,
+//      saved regions (module instance storage), paged memories,
+//      model threads, pending events, float lists
+//
+// The pointers in saved regions, registered by ckptAddPointers(), are the
+// same for every compile of the design, so they are not read back: the new
+// run's values are kept. Words saved from model thread stacks can't be told
+// apart from data, so any that point into a registered region are relocated
+// to the same offset in the new run's region. The event history before the
+// checkpoint is not kept, and files opened by $fopen are not reopened.
+
+// -------- global variables --------
+
+DLong   gCheckpointNS;          // ns to write checkpoint at, or 0 for none
+char    gRestoreFileName[max_nameLen]; // checkpoint to restore, or ""
+
+// -------- local global variables --------
+
+const char ckptMagic[8] = "PVSCKP2";
+
+struct CkptHeader
+{
+    char        magic[8];
+    Tick        tick;           // tick about to be simulated
+    size_t      nSignals;
+    size_t      nRegions;       // including signals and strings
+    unsigned    namesHash;      // hash of all signal names
+};
+
+// A block of memory that saved words may point into, registered as the
+// design is built. A saved region's contents are also checkpointed.
+
+struct CkptRegion
+{
+    char*       base;
+    size_t      size;
+    bool        isSaved;        // contents are saved in checkpoint
+};
+
+CkptRegion* ckptRegions;        // registered regions, in allocation order
+CkptRegion* ckptRegionsEnd;
+CkptRegion* ckptRegionsLimit;
+Space   ckptRegionSpace =       // registered regions space
+{
+    "checkpoint regions",
+    0,
+    &ckptRegions,
+    sizeof(CkptRegion),
+    &ckptRegionsEnd,
+    &ckptRegionsLimit
+};
+
+size_t** ckptPtrs;              // pointer words in saved regions
+size_t** ckptPtrsEnd;
+size_t** ckptPtrsLimit;
+Space   ckptPtrSpace =          // saved regions' pointers space
+{
+    "checkpoint pointers",
+    0,
+    &ckptPtrs,
+    sizeof(size_t*),
+    &ckptPtrsEnd,
+    &ckptPtrsLimit
+};
+
+char*   ckptStrings;            // start of design strings in gStrings
+
+// The saved regions' contents as the design was built, for starting another
+// run of a design kept in memory.
+
+char*   initialState;
+char*   initialNextString;      // end of strings made while building
+
+// A region of the checkpointed run, and where it is in this one.
+
+struct OldRegion
+{
+    size_t      base;
+    size_t      size;
+    size_t      newBase;
+};
+
+OldRegion* oldRegions;          // checkpointed run's regions, by address
+size_t  nOldRegions;
+
+// Saved globals.
+
+struct CkptGlobals
+{
+    int         lastRand;
+    int         warningCount;
+    size_t      errorSignal;    // signal number + 1, or 0
+    size_t      barSignal;      // signal number + 1, or 0
+    Tick        errorTickB;
+    Tick        errorTickE;
+    double      timeScale;
+    int         timeScaleExp;
+    int         timeDispPrec;
+    int         timeMinFieldWid;
+    char        timeSuffix[max_nameLen];
+};
+
+// Saved dynamic fields of a Signal record.
+
+struct CkptSignal
+{
+    Tick        lastInTime;
+    Tick        lastClkTm;
+    Level       lastLevel:8;
+    Level       inLevel:8;
+    char        ambDepth;
+    char        randDlyCnt;
+};
+
+// A saved pending event.
+
+struct CkptEvent
+{
+    Tick        tick;
+    unsigned    signal;         // signal number
+    Level       level:8;
+    char        is;
+    char        attText[MAX_ATT_TEXT_LEN];
+};
+
+//-----------------------------------------------------------------------------
+// Register a region of memory that saved words may point into. If isSaved,
+//  its contents are saved too. Regions must be registered in the same order
+//  for every compile of a design.
+
+void ckptAddRegion(void* base, size_t size, bool isSaved)
+{
+    if (ckptRegionsEnd >= ckptRegionsLimit)
+        reAllocSpace(&ckptRegionSpace,
+                     2 * (ckptRegionsEnd - ckptRegions) + 256);
+    CkptRegion* region = ckptRegionsEnd++;
+    region->base = (char*)base;
+    region->size = size;
+    region->isSaved = isSaved;
+}
+
+//-----------------------------------------------------------------------------
+// Register n words of a saved region that hold pointers fixed by the design.
+
+void ckptAddPointers(void* base, size_t n)
+{
+    if (ckptPtrsEnd + n > ckptPtrsLimit)
+        reAllocSpace(&ckptPtrSpace, 2 * (ckptPtrsEnd - ckptPtrs) + n + 1024);
+    for (size_t* p = (size_t*)base; n; n--)
+        *ckptPtrsEnd++ = p++;
+}
+
+//-----------------------------------------------------------------------------
+// Forget all registered regions, for a new compile.
+
+void ckptClearRegions()
+{
+    freeSpace(&ckptRegionSpace);
+    freeSpace(&ckptPtrSpace);
+    ckptStrings = 0;
+    free(initialState);
+    initialState = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Note where the design's strings begin: after the project file's tokens,
+//  which differ between a checkpointing and a restoring project.
+
+void ckptMarkStrings()
+{
+    ckptStrings = gNextString;
+}
+
+//-----------------------------------------------------------------------------
+// Write to or read from a checkpoint file, or throw an error.
+
+void ckptWrite(FILE* f, const void* data, size_t size)
+{
+    if (size && fwrite(data, size, 1, f) != 1)
+        throw new VError(verr_io, "can't write checkpoint file");
+}
+
+void ckptRead(FILE* f, void* data, size_t size)
+{
+    if (size && fread(data, size, 1, f) != 1)
+        throw new VError(verr_io, "checkpoint file is truncated");
+}
+
+//-----------------------------------------------------------------------------
+// Relocate a saved word that may point into one of the checkpointed run's
+//  regions, returning the corresponding address in this run, or the word
+//  unchanged.
+
+size_t ckptRelocate(size_t word)
+{
+    size_t lo = 0;
+    size_t hi = nOldRegions;
+    while (lo < hi)             // find last region based at or below word
+    {
+        size_t mid = (lo + hi) / 2;
+        if (oldRegions[mid].base <= word)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == 0)
+        return word;
+    OldRegion* region = &oldRegions[lo - 1];
+    if (word - region->base < region->size)
+        return region->newBase + (word - region->base);
+    return word;
+}
+
+//-----------------------------------------------------------------------------
+// Compare two old regions by base address.
+
+int compareOldRegions(const void* a, const void* b)
+{
+    size_t baseA = ((const OldRegion*)a)->base;
+    size_t baseB = ((const OldRegion*)b)->base;
+    return (baseA < baseB ? -1 : (baseA > baseB));
+}
+
+//-----------------------------------------------------------------------------
+// Add the signal table and the design strings to the registered regions,
+//  and return a hash of the signal names.
+
+unsigned addDesignRegions()
+{
+    if (!ckptStrings)
+        ckptMarkStrings();
+    ckptAddRegion(gSignals, (gNextSignal - gSignals) * sizeof(Signal), FALSE);
+    ckptAddRegion(ckptStrings, gNextString - ckptStrings, FALSE);
+
+    unsigned hash = 2166136261u;
+    for (Signal* signal = gSignals; signal < gNextSignal; signal++)
+        for (const char* p = signal->name(); p && *p; p++)
+            hash = (hash ^ (unsigned char)*p) * 16777619u;
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+// Write the current simulation state to checkpoint file <project>.ckpt.
+
+void writeCheckpoint()
+{
+    char fileName[max_nameLen];
+    snprintf(fileName, sizeof(fileName), "%s.ckpt", gProjName);
+    FILE* f = openFile(fileName, "wb");
+
+    CkptHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ckptMagic, sizeof(header.magic));
+    header.tick = gTick;
+    header.nSignals = gNextSignal - gSignals;
+    header.namesHash = addDesignRegions();
+    header.nRegions = ckptRegionsEnd - ckptRegions;
+    ckptWrite(f, &header, sizeof(header));
+    CkptRegion* region;
+    for (region = ckptRegions; region < ckptRegionsEnd; region++)
+    {
+        ckptWrite(f, &region->base, sizeof(region->base));
+        ckptWrite(f, &region->size, sizeof(region->size));
+    }
+    ckptWrite(f, ckptStrings, gNextString - ckptStrings);
+    ckptRegionsEnd -= 2;        // (design regions are added each time)
+
+    CkptGlobals globals;
+    memset(&globals, 0, sizeof(globals));
+    globals.lastRand = gLastRand;
+    globals.warningCount = gWarningCount;
+    globals.errorSignal = gErrorSignal ? gErrorSignal->index() + 1 : 0;
+    globals.barSignal = gBarSignal ? gBarSignal->index() + 1 : 0;
+    globals.errorTickB = gErrorTickB;
+    globals.errorTickE = gErrorTickE;
+    globals.timeScale = gTimeScale;
+    globals.timeScaleExp = gTimeScaleExp;
+    globals.timeDispPrec = gTimeDispPrec;
+    globals.timeMinFieldWid = gTimeMinFieldWid;
+    strncpy(globals.timeSuffix, gTimeSuffixStr, max_nameLen-1);
+    ckptWrite(f, &globals, sizeof(globals));
+
+    size_t nSignals = header.nSignals;
+    ckptWrite(f, gSigLevel, nSignals * sizeof(Level));
+    ckptWrite(f, gSigNLevel, nSignals * sizeof(Level));
+    ckptWrite(f, gSigPreLevel, nSignals * sizeof(Level));
+    ckptWrite(f, gSigLastTime, nSignals * sizeof(Tick));
+    for (Signal* signal = gSignals; signal < gNextSignal; signal++)
+    {
+        CkptSignal cs;
+        memset(&cs, 0, sizeof(cs));
+        cs.lastInTime = signal->lastInTime;
+        cs.lastClkTm = signal->lastClkTm;
+        cs.lastLevel = signal->lastLevel;
+        cs.inLevel = signal->inLevel;
+        cs.ambDepth = signal->ambDepth;
+        cs.randDlyCnt = signal->randDlyCnt;
+        ckptWrite(f, &cs, sizeof(cs));
+    }
+
+    for (region = ckptRegions; region < ckptRegionsEnd; region++)
+        if (region->isSaved)
+            ckptWrite(f, region->base, region->size);
+
+    checkpointMemPages(f);
+    Model::checkpointAll(f);
+
+    // pending events in simulation order, each numbered by its position
+    size_t nEvents;
+    Event** events = listPendingEvents(&nEvents);
+    unsigned* eventNo = (unsigned*)calloc(gMaxEvents + 1, sizeof(unsigned));
+    if (!eventNo)
+        throw new VError(verr_memOverflow, "no memory to write checkpoint");
+    ckptWrite(f, &nEvents, sizeof(nEvents));
+    for (size_t i = 0; i < nEvents; i++)
+    {
+        Event* event = events[i];
+        CkptEvent ce;
+        memset(&ce, 0, sizeof(ce));
+        ce.tick = event->tick;
+        ce.signal = event->signal->index();
+        ce.level = event->level;
+        ce.is = event->is;
+        if (event->is & ATTACHED_TEXT)
+            memcpy(ce.attText, event->attText(), MAX_ATT_TEXT_LEN);
+        ckptWrite(f, &ce, sizeof(ce));
+        eventNo[event->index] = (unsigned)i;
+    }
+
+    // each tri-state signal's float list, as event numbers
+    for (Signal* signal = gSignals; signal < gNextSignal; signal++)
+    {
+        size_t n = 0;
+        Event* event;
+        for (event = signal->floatList; event; event = event->nextFloat())
+            n++;
+        if (n == 0)
+            continue;
+        unsigned sigNo = signal->index();
+        ckptWrite(f, &sigNo, sizeof(sigNo));
+        ckptWrite(f, &n, sizeof(n));
+        for (event = signal->floatList; event; event = event->nextFloat())
+            ckptWrite(f, &eventNo[event->index], sizeof(unsigned));
+    }
+    unsigned endMark = ~0u;
+    ckptWrite(f, &endMark, sizeof(endMark));
+    free(eventNo);
+    free(events);
+    closeFile(f);
+
+    if (!gQuietMode)
+        display("    wrote checkpoint %s at %2.3f ns (%ld events).\n",
+                fileName, (double)gTick/gTicksNS, (long)nEvents);
+}
+
+//-----------------------------------------------------------------------------
+// Restore the simulation state from a checkpoint file, in place of the
+//  freshly initialized state. The design must be the one checkpointed.
+
+void readCheckpoint(const char* fileName)
+{
+    FILE* f = openFile(fileName, "rb");
+    CkptHeader header;
+    ckptRead(f, &header, sizeof(header));
+    if (memcmp(header.magic, ckptMagic, sizeof(header.magic)) != 0)
+        throw new VError(verr_illegal, "'%s' is not a PVSim checkpoint",
+                         fileName);
+    unsigned namesHash = addDesignRegions();
+    size_t nRegions = ckptRegionsEnd - ckptRegions;
+    size_t nSignals = gNextSignal - gSignals;
+    if (header.nSignals != nSignals || header.namesHash != namesHash ||
+        header.nRegions != nRegions)
+        throw new VError(verr_illegal,
+                         "checkpoint '%s' is for a different design", fileName);
+
+    // map each old region to its new base, sorted by old address
+    oldRegions = (OldRegion*)malloc(nRegions * sizeof(OldRegion));
+    if (!oldRegions)
+        throw new VError(verr_memOverflow, "no memory to read checkpoint");
+    nOldRegions = nRegions;
+    CkptRegion* region;
+    OldRegion* old = oldRegions;
+    for (region = ckptRegions; region < ckptRegionsEnd; region++, old++)
+    {
+        ckptRead(f, &old->base, sizeof(old->base));
+        ckptRead(f, &old->size, sizeof(old->size));
+        old->newBase = (size_t)region->base;
+        if (old->size != region->size && region != ckptRegionsEnd - 1)
+            throw new VError(verr_illegal,
+                    "checkpoint '%s' is for a different design", fileName);
+    }
+
+    // design strings, plus any made while simulating
+    size_t stringsLen = oldRegions[nRegions-1].size;
+    size_t designLen = gNextString - ckptStrings;
+    if (stringsLen < designLen || ckptStrings + stringsLen > gStrings + gMaxStringSpace)
+        throw new VError(verr_illegal,
+                         "checkpoint '%s' is for a different design", fileName);
+    char* strings = (char*)malloc(stringsLen + 1);
+    if (!strings)
+        throw new VError(verr_memOverflow, "no memory to read checkpoint");
+    ckptRead(f, strings, stringsLen);
+    if (memcmp(strings, ckptStrings, designLen) != 0)
+        throw new VError(verr_illegal,
+                         "checkpoint '%s' is for a different design", fileName);
+    memcpy(ckptStrings, strings, stringsLen);
+    gNextString = ckptStrings + stringsLen;
+    free(strings);
+    ckptRegionsEnd -= 2;
+    qsort(oldRegions, nOldRegions, sizeof(OldRegion), compareOldRegions);
+
+    CkptGlobals globals;
+    ckptRead(f, &globals, sizeof(globals));
+    gLastRand = globals.lastRand;
+    gWarningCount = globals.warningCount;
+    gErrorSignal = globals.errorSignal ?
+                        gSignals + globals.errorSignal - 1 : 0;
+    if (globals.barSignal > nSignals)
+        throw new VError(verr_illegal, "bad bar signal in checkpoint '%s'",
+                         fileName);
+    gBarSignal = globals.barSignal ? gSignals + globals.barSignal - 1 : 0;
+    gErrorTickB = globals.errorTickB;
+    gErrorTickE = globals.errorTickE;
+    gTimeScale = globals.timeScale;
+    gTimeScaleExp = globals.timeScaleExp;
+    gTimeDispPrec = globals.timeDispPrec;
+    gTimeMinFieldWid = globals.timeMinFieldWid;
+    globals.timeSuffix[max_nameLen-1] = 0;
+    if (strcmp(gTimeSuffixStr, globals.timeSuffix) != 0)
+        gTimeSuffixStr = newString(globals.timeSuffix);
+
+    ckptRead(f, gSigLevel, nSignals * sizeof(Level));
+    ckptRead(f, gSigNLevel, nSignals * sizeof(Level));
+    ckptRead(f, gSigPreLevel, nSignals * sizeof(Level));
+    ckptRead(f, gSigLastTime, nSignals * sizeof(Tick));
+    Signal* signal;
+    for (signal = gSignals; signal < gNextSignal; signal++)
+    {
+        CkptSignal cs;
+        ckptRead(f, &cs, sizeof(cs));
+        signal->lastInTime = cs.lastInTime;
+        signal->lastClkTm = cs.lastClkTm;
+        signal->lastLevel = cs.lastLevel;
+        signal->inLevel = cs.inLevel;
+        signal->ambDepth = cs.ambDepth;
+        signal->randDlyCnt = cs.randDlyCnt;
+        signal->initDspLevel = signal->level();
+    }
+
+    // saved regions, keeping this run's pointers
+    size_t nPtrs = ckptPtrsEnd - ckptPtrs;
+    size_t* ptrs = (size_t*)malloc((nPtrs + 1) * sizeof(size_t));
+    if (!ptrs)
+        throw new VError(verr_memOverflow, "no memory to read checkpoint");
+    for (size_t j = 0; j < nPtrs; j++)
+        ptrs[j] = *ckptPtrs[j];
+    for (region = ckptRegions; region < ckptRegionsEnd; region++)
+        if (region->isSaved)
+            ckptRead(f, region->base, region->size);
+    for (size_t j = 0; j < nPtrs; j++)
+        *ckptPtrs[j] = ptrs[j];
+    free(ptrs);
+
+    restoreMemPages(f);
+    Model::restoreAll(f);
+
+    // re-post pending events, last first
+    resetTimeline(header.tick);
+    size_t nEvents;
+    ckptRead(f, &nEvents, sizeof(nEvents));
+    Event** events = (Event**)malloc((nEvents + 1) * sizeof(Event*));
+    CkptEvent* saved = (CkptEvent*)malloc((nEvents + 1) * sizeof(CkptEvent));
+    if (!events || !saved)
+        throw new VError(verr_memOverflow, "no memory to read checkpoint");
+    ckptRead(f, saved, nEvents * sizeof(CkptEvent));
+    for (size_t i = nEvents; i-- > 0; )
+    {
+        CkptEvent* ce = &saved[i];
+        if (ce->signal >= nSignals)
+            throw new VError(verr_illegal, "bad event in checkpoint '%s'",
+                             fileName);
+        Event* event = restoreEvent(ce->tick, gSignals + ce->signal,
+                                    ce->level, ce->is);
+        if (ce->is & ATTACHED_TEXT)
+            memcpy(event->attText(), ce->attText, MAX_ATT_TEXT_LEN);
+        events[i] = event;
+    }
+    free(saved);
+
+    while (1)
+    {
+        unsigned sigNo;
+        ckptRead(f, &sigNo, sizeof(sigNo));
+        if (sigNo == ~0u)
+            break;
+        size_t n;
+        ckptRead(f, &n, sizeof(n));
+        if (sigNo >= nSignals)
+            throw new VError(verr_illegal, "bad float list in checkpoint '%s'",
+                             fileName);
+        Event* last = 0;
+        for ( ; n; n--)
+        {
+            unsigned i;
+            ckptRead(f, &i, sizeof(i));
+            if (i >= nEvents)
+                throw new VError(verr_illegal,
+                                 "bad float list in checkpoint '%s'", fileName);
+            if (last)
+                last->setNextFloat(events[i]);
+            else
+                gSignals[sigNo].floatList = events[i];
+            last = events[i];
+        }
+    }
+    free(events);
+    free(oldRegions);
+    oldRegions = 0;
+    nOldRegions = 0;
+    closeFile(f);
+
+    // show the restored levels of displayed signals as events at this tick
+    for (signal = gSignals; signal < gNextSignal; signal++)
+    {
+        if (!(signal->is & DISPLAYED) ||
+            (signal->info()->busOpt & DISP_BUS) ||
+            signal->level() == signal->initLevel)
+            continue;
+#ifdef WRITE_EVENTS
+        if (gPrevEvtTick != gTick)
+        {
+            fprintf(gEvFile, "\n%llu:", gTick);
+            gPrevEvtTick = gTick;
+        }
+        fprintf(gEvFile, " %d=%c",
+            (int)(signal - gSignals), gLevelNames[signal->level()]);
+#else
+        PyObject* val = Py_BuildValue("c", gLevelNames[signal->level()]);
+        addEventPy(signal, gTick, val);
+#endif
+    }
+
+    if (!gQuietMode)
+        display("    restored checkpoint %s at %2.3f ns (%ld events).\n",
+                fileName, (double)gTick/gTicksNS, (long)nEvents);
+}
+
+//-----------------------------------------------------------------------------
+// Save the just-built design's saved regions, so that a later run of it can
+//  start from the same state.
+
+void ckptSaveInitialState()
+{
+    size_t size = 0;
+    CkptRegion* region;
+    for (region = ckptRegions; region < ckptRegionsEnd; region++)
+        if (region->isSaved)
+            size += region->size;
+    free(initialState);
+    initialState = (char*)malloc(size + 1);
+    if (!initialState)
+        throw new VError(verr_memOverflow, "no memory to save design state");
+    char* p = initialState;
+    for (region = ckptRegions; region < ckptRegionsEnd; region++)
+        if (region->isSaved)
+        {
+            memcpy(p, region->base, region->size);
+            p += region->size;
+        }
+    initialNextString = gNextString;
+}
+
+//-----------------------------------------------------------------------------
+// Put a design kept in memory back into its state as built: restore its
+//  saved regions, empty its paged memories, and drop any strings made while
+//  simulating.
+
+void ckptRestoreInitialState()
+{
+    if (!initialState)
+        throw new VError(verr_bug, "no saved design state to restore");
+    char* p = initialState;
+    for (CkptRegion* region = ckptRegions; region < ckptRegionsEnd; region++)
+        if (region->isSaved)
+        {
+            memcpy(region->base, p, region->size);
+            p += region->size;
+        }
+    clearAllMemPages();
+    gNextString = initialNextString;
+}
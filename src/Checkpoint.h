@@ -0,0 +1,51 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Checkpoint and Restore
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include <stdio.h>
+#include "Utils.h"
+#include "PSignal.h"
+
+// A checkpoint file holds a simulation's dynamic state at the start of one
+// tick: signal levels, pending events, module instance storage, and each
+// model's p-code thread. It is restored into a fresh compile of the same
+// design. Pointers in instance storage are fixed by the design, so they are
+// registered as it is built and kept from the fresh compile. Pointers in
+// thread stacks are relocated by their offsets within the regions of memory
+// that were registered, in the same order, while the design was built.
+
+extern DLong    gCheckpointNS;  // ns to write checkpoint at, or 0 for none
+extern char     gRestoreFileName[max_nameLen]; // checkpoint to restore, or ""
+
+void ckptAddRegion(void* base, size_t size, bool isSaved);
+void ckptAddPointers(void* base, size_t n);
+void ckptClearRegions();
+void ckptMarkStrings();
+void ckptWrite(FILE* f, const void* data, size_t size);
+void ckptRead(FILE* f, void* data, size_t size);
+size_t ckptRelocate(size_t word);
+void writeCheckpoint();
+void readCheckpoint(const char* fileName);
+void ckptSaveInitialState();
+void ckptRestoreInitialState();
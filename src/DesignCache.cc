@@ -0,0 +1,1228 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Compiled Design Cache
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <new>
+#ifndef _WIN32
+#include <pthread.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef __APPLE__
+#include <mach-o/loader.h>
+#include <mach-o/dyld.h>
+#else
+#include <link.h>
+#endif
+#endif
+
+#include "DesignCache.h"
+#include "Src.h"
+#include "Model.h"
+#include "VLCoder.h"
+#include "VLCompiler.h"
+#include "Checkpoint.h"
+#include "NativeCode.h"
+#include "Profile.h"
+#include "LVecOps.h"
+#include "TestChoices.h"
+
+// The design heap is a range of address space reserved at a fixed address,
+// from which operator new and the memory spaces allocate. Blocks up to 4K
+// are kept on free lists by size; larger ones are whole pages, reused first-
+// fit from an address-ordered free list and merged with their neighbors when
+// freed. The heap's own state is kept at its base, so that it is part of a
+// cached image. Where the address can't be reserved, or on Windows, the heap
+// is just malloc() and designs aren't cached.
+
+// -------- global variables --------
+
+bool    gDesignCache;           // cache designs, from -k or 'cache'
+char    gCacheDir[max_nameLen] = "."; // design cache directory
+
+#ifndef _WIN32
+
+// -------- local global variables --------
+
+char* const heapBase = (char*)0x3f0000000000;   // fixed heap address
+const size_t heapReserve = (size_t)1 << 37;     // 128 GB of address space
+const size_t heapCommitStep = (size_t)64 << 20; // made writable 64 MB at once
+const size_t heapGrain = 16;                    // block size and alignment
+const size_t heapSmallMax = 4096;               // largest small block
+const size_t heapPage = 4096;                   // large block size unit
+const size_t heapReleaseMin = 65536;            // smallest block released
+const size_t heapTagUsed = 0x70617568737670ul;  // marks an allocated block
+
+// A heap block's header, and its link to the next block while it's free.
+
+struct HeapBlock
+{
+    size_t      size;           // whole block, including header
+    size_t      tag;            // heapTagUsed while allocated
+    HeapBlock*  next;           // next free block
+};
+
+const size_t heapHeaderLen = 2 * sizeof(size_t);
+
+// The heap's state, at its base.
+
+struct HeapState
+{
+    char*       top;                            // end of all blocks
+    HeapBlock*  small[heapSmallMax / heapGrain + 1]; // free blocks, by size
+    HeapBlock*  large;                          // free pages, by address
+};
+
+static HeapState* heap;         // the design heap, or 0 if using malloc()
+static bool     heapTried;      // TRUE once the heap has been reserved
+static char*    heapCommitted;  // end of the heap's writable memory
+static pthread_mutex_t heapLock = PTHREAD_MUTEX_INITIALIZER;
+
+static char     cacheFileName[2 * max_nameLen]; // this design's file, or ""
+
+//-----------------------------------------------------------------------------
+// Make the heap writable up to a given address.
+
+static bool heapCommit(char* end)
+{
+    if (end <= heapCommitted)
+        return TRUE;
+    size_t len = (end - heapCommitted + heapCommitStep - 1) /
+                  heapCommitStep * heapCommitStep;
+    if (heapCommitted + len > heapBase + heapReserve ||
+        mprotect(heapCommitted, len, PROT_READ | PROT_WRITE) != 0)
+        return FALSE;
+    heapCommitted += len;
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Reserve the heap's address space, if that address is free.
+
+static void heapInit()
+{
+    heapTried = TRUE;
+    int flags = MAP_PRIVATE | MAP_ANON | MAP_NORESERVE;
+#ifdef MAP_FIXED_NOREPLACE
+    flags |= MAP_FIXED_NOREPLACE;
+#endif
+    char* base = (char*)mmap(heapBase, heapReserve, PROT_NONE, flags, -1, 0);
+    if (base == (char*)MAP_FAILED)
+        return;
+    if (base != heapBase)
+    {
+        munmap(base, heapReserve);
+        return;
+    }
+    heapCommitted = heapBase;
+    if (!heapCommit(heapBase + heapPage))
+        return;
+    heap = (HeapState*)heapBase;
+    heap->top = heapBase + heapPage;
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if an address is in the heap.
+
+static inline bool inHeap(const void* p)
+{
+    return heap && (char*)p >= heapBase && (char*)p < heapBase + heapReserve;
+}
+
+//-----------------------------------------------------------------------------
+// Return the size of the block needed for n bytes, or 0 if too large.
+
+static size_t heapBlockSize(size_t n)
+{
+    if (n > heapReserve)
+        return 0;
+    size_t size = (n + heapHeaderLen + heapGrain - 1) & ~(heapGrain - 1);
+    if (size < 2 * heapGrain)
+        size = 2 * heapGrain;
+    else if (size > heapSmallMax)
+        size = (size + heapPage - 1) & ~(heapPage - 1);
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+// Take a block of a given size from a free list or the top of the heap.
+//  Called with the heap locked.
+
+static HeapBlock* heapTake(size_t size)
+{
+    HeapBlock* block;
+    if (size <= heapSmallMax)
+    {
+        HeapBlock** list = &heap->small[size / heapGrain];
+        if ((block = *list) != 0)
+        {
+            *list = block->next;
+            return block;
+        }
+    }
+    else
+    {
+        for (HeapBlock** link = &heap->large; (block = *link) != 0;
+             link = &block->next)
+            if (block->size >= size)
+            {
+                if (block->size - size > heapSmallMax)
+                {
+                    HeapBlock* rest = (HeapBlock*)((char*)block + size);
+                    rest->size = block->size - size;
+                    rest->next = block->next;
+                    *link = rest;
+                    block->size = size;
+                }
+                else
+                    *link = block->next;
+                return block;
+            }
+    }
+    block = (HeapBlock*)heap->top;
+    if (!heapCommit(heap->top + size))
+        return 0;
+    heap->top += size;
+    block->size = size;
+    return block;
+}
+
+//-----------------------------------------------------------------------------
+// Put a block back on its free list. A large block is merged with any free
+//  neighbors, and its pages given back to the system. Called with the heap
+//  locked.
+
+static void heapPut(HeapBlock* block)
+{
+    block->tag = 0;
+    if (block->size <= heapSmallMax)
+    {
+        HeapBlock** list = &heap->small[block->size / heapGrain];
+        block->next = *list;
+        *list = block;
+        return;
+    }
+
+    HeapBlock** prevLink = 0;
+    HeapBlock** link = &heap->large;
+    while (*link && *link < block)
+    {
+        prevLink = link;
+        link = &(*link)->next;
+    }
+    HeapBlock* next = *link;
+    if (next && (char*)block + block->size == (char*)next)
+    {
+        block->size += next->size;
+        next = next->next;
+    }
+    HeapBlock* prev = prevLink ? *prevLink : 0;
+    if (prev && (char*)prev + prev->size == (char*)block)
+    {
+        prev->size += block->size;
+        block = prev;
+        link = prevLink;
+    }
+    block->next = next;
+    *link = block;
+
+    char* end = (char*)block + block->size;
+    if (end == heap->top)
+    {
+        *link = next;
+        heap->top = (char*)block;
+    }
+    if (block->size >= heapReleaseMin)
+    {
+        // only the whole pages past the header: neighbors may share the rest
+        char* start = (char*)(((size_t)(block + 1) + heapPage - 1) &
+                              ~(heapPage - 1));
+        end = (char*)((size_t)end & ~(heapPage - 1));
+        if (end > start)
+            madvise(start, end - start, MADV_DONTNEED);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Allocate memory from the heap, like malloc().
+
+void* heapAlloc(size_t size)
+{
+    pthread_mutex_lock(&heapLock);
+    if (!heapTried)
+        heapInit();
+    bool useHeap = (heap != 0);
+    HeapBlock* block = 0;
+    if (useHeap)
+    {
+        size_t blockSize = heapBlockSize(size);
+        if (blockSize)
+            block = heapTake(blockSize);
+    }
+    pthread_mutex_unlock(&heapLock);
+
+    if (!useHeap)
+        return malloc(size);
+    if (!block)
+        return 0;
+    block->tag = heapTagUsed;
+    return (char*)block + heapHeaderLen;
+}
+
+//-----------------------------------------------------------------------------
+// Allocate zeroed memory from the heap, like calloc().
+
+void* heapCalloc(size_t n, size_t size)
+{
+    if (size && n > heapReserve / size)
+        return 0;
+    void* p = heapAlloc(n * size);
+    if (p)
+        memset(p, 0, n * size);
+    return p;
+}
+
+//-----------------------------------------------------------------------------
+// Free memory allocated from the heap, like free().
+
+void heapFree(void* p)
+{
+    if (!inHeap(p))
+    {
+        free(p);
+        return;
+    }
+    HeapBlock* block = (HeapBlock*)((char*)p - heapHeaderLen);
+    if (block->tag != heapTagUsed)
+        return;
+    pthread_mutex_lock(&heapLock);
+    heapPut(block);
+    pthread_mutex_unlock(&heapLock);
+}
+
+//-----------------------------------------------------------------------------
+// Resize memory allocated from the heap, like realloc(). A block at the top
+//  of the heap grows in place.
+
+void* heapRealloc(void* p, size_t size)
+{
+    if (!p)
+        return heapAlloc(size);
+    if (!inHeap(p))
+        return realloc(p, size);
+    HeapBlock* block = (HeapBlock*)((char*)p - heapHeaderLen);
+    size_t blockSize = heapBlockSize(size);
+    if (!blockSize)
+        return 0;
+    if (blockSize <= block->size)
+        return p;
+
+    pthread_mutex_lock(&heapLock);
+    char* end = (char*)block + block->size;
+    bool grown = (end == heap->top &&
+                  heapCommit((char*)block + blockSize));
+    if (grown)
+    {
+        heap->top = (char*)block + blockSize;
+        block->size = blockSize;
+    }
+    pthread_mutex_unlock(&heapLock);
+    if (grown)
+        return p;
+
+    void* newP = heapAlloc(size);
+    if (newP)
+    {
+        memcpy(newP, p, block->size - heapHeaderLen);
+        heapFree(p);
+    }
+    return newP;
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if designs may be cached: the heap is at its fixed address.
+
+static bool heapReady()
+{
+    pthread_mutex_lock(&heapLock);
+    if (!heapTried)
+        heapInit();
+    bool ready = (heap != 0);
+    pthread_mutex_unlock(&heapLock);
+    return ready;
+}
+
+//-----------------------------------------------------------------------------
+// Operator new allocates from the heap, so that every object a design is
+//  built from is in it. (Operator delete is a stub, in Utils.cc.)
+
+void* operator new(size_t size)
+{
+    for (;;)
+    {
+        void* p = heapAlloc(size);
+        if (p)
+            return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return heapAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return heapAlloc(size);
+}
+
+// -------- the globals kept with a cached design --------
+
+// Globals defined without a header declaration.
+
+struct MemPages;
+
+extern Space    srcStampSpace;
+extern bool     srcStamping;
+extern bool     srcStampsValid;
+extern Space    ckptRegionSpace;
+extern Space    ckptPtrSpace;
+extern char*    ckptStrings;
+extern Space    histChunkSpace;
+extern Space    histFirstRecSpace;
+extern Space    histLastRecSpace;
+extern MemPages* gMemPagesList;
+extern Model*   gModelsList;
+extern const char* gLastModelName;
+extern bool     gTracedMode;
+extern Space    natSubrSpace;
+extern Space    gSigProfileSpace;
+extern Space    gSigLevelSpace;
+extern Space    gSigNLevelSpace;
+extern Space    gSigPreLevelSpace;
+extern Space    gSigLastTimeSpace;
+extern Space    gSigInfoSpace;
+extern Space    gDependStartSpace;
+extern Space    gInputStartSpace;
+extern Space    gSigEdgesSpace;
+extern Space    gDependsSpace;
+extern Space    gInputsSpace;
+extern Space    gSweepOutsSpace;
+extern Space    gSweepOrderSpace;
+extern Space    gSigSweepPosSpace;
+extern Space    sweepCountSpace;
+extern bool     gDependsFrozen;
+extern Space    eventSlabSpace;
+extern Space    sweepDirtySpace;
+extern Event*   freeEventList;
+extern size_t   nFreeEvents;
+extern PCode*   pcStart;
+extern PCode*   pcEnd;
+extern PCode*   pcSubr;
+extern int*     sp;
+extern const char* kExTypeName[ty_none+1];
+extern bool     gVerilogInstantiated;
+
+struct CacheGlobal
+{
+    void*       base;
+    size_t      size;
+};
+
+#define CACHE_GLOBAL(var)   { (void*)&(var), sizeof(var) }
+
+// The settings a project file may change. Their values before compiling
+// are part of a cached design's name.
+
+static CacheGlobal cacheSettings[] =
+{
+    CACHE_GLOBAL(VL::debugLevel),
+    CACHE_GLOBAL(gNSStart),
+    CACHE_GLOBAL(gNSDuration),
+    CACHE_GLOBAL(gCmdEventMemLimit),
+    CACHE_GLOBAL(gLevelize),
+    CACHE_GLOBAL(gOptimizePCode),
+    CACHE_GLOBAL(gNativeCode),
+    CACHE_GLOBAL(gNativeDir),
+    CACHE_GLOBAL(gProfile),
+    CACHE_GLOBAL(gProfileTopN),
+    CACHE_GLOBAL(gTelemetryNS),
+    CACHE_GLOBAL(gCheckpointNS),
+    CACHE_GLOBAL(gRestoreFileName),
+    CACHE_GLOBAL(gTagDebug)
+};
+
+// The globals that compiling leaves pointing into the heap or sets.
+
+static CacheGlobal cacheGlobals[] =
+{
+    CACHE_GLOBAL(gScToken),
+    CACHE_GLOBAL(gHashTable),
+    CACHE_GLOBAL(gLastSymbol),
+    CACHE_GLOBAL(gLastNewSymbol),
+    CACHE_GLOBAL(gMaxStringSpace),
+    CACHE_GLOBAL(gMacros),
+    CACHE_GLOBAL(VL::baseSrc),
+    CACHE_GLOBAL(srcStamping),
+    CACHE_GLOBAL(srcStampsValid),
+    CACHE_GLOBAL(SimObject::simObjList),
+    CACHE_GLOBAL(gBlockList),
+    CACHE_GLOBAL(gDP),
+    CACHE_GLOBAL(gDPEnd),
+    CACHE_GLOBAL(gDPUsage),
+    CACHE_GLOBAL(gWarningCount),
+    CACHE_GLOBAL(gFlaggedErrCount),
+    CACHE_GLOBAL(gFatalLoadErrors),
+    CACHE_GLOBAL(gLastRand),
+    CACHE_GLOBAL(ckptStrings),
+    CACHE_GLOBAL(gMemPagesList),
+    CACHE_GLOBAL(gModelsList),
+    CACHE_GLOBAL(gLastModelName),
+    CACHE_GLOBAL(gTracedMode),
+    CACHE_GLOBAL(gMaxSignals),
+    CACHE_GLOBAL(gDependsFrozen),
+    CACHE_GLOBAL(gNSweepModels),
+    CACHE_GLOBAL(gNSignals),
+    CACHE_GLOBAL(gTicksNS),
+    CACHE_GLOBAL(gBreakSignal),
+    CACHE_GLOBAL(gStopSignal),
+    CACHE_GLOBAL(gSignalDisplayOn),
+    CACHE_GLOBAL(gNameLenLimit),
+    CACHE_GLOBAL(gTracedModel),
+    CACHE_GLOBAL(gDispBusWidth),
+    CACHE_GLOBAL(gDispBusBitNo),
+    CACHE_GLOBAL(gEventMemLimit),
+    CACHE_GLOBAL(gMaxEvents),
+    CACHE_GLOBAL(freeEventList),
+    CACHE_GLOBAL(nFreeEvents),
+    CACHE_GLOBAL(gBarSignal),
+    CACHE_GLOBAL(gErrorSignal),
+    CACHE_GLOBAL(gErrorTickB),
+    CACHE_GLOBAL(gErrorTickE),
+    CACHE_GLOBAL(gDispTStart),
+    CACHE_GLOBAL(gTimeScaleExp),
+    CACHE_GLOBAL(gTimeScale),
+    CACHE_GLOBAL(gTimeRoundExp),
+    CACHE_GLOBAL(gTimeDispPrec),
+    CACHE_GLOBAL(gTimeSuffixStr),
+    CACHE_GLOBAL(gTimeMinFieldWid),
+    CACHE_GLOBAL(pc),
+    CACHE_GLOBAL(pcStart),
+    CACHE_GLOBAL(pcEnd),
+    CACHE_GLOBAL(pcSubr),
+    CACHE_GLOBAL(sp),
+    CACHE_GLOBAL(vc),
+    { (void*)kPCodeName, p_last * sizeof(kPCodeName[0]) },
+    CACHE_GLOBAL(kExTypeName),
+    CACHE_GLOBAL(gVerilogInstantiated),
+    CACHE_GLOBAL(Scope::global),
+    CACHE_GLOBAL(Scope::local),
+    CACHE_GLOBAL(Expr::pool),
+    CACHE_GLOBAL(Expr::poolEnd),
+    CACHE_GLOBAL(Expr::next),
+    CACHE_GLOBAL(Expr::gatherTriggers),
+    CACHE_GLOBAL(Expr::conditionedTriggers),
+    CACHE_GLOBAL(Expr::watchMemReads),
+    CACHE_GLOBAL(Expr::curTriggers),
+    CACHE_GLOBAL(Expr::parmOnly),
+    CACHE_GLOBAL(EvHand::gAssignsReset)
+};
+
+// Every memory space, whose base, end and limit pointers are kept too.
+
+static Space* cacheSpaces[] =
+{
+    &gStringsSpace,
+    &srcStampSpace,
+    &ckptRegionSpace,
+    &ckptPtrSpace,
+    &histChunkSpace,
+    &histFirstRecSpace,
+    &histLastRecSpace,
+    &natSubrSpace,
+    &gSigProfileSpace,
+    &gSignalSpace,
+    &gSigLevelSpace,
+    &gSigNLevelSpace,
+    &gSigPreLevelSpace,
+    &gSigLastTimeSpace,
+    &gSigInfoSpace,
+    &gDependStartSpace,
+    &gInputStartSpace,
+    &gSigEdgesSpace,
+    &gDependsSpace,
+    &gInputsSpace,
+    &gSweepOutsSpace,
+    &gSweepOrderSpace,
+    &gSigSweepPosSpace,
+    &sweepCountSpace,
+    &eventSlabSpace,
+    &sweepDirtySpace
+};
+
+const int nCacheSettings = sizeof(cacheSettings) / sizeof(CacheGlobal);
+const int nCacheGlobals = sizeof(cacheGlobals) / sizeof(CacheGlobal);
+const int nCacheSpaces = sizeof(cacheSpaces) / sizeof(Space*);
+const int max_cacheItems = nCacheSettings + nCacheGlobals + 4 * nCacheSpaces;
+
+// -------- cache files --------
+
+const char cacheMagic[8] = "PVSDC1";
+
+struct CacheHeader
+{
+    char        magic[8];
+    char        build[64];      // simulator version and build date
+    size_t      moduleSize;     // size of simulator's code and data
+    char*       moduleBase;     //  and where they were loaded
+    char*       heapTop;        // end of heap image
+    size_t      globalsLen;     // length of globals
+    size_t      nRelocs;        // number of words to relocate
+    size_t      relocsPos;      // file position of relocations
+    size_t      fileSize;
+};
+
+// A run of heap pages that aren't all zeroes. The heap image is a list of
+// runs, ended by one of length 0.
+
+struct CacheRun
+{
+    size_t      offset;         // from heapBase
+    size_t      len;
+};
+
+// Words that point into the simulator's code and data, found when writing.
+
+static char**   relocs;
+static size_t   nRelocs;
+static size_t   maxRelocs;
+
+// A library may be loaded elsewhere in the process reading the file, so a
+// design that points to a library's data or functions, such as P-code that
+// calls a C library function directly, isn't cached. Other pointers into a
+// library's code are return addresses, left in uninitialized fields.
+
+struct LibSegment
+{
+    char*       lo;
+    char*       hi;
+    bool        isCode;
+};
+
+const int max_libSegments = 1000;
+
+static LibSegment libSegments[max_libSegments]; // other libraries' segments
+static int      nLibSegments;
+static char*    libLo;          // range of all library segments
+static char*    libHi;
+static bool     libraryPtrs;    // TRUE if a word points to a library
+
+//-----------------------------------------------------------------------------
+// Return the FNV-1a hash of a block of memory, continuing from a given hash.
+
+static unsigned long hashBytes(const void* p, size_t size,
+                               unsigned long hash = 14695981039346656037ul)
+{
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ ((unsigned char*)p)[i]) * 1099511628211ul;
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+// Make a list of the memory kept with a cached design, returning its length.
+
+static int getCacheItems(CacheGlobal* items)
+{
+    int n = 0;
+    int i;
+    for (i = 0; i < nCacheSettings; i++)
+        items[n++] = cacheSettings[i];
+    for (i = 0; i < nCacheGlobals; i++)
+        items[n++] = cacheGlobals[i];
+    for (i = 0; i < nCacheSpaces; i++)
+    {
+        Space* space = cacheSpaces[i];
+        items[n].base = &space->mallocBase;
+        items[n++].size = sizeof(char*);
+        items[n].base = space->base;
+        items[n++].size = sizeof(char*);
+        items[n].base = space->end;
+        items[n++].size = sizeof(char*);
+        items[n].base = space->limit;
+        items[n++].size = sizeof(char*);
+    }
+    return n;
+}
+
+//-----------------------------------------------------------------------------
+// Find where the simulator's code and data are loaded.
+
+#ifdef __APPLE__
+
+static void findModule(char** lo, char** hi)
+{
+    *lo = *hi = 0;
+    Dl_info info;
+    if (!dladdr((void*)&gDesignCache, &info))
+        return;
+    const mach_header_64* header = (const mach_header_64*)info.dli_fbase;
+    char* slide = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const load_command* cmd = (const load_command*)(header + 1);
+        for (uint32_t i = 0; i < header->ncmds; i++)
+        {
+            const segment_command_64* seg = (const segment_command_64*)cmd;
+            cmd = (const load_command*)((char*)cmd + cmd->cmdsize);
+            if (seg->cmd != LC_SEGMENT_64 || seg->initprot == 0)
+                continue;
+            if (pass == 0)
+            {
+                if (strcmp(seg->segname, "__TEXT") == 0)
+                    slide = (char*)header - seg->vmaddr;
+                continue;
+            }
+            char* base = slide + seg->vmaddr;
+            if (!*lo || base < *lo)
+                *lo = base;
+            if (base + seg->vmsize > *hi)
+                *hi = base + seg->vmsize;
+        }
+    }
+}
+
+#else
+
+struct ModuleRange
+{
+    char*       lo;
+    char*       hi;
+};
+
+static int findModuleRange(struct dl_phdr_info* info, size_t size, void* data)
+{
+    ModuleRange* range = (ModuleRange*)data;
+    char* lo = 0;
+    char* hi = 0;
+    for (int i = 0; i < info->dlpi_phnum; i++)
+    {
+        const ElfW(Phdr)* phdr = &info->dlpi_phdr[i];
+        if (phdr->p_type != PT_LOAD)
+            continue;
+        char* base = (char*)(info->dlpi_addr + phdr->p_vaddr);
+        if (!lo || base < lo)
+            lo = base;
+        if (base + phdr->p_memsz > hi)
+            hi = base + phdr->p_memsz;
+    }
+    char* adr = (char*)&gDesignCache;
+    if (adr < lo || adr >= hi)
+        return 0;
+    range->lo = lo;
+    range->hi = hi;
+    return 1;
+}
+
+static void findModule(char** lo, char** hi)
+{
+    ModuleRange range = { 0, 0 };
+    dl_iterate_phdr(findModuleRange, &range);
+    *lo = range.lo;
+    *hi = range.hi;
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+// Add a segment of another library to the list.
+
+static void addLibSegment(char* lo, char* hi, bool isCode)
+{
+    if (nLibSegments >= max_libSegments)
+        return;
+    LibSegment* seg = &libSegments[nLibSegments++];
+    seg->lo = lo;
+    seg->hi = hi;
+    seg->isCode = isCode;
+    if (!libLo || lo < libLo)
+        libLo = lo;
+    if (hi > libHi)
+        libHi = hi;
+}
+
+//-----------------------------------------------------------------------------
+// Find where the other libraries' code and data are loaded.
+
+#ifdef __APPLE__
+
+static void findLibraries()
+{
+    nLibSegments = 0;
+    libLo = libHi = 0;
+    Dl_info info;
+    if (!dladdr((void*)&gDesignCache, &info))
+        return;
+    for (uint32_t i = 0; i < _dyld_image_count(); i++)
+    {
+        const mach_header_64* header =
+                        (const mach_header_64*)_dyld_get_image_header(i);
+        if (header == info.dli_fbase)
+            continue;
+        char* slide = (char*)_dyld_get_image_vmaddr_slide(i);
+        const load_command* cmd = (const load_command*)(header + 1);
+        for (uint32_t j = 0; j < header->ncmds; j++)
+        {
+            const segment_command_64* seg = (const segment_command_64*)cmd;
+            cmd = (const load_command*)((char*)cmd + cmd->cmdsize);
+            if (seg->cmd != LC_SEGMENT_64 || seg->initprot == 0)
+                continue;
+            char* base = slide + seg->vmaddr;
+            addLibSegment(base, base + seg->vmsize,
+                          (seg->initprot & VM_PROT_EXECUTE) != 0);
+        }
+    }
+}
+
+#else
+
+static int findLibraryRanges(struct dl_phdr_info* info, size_t size,
+                             void* data)
+{
+    ModuleRange range;
+    if (findModuleRange(info, size, &range))
+        return 0;                   // (skip the simulator)
+    for (int i = 0; i < info->dlpi_phnum; i++)
+    {
+        const ElfW(Phdr)* phdr = &info->dlpi_phdr[i];
+        if (phdr->p_type != PT_LOAD)
+            continue;
+        char* base = (char*)(info->dlpi_addr + phdr->p_vaddr);
+        addLibSegment(base, base + phdr->p_memsz, (phdr->p_flags & PF_X) != 0);
+    }
+    return 0;
+}
+
+static void findLibraries()
+{
+    nLibSegments = 0;
+    libLo = libHi = 0;
+    dl_iterate_phdr(findLibraryRanges, 0);
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+// Return TRUE if a word points to another library's data or functions.
+
+static bool isLibraryPtr(char* adr)
+{
+    if (adr < libLo || adr >= libHi)
+        return FALSE;
+    for (int i = 0; i < nLibSegments; i++)
+        if (adr >= libSegments[i].lo && adr < libSegments[i].hi)
+        {
+            if (!libSegments[i].isCode)
+                return TRUE;
+            Dl_info info;
+            return (dladdr(adr, &info) && info.dli_saddr == adr);
+        }
+    return FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// Look for a 'cache ["dir"]' line in a project file, which is read before
+//  compiling. Returns TRUE if found, and sets the directory if given.
+
+static bool scanCacheCommand(const char* projFileName, char* dir)
+{
+    FILE* fp = fopen(projFileName, "r");
+    if (!fp)
+        return FALSE;               // (compiling will report it)
+    bool found = FALSE;
+    char line[max_messageLen];
+    while (fgets(line, sizeof(line), fp))
+    {
+        char word[max_nameLen];
+        char name[max_nameLen];
+        int n = sscanf(line, "%99s \"%99[^\"]\"", word, name);
+        if (n >= 1 && strcmp(word, "cache") == 0)
+        {
+            found = TRUE;
+            if (n == 2)
+                strcpy(dir, name);
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+// Set the name of a design's cache file, from a hash of the working
+//  directory, project file name, test choice and settings.
+
+static void setCacheFileName(const char* dir, const char* projFileName,
+                             const char* testChoice)
+{
+    char cwd[1024];
+    if (!getcwd(cwd, sizeof(cwd)))
+        cwd[0] = 0;
+    unsigned long key = hashBytes(cwd, strlen(cwd) + 1);
+    key = hashBytes(projFileName, strlen(projFileName) + 1, key);
+    if (testChoice)
+        key = hashBytes(testChoice, strlen(testChoice) + 1, key);
+    else
+        key = hashBytes("\377", 1, key);
+    for (int i = 0; i < nCacheSettings; i++)
+        key = hashBytes(cacheSettings[i].base, cacheSettings[i].size, key);
+    snprintf(cacheFileName, sizeof(cacheFileName), "%s/%s_%016lx.pvcache",
+             dir, gProjName, key);
+}
+
+//-----------------------------------------------------------------------------
+// Set the build string identifying this simulator.
+
+static void getBuild(char* build, size_t len)
+{
+    memset(build, 0, len);
+    snprintf(build, len, "%s %s", gPSVersion, gPSDate);
+}
+
+//-----------------------------------------------------------------------------
+// If the compiled design for a project and test choice is in the design
+//  cache, and all of its source files are unchanged, read it in place of the
+//  one being built and return TRUE.
+
+bool readDesignCache(const char* projFileName, const char* testChoice)
+{
+    cacheFileName[0] = 0;
+    char dir[max_nameLen];
+    strcpy(dir, gCacheDir);
+    bool useCache = scanCacheCommand(projFileName, dir) || gDesignCache;
+    if (!useCache || gTestWorkers || !heapReady())
+        return FALSE;
+    setCacheFileName(dir, projFileName, testChoice);
+
+    FILE* fp = fopen(cacheFileName, "rb");
+    if (!fp)
+        return FALSE;
+    char* moduleLo;
+    char* moduleHi;
+    findModule(&moduleLo, &moduleHi);
+    CacheGlobal items[max_cacheItems];
+    int nItems = getCacheItems(items);
+    size_t globalsLen = 0;
+    int i;
+    for (i = 0; i < nItems; i++)
+        globalsLen += items[i].size;
+    CacheHeader header;
+    char build[sizeof(header.build)];
+    getBuild(build, sizeof(build));
+    struct stat st;
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+        memcmp(header.build, build, sizeof(build)) != 0 ||
+        header.moduleSize != (size_t)(moduleHi - moduleLo) ||
+        header.globalsLen != globalsLen ||
+        header.heapTop < heapBase || header.heapTop > heapBase + heapReserve ||
+        fstat(fileno(fp), &st) != 0 || (size_t)st.st_size != header.fileSize ||
+        !readSrcStamps(fp))
+    {
+        fclose(fp);
+        return FALSE;
+    }
+
+    // read the globals and relocations before disturbing this design
+    char* globals = (char*)malloc(globalsLen);
+    char** relocList = (char**)malloc((header.nRelocs + 1) * sizeof(char*));
+    long imagePos = ftell(fp) + globalsLen;
+    bool ok = (globals && relocList &&
+               fread(globals, 1, globalsLen, fp) == globalsLen &&
+               fseek(fp, header.relocsPos, SEEK_SET) == 0 &&
+               fread(relocList, sizeof(char*), header.nRelocs, fp) ==
+                     header.nRelocs &&
+               fseek(fp, imagePos, SEEK_SET) == 0);
+    if (!ok)
+    {
+        free(globals);
+        free(relocList);
+        fclose(fp);
+        return FALSE;
+    }
+
+    // replace the heap with the cached image: clear it, then read each run
+    nativeClearSubrs();
+    pthread_mutex_lock(&heapLock);
+    ok = (mmap(heapBase, heapCommitted - heapBase, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANON | MAP_FIXED | MAP_NORESERVE, -1, 0) ==
+          heapBase && heapCommit(header.heapTop));
+    CacheRun run;
+    while (ok && (ok = (fread(&run, sizeof(run), 1, fp) == 1)) && run.len)
+        ok = (run.offset + run.len <= (size_t)(header.heapTop - heapBase) &&
+              fread(heapBase + run.offset, 1, run.len, fp) == run.len);
+    pthread_mutex_unlock(&heapLock);
+    fclose(fp);
+    if (!ok)
+    {
+        free(globals);
+        free(relocList);
+        throw new VError(verr_io, "can't read design cache file '%s'",
+                         cacheFileName);
+    }
+
+    // restore the globals, and move pointers into the simulator's code and
+    // data by the difference in where it is loaded
+    char* p = globals;
+    for (i = 0; i < nItems; i++)
+    {
+        memcpy(items[i].base, p, items[i].size);
+        p += items[i].size;
+    }
+    size_t delta = moduleLo - header.moduleBase;
+    if (delta)
+        for (size_t r = 0; r < header.nRelocs; r++)
+        {
+            char* word = relocList[r];
+            if (word >= header.moduleBase &&
+                word < header.moduleBase + header.moduleSize)
+                word += delta;
+            *(size_t*)word += delta;
+        }
+    free(globals);
+    free(relocList);
+
+    saveTimeFormat();
+    selectLVecOps();
+    if (!gQuietMode)
+        display("    loaded compiled design from '%s'\n", cacheFileName);
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Note each word of a block of memory that points into the simulator's code
+//  and data, and any that point to another library's data or functions.
+
+static void findRelocs(char* base, size_t size, char* lo, char* hi)
+{
+    char** end = (char**)((size_t)(base + size) & ~(sizeof(char*) - 1));
+    for (char** word = (char**)(((size_t)base + sizeof(char*) - 1) &
+                                ~(sizeof(char*) - 1)); word < end; word++)
+        if (*word >= lo && *word < hi)
+        {
+            if (nRelocs >= maxRelocs)
+            {
+                maxRelocs = 2 * maxRelocs + 4096;
+                relocs = (char**)realloc(relocs, maxRelocs * sizeof(char*));
+                if (!relocs)
+                    throw new VError(verr_memOverflow,
+                                     "no memory to write design cache");
+            }
+            relocs[nRelocs++] = (char*)word;
+        }
+        else if (isLibraryPtr(*word))
+            libraryPtrs = TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Return FALSE if a heap page has never been written, and so is all zeroes,
+//  according to the process's page map, where it has one. Reading the
+//  untouched pages instead, such as those of each model's stack, would
+//  fault every one of them in.
+
+static bool pageWritten(char* page)
+{
+    static int mapFd = -2;
+    static unsigned long long entries[512];  // page map entries from first
+    static char* first;
+    static size_t nEntries;
+    if (mapFd == -2)
+        mapFd = open("/proc/self/pagemap", O_RDONLY);
+    if (mapFd < 0)
+        return TRUE;
+    if (page < first || page >= first + nEntries * heapPage)
+    {
+        first = page;
+        off_t pos = (off_t)((size_t)page / heapPage * sizeof(entries[0]));
+        ssize_t n = pread(mapFd, entries, sizeof(entries), pos);
+        nEntries = (n > 0 ? n / sizeof(entries[0]) : 0);
+        if (!nEntries)
+            return TRUE;
+    }
+    return (entries[(page - first) / heapPage] >> 62) != 0; // present/swapped
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if a block of memory is all zeroes.
+
+static bool isZero(const char* p, size_t len)
+{
+    const size_t* word = (const size_t*)p;
+    const size_t* end = (const size_t*)(p + len);
+    for (; word < end; word++)
+        if (*word)
+            return FALSE;
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Write the design just compiled to its cache file, unless it failed or
+//  depends on more than its source files. It's written under a temporary
+//  name and then renamed, so that other processes see all or none of it.
+
+void writeDesignCache()
+{
+    if (!cacheFileName[0] || !srcStampsValid || gFatalLoadErrors ||
+        !inHeap(vc.projSrc))
+        return;
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+    getBuild(header.build, sizeof(header.build));
+    char* moduleLo;
+    char* moduleHi;
+    findModule(&moduleLo, &moduleHi);
+    if (!moduleLo)
+        return;
+    header.moduleSize = moduleHi - moduleLo;
+    header.moduleBase = moduleLo;
+    header.heapTop = heap->top;
+
+    char tempName[sizeof(cacheFileName) + 20];
+    snprintf(tempName, sizeof(tempName), "%s.%d", cacheFileName,
+             (int)getpid());
+    FILE* fp = fopen(tempName, "wb");
+    if (!fp)
+    {
+        display("*** can't write design cache file '%s'\n", tempName);
+        return;
+    }
+    fwrite(&header, sizeof(header), 1, fp);
+    writeSrcStamps(fp);
+
+    // the expression pool is scratch space for each statement, so it's saved
+    // cleared rather than with whatever the last one left there
+    resetExprPool();
+    memset((void*)Expr::pool, 0, (Expr::poolEnd - Expr::pool) * sizeof(Expr));
+
+    nRelocs = 0;
+    libraryPtrs = FALSE;
+    findLibraries();
+    CacheGlobal items[max_cacheItems];
+    int nItems = getCacheItems(items);
+    for (int i = 0; i < nItems; i++)
+    {
+        fwrite(items[i].base, 1, items[i].size, fp);
+        header.globalsLen += items[i].size;
+        findRelocs((char*)items[i].base, items[i].size, moduleLo, moduleHi);
+    }
+
+    CacheRun run;
+    run.len = 0;
+    for (char* page = heapBase; page < heap->top; page += heapPage)
+    {
+        size_t len = heap->top - page;
+        if (len > heapPage)
+            len = heapPage;
+        bool zero = (!pageWritten(page) || isZero(page, len));
+        if (!zero)
+        {
+            findRelocs(page, len, moduleLo, moduleHi);
+            if (!run.len)
+                run.offset = page - heapBase;
+            run.len += len;
+        }
+        if (run.len && (zero || page + len == heap->top))
+        {
+            fwrite(&run, sizeof(run), 1, fp);
+            fwrite(heapBase + run.offset, 1, run.len, fp);
+            run.len = 0;
+        }
+    }
+    fwrite(&run, sizeof(run), 1, fp);
+
+    header.nRelocs = nRelocs;
+    header.relocsPos = ftell(fp);
+    fwrite(relocs, sizeof(char*), nRelocs, fp);
+    header.fileSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    fwrite(&header, sizeof(header), 1, fp);
+    bool ok = !ferror(fp);
+    if (fclose(fp) != 0)
+        ok = FALSE;
+    if (ok && !libraryPtrs && rename(tempName, cacheFileName) == 0)
+        return;
+    remove(tempName);
+    if (libraryPtrs)
+        display("*** design not cached: it points into a library\n");
+    else
+        display("*** can't write design cache file '%s'\n", cacheFileName);
+}
+
+#else // _WIN32
+
+void* heapAlloc(size_t size)
+{
+    return malloc(size);
+}
+
+void* heapCalloc(size_t n, size_t size)
+{
+    return calloc(n, size);
+}
+
+void* heapRealloc(void* p, size_t size)
+{
+    return realloc(p, size);
+}
+
+void heapFree(void* p)
+{
+    free(p);
+}
+
+bool readDesignCache(const char* projFileName, const char* testChoice)
+{
+    return FALSE;
+}
+
+void writeDesignCache()
+{
+}
+
+#endif // _WIN32
@@ -0,0 +1,47 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Compiled Design Cache
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include "Utils.h"
+
+// A compiled design may be kept in a cache file in the cache directory,
+// named by a hash of the project file name, working directory, test choice
+// and the settings a project can change. A later run of the same project,
+// in this or any other process, reads the file back instead of compiling if
+// the simulator build is the same and every source file the compile read
+// is unchanged.
+//
+// Everything a design is built from is allocated in the design heap, which
+// is always reserved at the same address, so the file can hold an image of
+// the heap as is. With it go the global variables that point into the heap
+// or that compiling sets, the source file stamps, and the locations of the
+// words that point into the simulator's own code and data, which are moved
+// by the difference in its load address. A design that points into another
+// library, which may be loaded elsewhere next time, isn't cached.
+
+extern bool     gDesignCache;           // cache designs, from -k or 'cache'
+extern char     gCacheDir[max_nameLen]; // design cache directory
+
+bool readDesignCache(const char* projFileName, const char* testChoice);
+void writeDesignCache();
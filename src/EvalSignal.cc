@@ -24,43 +24,36 @@
 #ifdef EXTENSION
 #include <Python.h>
 #endif
+#include <pthread.h>
+#include <stdlib.h>
 #include "PSignal.h"
+#include "Profile.h"
+#include "NativeCode.h"
 
 //-----------------------------------------------------------------------------
-// Grab a long-sized operand, a signal's offset into the gSignals array, add it
-// to the gSignals base, and return the character there.
+// Grab a long-sized operand, a signal's number, and return that signal's level
+// from the gSigLevel array.
 // Increments the code pointer.
 
 inline int SigOpr(EqnItem* &ic)
 {
-    return *((char* )gSignals + ((ic++)->operand));
+    return gSigLevel[(ic++)->operand];
 }
 
 //-----------------------------------------------------------------------------
-// Evaluate a signal's equation and return the new signal level.
+// Run a signal's equation code and return the new signal level, or -1 if a
+//  bad opcode is found, with ic left pointing to it.
 //  The simulator spends most of its time here, so this function should
 //  be optimized for speed.
 
-Level evalSignalCode(Signal* signal, Signal* sigs, const FuncTable* func)
+inline int runEqnCode(EqnItem* &ic)
 {
-    EqnItem* ic;
+    const FuncTable* func = &funcTable;
     Level   andAcc, orAcc;
     int     opr1, opr2;
 
-#ifdef RANGE_CHECKING
-    if (signal < gSignals || signal >= gNextSignal)
-        throw new VError(verr_bug, "evalSignal: bad signal pointer");
-#endif
-    func = &funcTable;
-    ic = signal->evalCode;
     andAcc = LV_L;
     orAcc = LV_L;
-    if (ic == 0)
-        return warnUnused(signal);
-#ifdef RANGE_CHECKING
-    if (ic < firstCode || ic >= (EqnItem*)gDP)
-        throw new VError(verr_bug, "evalSignal: bad ic pointer");
-#endif
     for (;;)
     {
         // grab the next opcode and dispatch on it
@@ -126,25 +119,187 @@ Level evalSignalCode(Signal* signal, Signal* sigs, const FuncTable* func)
 #endif
             default:
                 ic = (EqnItem*)((size_t)ic - sizeof(short));
-                throw new VError(verr_bug,
-                    "bad opcode 0x%x at %p encountered while evaluating signal",
-                    ic->opcode, ic, signal->name);
+                return -1;
         }
     }
 }
 
+//-----------------------------------------------------------------------------
+// Evaluate a signal's equation and return the new signal level.
+
+Level evalSignalCode(Signal* signal, Signal* sigs, const FuncTable* func)
+{
+    EqnItem* ic;
+
+#ifdef RANGE_CHECKING
+    if (signal < gSignals || signal >= gNextSignal)
+        throw new VError(verr_bug, "evalSignal: bad signal pointer");
+#endif
+    ic = signal->evalCode;
+    if (ic == 0)
+        return warnUnused(signal);
+#ifdef RANGE_CHECKING
+    if (ic < firstCode || ic >= (EqnItem*)gDP)
+        throw new VError(verr_bug, "evalSignal: bad ic pointer");
+#endif
+    size_t sigNo = signal->index();
+    if (gProfile)
+        gSigProfile[sigNo].evals++;
+    int level;
+    if (sigNo < gNSigEqnFuncs && gSigEqnFunc[sigNo])
+        level = (*gSigEqnFunc[sigNo])(ic, gSigLevel, func);
+    else
+        level = runEqnCode(ic);
+    if (level < 0)
+        throw new VError(verr_bug,
+            "bad opcode 0x%x at %p encountered while evaluating signal %s",
+            ic->opcode, ic, signal->name());
+    return (Level)level;
+}
+
 //-----------------------------------------------------------------------------
 
 Level warnUnused(Signal* sig)
 {
 #ifdef SHOW_WARNING
-    if (sig->dependList)
+    if (sig->dependBegin() < sig->dependEnd())
         display("// *** WARNING: signal '%s' declared & used but no source"
-                "defined\n", sig->name);
+                "defined\n", sig->name());
     else
         display("// *** WARNING: remove \"%cSIGNAL %s\"\n",
-            gLevelNames[sig->initLevel], sig->name);
+            gLevelNames[sig->initLevel], sig->name());
 #endif
     gWarningCount++;
     return (LV_C);
 }
+
+// -------- parallel dependents evaluation --------
+
+// When gEvalThreads > 1, the equations of a changed signal's dependents are
+// evaluated by a pool of worker threads before updateDependents() walks them,
+// each thread taking a fixed share of the dependents. Equations only read
+// signal levels, which don't change until the next event is simulated, so
+// each result is the level a serial walk would find, and updateDependents()
+// still posts the new events in dependents order.
+
+int     gEvalThreads = 1;           // threads evaluating dependents, from -j
+const size_t parEvalMinDeps = 256;  // smallest fanout worth splitting up
+
+pthread_mutex_t evalLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t evalStart = PTHREAD_COND_INITIALIZER;    // batch posted
+pthread_cond_t evalDone = PTHREAD_COND_INITIALIZER;     // workers all done
+int     evalNThreads;           // number of shares: workers started + 1
+unsigned long evalBatch;        // number of current batch
+int     evalBusy;               // workers still evaluating current batch
+
+Signal* evalChangedSig;         // current batch's changed signal
+const unsigned* evalDeps;       // its dependents
+size_t  evalNDeps;
+signed char* evalLevels;        // new level of each dependent, or -1
+size_t  evalLevelsLen;          // allocated length of evalLevels
+
+//-----------------------------------------------------------------------------
+// Evaluate one share of the current batch's dependents. Dependents that
+//  aren't evaluated by an equation (C-models, clocked registers, unused
+//  signals), or that fail, are left at -1 for updateDependents to handle.
+
+void evalShare(int share)
+{
+    size_t end = evalNDeps * (share + 1) / evalNThreads;
+    for (size_t i = evalNDeps * share / evalNThreads; i < end; i++)
+    {
+        Signal* dependent = gSignals + evalDeps[i];
+        EqnItem* ic = dependent->evalCode;
+        if (ic && !(dependent->is & C_MODEL) &&
+            !((dependent->is & REGISTERED) && dependent->clock == evalChangedSig))
+        {
+            if (evalDeps[i] < gNSigEqnFuncs && gSigEqnFunc[evalDeps[i]])
+                evalLevels[i] = (*gSigEqnFunc[evalDeps[i]])(ic, gSigLevel,
+                                                           &funcTable);
+            else
+                evalLevels[i] = runEqnCode(ic);
+        }
+        else
+            evalLevels[i] = -1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Worker thread: evaluate a share of each batch as it is posted.
+
+void* evalWorker(void* arg)
+{
+    int share = (int)(size_t)arg;
+    unsigned long batch = 0;
+    for (;;)
+    {
+        pthread_mutex_lock(&evalLock);
+        while (evalBatch == batch)
+            pthread_cond_wait(&evalStart, &evalLock);
+        batch = evalBatch;
+        pthread_mutex_unlock(&evalLock);
+
+        evalShare(share);
+
+        pthread_mutex_lock(&evalLock);
+        if (--evalBusy == 0)
+            pthread_cond_signal(&evalDone);
+        pthread_mutex_unlock(&evalLock);
+    }
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Evaluate the equations of a changed signal's dependents in parallel, if
+//  worthwhile. Returns an array of the new level of each dependent, in
+//  dependents order, with -1 for those not evaluated, or 0 if none were.
+
+signed char* evalDependents(Signal* signal)
+{
+    size_t nDeps = signal->dependEnd() - signal->dependBegin();
+    if (gEvalThreads <= 1 || nDeps < parEvalMinDeps)
+        return 0;
+
+    if (evalNThreads == 0)      // start worker threads on first use
+    {
+        evalNThreads = 1;
+        for (int i = 1; i < gEvalThreads; i++)
+        {
+            pthread_t thread;
+            if (pthread_create(&thread, 0, evalWorker, (void*)(size_t)i) != 0)
+                break;
+            pthread_detach(thread);
+            evalNThreads++;
+        }
+    }
+    if (evalNThreads == 1)
+        return 0;
+    if (nDeps > evalLevelsLen)
+    {
+        free(evalLevels);
+        evalLevelsLen = 2 * nDeps;
+        evalLevels = (signed char*)malloc(evalLevelsLen);
+        if (!evalLevels)
+        {
+            evalLevelsLen = 0;
+            return 0;
+        }
+    }
+
+    evalChangedSig = signal;
+    evalDeps = signal->dependBegin();
+    evalNDeps = nDeps;
+    pthread_mutex_lock(&evalLock);
+    evalBusy = evalNThreads - 1;
+    evalBatch++;
+    pthread_cond_broadcast(&evalStart);
+    pthread_mutex_unlock(&evalLock);
+
+    evalShare(0);
+
+    pthread_mutex_lock(&evalLock);
+    while (evalBusy)
+        pthread_cond_wait(&evalDone, &evalLock);
+    pthread_mutex_unlock(&evalLock);
+    return evalLevels;
+}
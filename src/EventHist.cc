@@ -0,0 +1,399 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Event History Store
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EventHist.h"
+
+// Events that fall out of the simulator's history window are appended here
+// as compact records, in the order they were simulated. The records are kept
+// in fixed-size chunks; once more than histMaxResident chunks are in memory,
+// the oldest full chunk is written out to a temporary spill file and its
+// buffer reused. The records stay in simulation order, so the histories of a
+// range of signals can be read in one forward pass, starting from the oldest
+// record of any of them.
+
+const size_t histChunkRecs = 65536;     // records per chunk
+const int histMaxResident = 16;         // chunks kept in memory
+const size_t histChunkSize = histChunkRecs * sizeof(HistRec);
+
+// -------- global variables --------
+
+#ifdef EXTENSION
+bool    gKeepHistory = TRUE;    // the GUI needs each bus bit's whole history
+#else
+bool    gKeepHistory = FALSE;   // the .events file already has the whole run
+#endif
+
+// -------- local global variables --------
+
+HistRec** histChunks;       // each chunk's records, or 0 if spilled
+HistRec** histChunksEnd;
+HistRec** histChunksLimit;
+Space   histChunkSpace =    // history chunk table space
+{
+    "history chunks",
+    0,
+    &histChunks,
+    sizeof(HistRec* ),
+    &histChunksEnd,
+    &histChunksLimit
+};
+
+size_t* histFirstRec;       // each signal's oldest record number + 1, or 0
+size_t* histFirstRecEnd;
+size_t* histFirstRecLimit;
+Space   histFirstRecSpace = // per-signal oldest record space
+{
+    "history signal start index",
+    0,
+    &histFirstRec,
+    sizeof(size_t),
+    &histFirstRecEnd,
+    &histFirstRecLimit
+};
+
+size_t* histLastRec;        // each signal's newest record number + 1, or 0
+size_t* histLastRecEnd;
+size_t* histLastRecLimit;
+Space   histLastRecSpace =  // per-signal newest record space
+{
+    "history signal index",
+    0,
+    &histLastRec,
+    sizeof(size_t),
+    &histLastRecEnd,
+    &histLastRecLimit
+};
+
+size_t  histNRecs;          // number of records in store
+int     histNResident;      // number of chunks in memory
+size_t  histOldestResident; // chunk number of oldest chunk in memory
+FILE*   histFile;           // spill file, opened on first spill
+HistRec* histReadBuf;       // buffer for a spilled chunk being read back
+size_t  histReadChunk;      // chunk number in histReadBuf + 1, or 0
+
+//-----------------------------------------------------------------------------
+// Release all of the history store.
+
+void histFree()
+{
+    for (HistRec** chunk = histChunks; chunk < histChunksEnd; chunk++)
+        free(*chunk);
+    freeSpace(&histChunkSpace);
+    freeSpace(&histFirstRecSpace);
+    freeSpace(&histLastRecSpace);
+    free(histReadBuf);
+    histReadBuf = 0;
+    if (histFile)
+        fclose(histFile);
+    histFile = 0;
+    histNRecs = 0;
+    histNResident = 0;
+    histOldestResident = 0;
+    histReadChunk = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Start an empty history store for a simulation run.
+
+void histInit(size_t nSignals)
+{
+    histFree();
+    if (!gKeepHistory)
+        return;
+    allocSpace(&histChunkSpace, 64);
+    allocSpace(&histFirstRecSpace, nSignals);
+    memset(histFirstRec, 0, nSignals * sizeof(size_t));
+    allocSpace(&histLastRecSpace, nSignals);
+    memset(histLastRec, 0, nSignals * sizeof(size_t));
+}
+
+//-----------------------------------------------------------------------------
+// Seek to a chunk in the spill file, which may be past 2 GB.
+
+int histSeek(size_t chunk)
+{
+#ifdef _WIN32
+    return _fseeki64(histFile, (__int64)(chunk * histChunkSize), SEEK_SET);
+#else
+    return fseeko(histFile, (off_t)(chunk * histChunkSize), SEEK_SET);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Write the oldest chunk in memory out to the spill file, returning its
+// buffer for reuse.
+
+HistRec* histSpill()
+{
+    if (!histFile)
+    {
+        histFile = tmpfile();
+        if (!histFile)
+            throw new VError(verr_io, "can't create event history spill file");
+    }
+    size_t n = histOldestResident++;
+    HistRec* recs = histChunks[n];
+    if (histSeek(n) != 0 ||
+        fwrite(recs, histChunkSize, 1, histFile) != 1)
+        throw new VError(verr_io, "can't write event history spill file");
+    histChunks[n] = 0;
+    return recs;
+}
+
+//-----------------------------------------------------------------------------
+// Append a new record to the store, starting a new chunk if needed.
+
+HistRec* histNewRec()
+{
+    size_t i = histNRecs % histChunkRecs;
+    if (i == 0)
+    {
+        long nChunks = histChunksEnd - histChunks;
+        if (histChunksEnd >= histChunksLimit)
+            reAllocSpace(&histChunkSpace, nChunks * 2);
+        HistRec* recs;
+        if (histNResident >= histMaxResident)
+            recs = histSpill();
+        else
+        {
+            recs = (HistRec*)malloc(histChunkSize);
+            if (!recs)
+                throw new VError(verr_memOverflow,
+                                 "out of memory for event history");
+            histNResident++;
+        }
+        *histChunksEnd++ = recs;
+    }
+    histNRecs++;
+    return histChunksEnd[-1] + i;
+}
+
+//-----------------------------------------------------------------------------
+// Return a pointer to record number n, reading its chunk back from the spill
+// file if necessary. The pointer is only good until the next call.
+
+const HistRec* histRec(size_t n)
+{
+    size_t chunk = n / histChunkRecs;
+    HistRec* recs = histChunks[chunk];
+    if (!recs)
+    {
+        if (histReadChunk != chunk + 1)
+        {
+            if (!histReadBuf)
+            {
+                histReadBuf = (HistRec*)malloc(histChunkSize);
+                if (!histReadBuf)
+                    throw new VError(verr_memOverflow,
+                                     "out of memory for event history");
+            }
+            if (histSeek(chunk) != 0 ||
+                fread(histReadBuf, histChunkSize, 1, histFile) != 1)
+                throw new VError(verr_io,
+                                 "can't read event history spill file");
+            histReadChunk = chunk + 1;
+        }
+        recs = histReadBuf;
+    }
+    return recs + n % histChunkRecs;
+}
+
+//-----------------------------------------------------------------------------
+// Copy an event into the history store, before it is freed.
+
+void histAddEvent(Event* event)
+{
+    size_t sigIndex = event->signal - gSignals;
+    HistRec* rec = histNewRec();
+    rec->ev.tick = event->tick;
+    rec->ev.signal = sigIndex;
+    rec->ev.level = event->level;
+    rec->ev.is = event->is;
+    if (!histFirstRec[sigIndex])
+        histFirstRec[sigIndex] = histNRecs;
+    histLastRec[sigIndex] = histNRecs;
+    if (event->is & ATTACHED_TEXT)
+    {
+        rec = histNewRec();
+        memset(rec, 0, sizeof(HistRec));
+        memcpy(rec->text, event->attText(), MAX_ATT_TEXT_LEN);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Start reading the histories of signals firstSig up to endSig, with each
+// at its oldest event.
+
+void HistScan::start(Signal* firstSig, Signal* endSig)
+{
+    first = firstSig;
+    nSignals = endSig - firstSig;
+    cursors = (HistCursor*)malloc(nSignals * sizeof(HistCursor));
+    if (!cursors)
+        throw new VError(verr_memOverflow, "out of memory for event history");
+    freeItems = 0;
+    aheadTick = tick_forever;
+    n = histNRecs;
+    nEnd = 0;
+    for (size_t i = 0; i < nSignals; i++)
+    {
+        HistCursor* cursor = &cursors[i];
+        cursor->items = 0;
+        cursor->itemsEnd = &cursor->items;
+        cursor->lastRec = 0;
+        cursor->event = first[i].firstDispEvt;
+        if (histNRecs == 0)
+            continue;
+        size_t sigIndex = first + i - gSignals;
+        if (histFirstRec[sigIndex] && histFirstRec[sigIndex] - 1 < n)
+            n = histFirstRec[sigIndex] - 1;
+        cursor->lastRec = histLastRec[sigIndex];
+        if (cursor->lastRec > nEnd)
+            nEnd = cursor->lastRec;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Read ahead each stored record due by the given tick, queueing it on its
+// signal's cursor. Attached-text records are taken as they come, as they
+// don't count as events that set a time. Leaves aheadTick at the tick of
+// the next record left unread, which no unread record precedes.
+
+void HistScan::readTo(Tick tick)
+{
+    size_t firstIndex = first - gSignals;
+    for ( ; n < nEnd; n++)
+    {
+        const HistRec* rec = histRec(n);
+        size_t i = rec->ev.signal - firstIndex;
+        bool hasText = ((rec->ev.is & ATTACHED_TEXT) != 0);
+        if (i < nSignals)
+        {
+            if (!hasText && rec->ev.tick > tick)
+            {
+                aheadTick = rec->ev.tick;
+                return;
+            }
+            HistItem* item = freeItems;
+            if (item)
+                freeItems = item->next;
+            else
+            {
+                item = (HistItem*)malloc(sizeof(HistItem));
+                if (!item)
+                    throw new VError(verr_memOverflow,
+                                     "out of memory for event history");
+            }
+            item->next = 0;
+            item->rec = *rec;
+            if (hasText)
+                item->text = *histRec(n + 1);
+            *cursors[i].itemsEnd = item;
+            cursors[i].itemsEnd = &item->next;
+        }
+        if (hasText)
+            n++;
+    }
+    aheadTick = tick_forever;
+}
+
+//-----------------------------------------------------------------------------
+// Find a signal's next event that isn't attached text, returning FALSE if
+// there is none or it hasn't been read yet (it is at aheadTick or later).
+
+bool HistScan::peekLevel(Signal* signal, Tick* tick, Level* level)
+{
+    HistCursor* c = cursor(signal);
+    for (HistItem* item = c->items; item; item = item->next)
+        if (!(item->rec.ev.is & ATTACHED_TEXT))
+        {
+            *tick = item->rec.ev.tick;
+            *level = item->rec.ev.level;
+            return TRUE;
+        }
+    if (c->lastRec > n)
+        return FALSE;
+    for (Event* event = c->event; event; event = event->nextInSignal)
+        if (!(event->is & ATTACHED_TEXT))
+        {
+            *tick = event->tick;
+            *level = event->level;
+            return TRUE;
+        }
+    return FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if a signal's current event is known and at or before tick.
+
+bool HistScan::due(Signal* signal, Tick tick)
+{
+    HistCursor* c = cursor(signal);
+    if (!c->items && (c->lastRec > n || !c->event))
+        return FALSE;
+    return (c->tick() <= tick);
+}
+
+//-----------------------------------------------------------------------------
+// Move a signal's cursor past its current event.
+
+void HistScan::next(Signal* signal)
+{
+    HistCursor* c = cursor(signal);
+    HistItem* item = c->items;
+    if (item)
+    {
+        c->items = item->next;
+        if (!c->items)
+            c->itemsEnd = &c->items;
+        item->next = freeItems;
+        freeItems = item;
+    }
+    else
+        c->event = c->event->nextInSignal;
+}
+
+//-----------------------------------------------------------------------------
+// Done reading.
+
+void HistScan::finish()
+{
+    for (size_t i = 0; i < nSignals; i++)
+        while (cursors[i].items)
+            next(first + i);
+    while (freeItems)
+    {
+        HistItem* item = freeItems;
+        freeItems = item->next;
+        free(item);
+    }
+    free(cursors);
+    cursors = 0;
+}
@@ -0,0 +1,103 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Event History Store
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include "Utils.h"
+#include "PSignal.h"
+
+// A compact copy of an event that has been evicted from the event pool into
+// the history store. An attached-text event's text follows it in a second
+// record.
+
+union HistRec
+{
+    struct
+    {
+        Tick    tick;           // event time
+        unsigned signal;        // index of event's signal in gSignals
+        Level   level:8;        // signal's new level
+        char    is;             // event flags
+    } ev;
+    char    text[MAX_ATT_TEXT_LEN]; // attached text of preceding record
+};
+
+// A stored record read ahead for one signal, with its attached text, if any.
+
+struct HistItem
+{
+    HistItem*   next;       // signal's next item read ahead, or 0
+    HistRec     rec;
+    HistRec     text;
+};
+
+// One signal's position in a HistScan: its stored records that have been
+// read ahead, then its events still in the event pool. The accessors give
+// its current event, once known.
+
+struct HistCursor
+{
+    HistItem*   items;      // stored records read ahead, oldest first
+    HistItem**  itemsEnd;   // where to link the next item read
+    size_t      lastRec;    // signal's newest stored record number + 1
+    Event*      event;      // current pool event, once past stored records
+
+    Tick        tick()      { return (items ? items->rec.ev.tick :
+                                              event->tick); }
+    Level       level()     { return (items ? items->rec.ev.level :
+                                              event->level); }
+    char        is()        { return (items ? items->rec.ev.is :
+                                              event->is); }
+    const char* text()      { return (items ? items->text.text :
+                                              event->attText()); }
+};
+
+// A reader for the whole displayed histories of a range of signals, such as
+// a bus's bits, in chronological order. The store is read in one forward
+// pass, and each stored record is only held from when it comes due until
+// its signal's cursor moves past it, so resident memory stays bounded.
+
+struct HistScan
+{
+    Signal*     first;      // first signal read
+    size_t      nSignals;   // number of signals read
+    HistCursor* cursors;    // each signal's cursor
+    size_t      n;          // number of next stored record to read
+    size_t      nEnd;       // newest stored record of any signal + 1
+    Tick        aheadTick;  // tick of next unread record, or tick_forever
+    HistItem*   freeItems;  // passed items, for reuse
+
+    void        start(Signal* firstSig, Signal* endSig);
+    void        finish();
+    void        readTo(Tick tick);
+    bool        peekLevel(Signal* signal, Tick* tick, Level* level);
+    bool        due(Signal* signal, Tick tick);
+    void        next(Signal* signal);
+    HistCursor* cursor(Signal* signal) { return &cursors[signal - first]; }
+};
+
+extern bool     gKeepHistory;   // evict old events to store instead of freeing
+
+void histInit(size_t nSignals);
+void histAddEvent(Event* event);
+void histFree();
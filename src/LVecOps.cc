@@ -0,0 +1,309 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Level Vector Kernels
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stddef.h>
+#include "LVecOps.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LVEC_X86
+#include <immintrin.h>
+#define TARGET(isa) __attribute__((target(isa)))
+#endif
+
+//-----------------------------------------------------------------------------
+//                          Scalar Kernels
+//-----------------------------------------------------------------------------
+
+static void unaryOpScalar(const Level* src, Level* dest, size_t nBits,
+                          const Level* table)
+{
+    for ( ; nBits > 0; nBits--)
+        *dest++ = table[*src++];
+}
+
+static void binaryOpScalar(const Level* src0, const Level* src1, Level* dest,
+                           size_t nBits, const Level table[12][16])
+{
+    for ( ; nBits > 0; nBits--)
+        *dest++ = table[*src0++][*src1++];
+}
+
+static bool countHighScalar(const Level* levVec, size_t nBits, size_t* nHigh)
+{
+    size_t n = 0;
+    for ( ; nBits > 0; nBits--)
+    {
+        Level level = *levVec++;
+        if (level == LV_H)
+            n++;
+        else if (level != LV_L)
+            return FALSE;
+    }
+    *nHigh = n;
+    return TRUE;
+}
+
+static void fromIntScalar(size_t value, Level* levVec, size_t nBits)
+{
+    levVec += nBits;
+    for ( ; nBits > 0; nBits--)
+    {
+        levVec--;
+        *levVec = ((value & 1) ? LV_H : LV_L);
+        value >>= 1;
+    }
+}
+
+static size_t toIntScalar(const Level* levVec, size_t nBits)
+{
+    size_t value = 0;
+    for ( ; nBits > 0; nBits--)
+        value = (value << 1) + (*levVec++ == LV_H);
+    return value;
+}
+
+static const LVecOps lvecScalar =
+{
+    "scalar",
+    unaryOpScalar,
+    binaryOpScalar,
+    countHighScalar,
+    fromIntScalar,
+    toIntScalar
+};
+
+#ifdef LVEC_X86
+
+//-----------------------------------------------------------------------------
+//                          SSSE3 Kernels, 16 bits at a time
+//-----------------------------------------------------------------------------
+
+TARGET("ssse3")
+static void unaryOpSSSE3(const Level* src, Level* dest, size_t nBits,
+                         const Level* table)
+{
+    __m128i tbl = _mm_loadu_si128((const __m128i*)table);
+    for ( ; nBits >= 16; nBits -= 16, src += 16, dest += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)src);
+        _mm_storeu_si128((__m128i*)dest, _mm_shuffle_epi8(tbl, x));
+    }
+    unaryOpScalar(src, dest, nBits, table);
+}
+
+TARGET("ssse3,popcnt")
+static bool countHighSSSE3(const Level* levVec, size_t nBits, size_t* nHigh)
+{
+    size_t n = 0;
+    __m128i low = _mm_set1_epi8(LV_L);
+    __m128i high = _mm_set1_epi8(LV_H);
+    for ( ; nBits >= 16; nBits -= 16, levVec += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)levVec);
+        __m128i isH = _mm_cmpeq_epi8(x, high);
+        __m128i known = _mm_or_si128(isH, _mm_cmpeq_epi8(x, low));
+        if (_mm_movemask_epi8(known) != 0xffff)
+            return FALSE;
+        n += _mm_popcnt_u32(_mm_movemask_epi8(isH));
+    }
+    size_t nTail;
+    if (!countHighScalar(levVec, nBits, &nTail))
+        return FALSE;
+    *nHigh = n + nTail;
+    return TRUE;
+}
+
+// Each 16 bits of the value, from the LSB, fill 16 Levels from the end.
+
+TARGET("ssse3")
+static void fromIntSSSE3(size_t value, Level* levVec, size_t nBits)
+{
+    const __m128i byteSel = _mm_setr_epi8(1, 1, 1, 1, 1, 1, 1, 1,
+                                          0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i bitSel = _mm_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1,
+                                         -128, 64, 32, 16, 8, 4, 2, 1);
+    const __m128i high = _mm_set1_epi8(LV_H);
+    Level* p = levVec + nBits;
+    for ( ; nBits >= 16; nBits -= 16)
+    {
+        p -= 16;
+        __m128i bits = _mm_set1_epi16((short)(value & 0xffff));
+        bits = _mm_and_si128(_mm_shuffle_epi8(bits, byteSel), bitSel);
+        bits = _mm_and_si128(_mm_cmpeq_epi8(bits, bitSel), high);
+        _mm_storeu_si128((__m128i*)p, bits);
+        value >>= 16;
+    }
+    fromIntScalar(value, levVec, nBits);
+}
+
+// Each 16 Levels are reversed, so that the movemask puts the MSB first.
+
+TARGET("ssse3")
+static size_t toIntSSSE3(const Level* levVec, size_t nBits)
+{
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0);
+    const __m128i high = _mm_set1_epi8(LV_H);
+    size_t lead = nBits % 16;
+    size_t value = toIntScalar(levVec, lead);
+    levVec += lead;
+    for (nBits -= lead; nBits > 0; nBits -= 16, levVec += 16)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)levVec);
+        x = _mm_cmpeq_epi8(_mm_shuffle_epi8(x, reverse), high);
+        value = (value << 16) | (unsigned)_mm_movemask_epi8(x);
+    }
+    return value;
+}
+
+// A 16-byte binary lookup takes 12 row shuffles and selects, which is no
+// faster than the scalar lookups, so this set keeps the scalar binaryOp.
+
+static const LVecOps lvecSSSE3 =
+{
+    "ssse3",
+    unaryOpSSSE3,
+    binaryOpScalar,
+    countHighSSSE3,
+    fromIntSSSE3,
+    toIntSSSE3
+};
+
+//-----------------------------------------------------------------------------
+//                          AVX2 Kernels, 32 bits at a time
+//-----------------------------------------------------------------------------
+
+TARGET("avx2")
+static void unaryOpAVX2(const Level* src, Level* dest, size_t nBits,
+                        const Level* table)
+{
+    __m256i tbl = _mm256_broadcastsi128_si256(
+                                _mm_loadu_si128((const __m128i*)table));
+    for ( ; nBits >= 32; nBits -= 32, src += 32, dest += 32)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i*)src);
+        _mm256_storeu_si256((__m256i*)dest, _mm256_shuffle_epi8(tbl, x));
+    }
+    unaryOpSSSE3(src, dest, nBits, table);
+}
+
+// Each row of the table is looked up by src1, and the row selected by src0
+// is kept.
+
+TARGET("avx2")
+static void binaryOpAVX2(const Level* src0, const Level* src1, Level* dest,
+                         size_t nBits, const Level table[12][16])
+{
+    for ( ; nBits >= 32; nBits -= 32, src0 += 32, src1 += 32, dest += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)src0);
+        __m256i b = _mm256_loadu_si256((const __m256i*)src1);
+        __m256i r = _mm256_setzero_si256();
+        for (int row = 0; row < 12; row++)
+        {
+            __m256i tbl = _mm256_broadcastsi128_si256(
+                                _mm_loadu_si128((const __m128i*)table[row]));
+            __m256i sel = _mm256_cmpeq_epi8(a, _mm256_set1_epi8(row));
+            r = _mm256_or_si256(r, _mm256_and_si256(sel,
+                                            _mm256_shuffle_epi8(tbl, b)));
+        }
+        _mm256_storeu_si256((__m256i*)dest, r);
+    }
+    binaryOpScalar(src0, src1, dest, nBits, table);
+}
+
+TARGET("avx2,popcnt")
+static bool countHighAVX2(const Level* levVec, size_t nBits, size_t* nHigh)
+{
+    size_t n = 0;
+    __m256i low = _mm256_set1_epi8(LV_L);
+    __m256i high = _mm256_set1_epi8(LV_H);
+    for ( ; nBits >= 32; nBits -= 32, levVec += 32)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i*)levVec);
+        __m256i isH = _mm256_cmpeq_epi8(x, high);
+        __m256i known = _mm256_or_si256(isH, _mm256_cmpeq_epi8(x, low));
+        if (_mm256_movemask_epi8(known) != -1)
+            return FALSE;
+        n += _mm_popcnt_u32(_mm256_movemask_epi8(isH));
+    }
+    size_t nTail;
+    if (!countHighSSSE3(levVec, nBits, &nTail))
+        return FALSE;
+    *nHigh = n + nTail;
+    return TRUE;
+}
+
+// Integer conversions cover at most 64 bits, so they stay 16 at a time.
+
+static const LVecOps lvecAVX2 =
+{
+    "avx2",
+    unaryOpAVX2,
+    binaryOpAVX2,
+    countHighAVX2,
+    fromIntSSSE3,
+    toIntSSSE3
+};
+
+#endif // LVEC_X86
+
+// -------- global variables --------
+
+const LVecOps* gLVecOps = &lvecScalar;  // kernels in use
+
+//-----------------------------------------------------------------------------
+// Return a 0-terminated list of the kernel sets this CPU can run, from the
+// scalar set up to the widest.
+
+const LVecOps* const* lvecOpsSets()
+{
+    static const LVecOps* sets[4];
+    int n = 0;
+    sets[n++] = &lvecScalar;
+#ifdef LVEC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("popcnt"))
+    {
+        sets[n++] = &lvecSSSE3;
+        if (__builtin_cpu_supports("avx2"))
+            sets[n++] = &lvecAVX2;
+    }
+#endif
+    sets[n] = 0;
+    return sets;
+}
+
+//-----------------------------------------------------------------------------
+// Use the widest kernels this CPU can run.
+
+void selectLVecOps()
+{
+    const LVecOps* const* sets = lvecOpsSets();
+    while (sets[1])
+        sets++;
+    gLVecOps = *sets;
+}
@@ -0,0 +1,55 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Level Vector Kernels
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include "PSignal.h"
+
+// The bus operations in VLSysLib.cc work on LVectors, one Level byte per bit,
+// through Level lookup tables. Each table row holds 16 entries, so on x86 a
+// byte shuffle (SSSE3 pshufb, AVX2 vpshufb) looks up 16 or 32 bits at once.
+// A set of kernels is chosen for the CPU when the compiler starts; the
+// scalar set, which runs anywhere, is used until then.
+
+struct LVecOps
+{
+    const char* name;           // instruction set name
+
+    // dest[i] = table[src[i]], where table has 16 entries
+    void    (*unaryOp)(const Level* src, Level* dest, size_t nBits,
+                       const Level* table);
+    // dest[i] = table[src0[i]][src1[i]]
+    void    (*binaryOp)(const Level* src0, const Level* src1, Level* dest,
+                        size_t nBits, const Level table[12][16]);
+    // If every bit is LV_L or LV_H, set *nHigh to the number of LV_H bits
+    // and return TRUE, else return FALSE.
+    bool    (*countHigh)(const Level* levVec, size_t nBits, size_t* nHigh);
+    // Convert an integer to an LVector, MSB first, and back.
+    void    (*fromInt)(size_t value, Level* levVec, size_t nBits);
+    size_t  (*toInt)(const Level* levVec, size_t nBits);
+};
+
+extern const LVecOps* gLVecOps; // kernels in use
+
+const LVecOps* const* lvecOpsSets(); // all sets this CPU runs, scalar first
+void selectLVecOps();
@@ -0,0 +1,213 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Paged Memory Store
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "MemPages.h"
+#include "Checkpoint.h"
+
+const int memPageBytesLog2 = 12;        // 4K-byte pages
+const size_t memPageBytes = (size_t)1 << memPageBytesLog2;
+
+// -------- local global variables --------
+
+MemPages* gMemPagesList;        // list of all paged memories
+
+//-----------------------------------------------------------------------------
+// Store an element into a page, at its packed width.
+
+static inline void putElem(MemPages* mem, char* page, size_t j, size_t value)
+{
+    switch (mem->elemShift)
+    {
+        case 0:  ((unsigned char*)page)[j] = (unsigned char)value;   break;
+        case 1:  ((unsigned short*)page)[j] = (unsigned short)value; break;
+        case 2:  ((unsigned int*)page)[j] = (unsigned int)value;     break;
+        default: ((size_t*)page)[j] = value;                          break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Allocate a page, filled with the fill value.
+
+static char* newPage(MemPages* mem)
+{
+    char* page = (char*)heapAlloc(memPageBytes);
+    if (!page)
+        throw new VError(verr_memOverflow, "no memory for memory page");
+    for (size_t j = 0; j <= mem->pageMask; j++)
+        putElem(mem, page, j, mem->fill);
+    return page;
+}
+
+//-----------------------------------------------------------------------------
+// Create the paged store for a memory of nElems elements, each elemBits
+//  wide, with every element reading as the fill value, 0.
+
+MemPages* newMemPages(size_t nElems, int elemBits)
+{
+    MemPages* mem = (MemPages*)heapCalloc(1, sizeof(MemPages));
+    if (!mem)
+        throw new VError(verr_memOverflow, "no memory for memory pages");
+    mem->nElems = nElems;
+    mem->elemShift = (elemBits <= 8 ? 0 : elemBits <= 16 ? 1 :
+                      elemBits <= 32 ? 2 : 3);
+    mem->pageShift = memPageBytesLog2 - mem->elemShift;
+    mem->pageMask = ((size_t)1 << mem->pageShift) - 1;
+    mem->fill = 0;
+    mem->fillPage = newPage(mem);
+    mem->nPages = (nElems + mem->pageMask) >> mem->pageShift;
+    mem->pages = (char**)heapAlloc(mem->nPages * sizeof(char*));
+    if (!mem->pages)
+        throw new VError(verr_memOverflow, "no memory for memory page table");
+    for (size_t p = 0; p < mem->nPages; p++)
+        mem->pages[p] = mem->fillPage;
+    mem->next = gMemPagesList;
+    gMemPagesList = mem;
+    // so that the pointer to it in the memory's local var is relocated
+    ckptAddRegion(mem, sizeof(MemPages), FALSE);
+    return mem;
+}
+
+//-----------------------------------------------------------------------------
+// Return element i of a paged memory, or the fill value if it's out of range.
+
+size_t loadMemPage(size_t i, MemPages* mem)
+{
+    if (i >= mem->nElems)
+        return mem->fill;
+    char* page = mem->pages[i >> mem->pageShift];
+    size_t j = i & mem->pageMask;
+    switch (mem->elemShift)
+    {
+        case 0:  return ((unsigned char*)page)[j];
+        case 1:  return ((unsigned short*)page)[j];
+        case 2:  return ((unsigned int*)page)[j];
+        default: return ((size_t*)page)[j];
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Set element i of a paged memory, giving its page storage of its own the
+//  first time. A write out of range is ignored.
+
+void stoMemPage(size_t i, size_t value, MemPages* mem)
+{
+    if (i >= mem->nElems)
+        return;
+    char** pagep = &mem->pages[i >> mem->pageShift];
+    if (*pagep == mem->fillPage)
+        *pagep = newPage(mem);
+    putElem(mem, *pagep, i & mem->pageMask, value);
+}
+
+//-----------------------------------------------------------------------------
+// Free a paged memory's written pages, leaving it all fill.
+
+static void clearPages(MemPages* mem)
+{
+    for (size_t p = 0; p < mem->nPages; p++)
+        if (mem->pages[p] != mem->fillPage)
+        {
+            heapFree(mem->pages[p]);
+            mem->pages[p] = mem->fillPage;
+        }
+}
+
+//-----------------------------------------------------------------------------
+// Empty all paged memories, for another run of the same design.
+
+void clearAllMemPages()
+{
+    for (MemPages* mem = gMemPagesList; mem; mem = mem->next)
+        clearPages(mem);
+}
+
+//-----------------------------------------------------------------------------
+// Free all paged memories, for a new simulation.
+
+void freeAllMemPages()
+{
+    while (gMemPagesList)
+    {
+        MemPages* mem = gMemPagesList;
+        gMemPagesList = mem->next;
+        clearPages(mem);
+        heapFree(mem->pages);
+        heapFree(mem->fillPage);
+        heapFree(mem);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Write each paged memory's written pages to a checkpoint file, as a count
+//  followed by each page's number and contents.
+
+void checkpointMemPages(FILE* f)
+{
+    for (MemPages* mem = gMemPagesList; mem; mem = mem->next)
+    {
+        size_t nWritten = 0;
+        size_t p;
+        for (p = 0; p < mem->nPages; p++)
+            nWritten += (mem->pages[p] != mem->fillPage);
+        ckptWrite(f, &nWritten, sizeof(nWritten));
+        for (p = 0; p < mem->nPages; p++)
+            if (mem->pages[p] != mem->fillPage)
+            {
+                ckptWrite(f, &p, sizeof(p));
+                ckptWrite(f, mem->pages[p], memPageBytes);
+            }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Restore each paged memory's written pages from a checkpoint file.
+
+void restoreMemPages(FILE* f)
+{
+    for (MemPages* mem = gMemPagesList; mem; mem = mem->next)
+    {
+        clearPages(mem);
+        size_t nWritten;
+        ckptRead(f, &nWritten, sizeof(nWritten));
+        for ( ; nWritten; nWritten--)
+        {
+            size_t p;
+            ckptRead(f, &p, sizeof(p));
+            if (p >= mem->nPages)
+                throw new VError(verr_illegal, "bad memory page in checkpoint");
+            char* page = (char*)heapAlloc(memPageBytes);
+            if (!page)
+                throw new VError(verr_memOverflow,
+                                 "no memory to read checkpoint");
+            ckptRead(f, page, memPageBytes);
+            mem->pages[p] = page;
+        }
+    }
+}
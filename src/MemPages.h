@@ -0,0 +1,55 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Paged Memory Store
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include <stdio.h>
+#include "Utils.h"
+
+// A Memory too large to keep in its module's instance storage (see
+// max_denseMemElems in VL.h) is kept here, in pages allocated as they are
+// first written. Each element is packed into the smallest of 1, 2, 4 or 8
+// bytes that holds its width. Every page table entry starts out pointing to
+// a shared page of the fill value, which is never written, so a read is two
+// indexed loads and only a write has to check for an unwritten page.
+
+struct MemPages
+{
+    size_t      nElems;         // number of elements
+    int         elemShift;      // log2 of bytes per element
+    int         pageShift;      // log2 of elements per page
+    size_t      pageMask;       // element index mask within a page
+    size_t      fill;           // value read from an unwritten element
+    char*       fillPage;       // shared page of fill values
+    char**      pages;          // page table: a page, or fillPage
+    size_t      nPages;
+    MemPages*   next;           // next in list of all paged memories
+};
+
+MemPages* newMemPages(size_t nElems, int elemBits);
+size_t loadMemPage(size_t i, MemPages* mem);
+void stoMemPage(size_t i, size_t value, MemPages* mem);
+void clearAllMemPages();
+void freeAllMemPages();
+void checkpointMemPages(FILE* f);
+void restoreMemPages(FILE* f);
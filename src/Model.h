@@ -67,7 +67,7 @@ private:
     Tick            timeoutTime;    // if >0, tick at which to time out at
     Signal*         timeoutSignal;  // signal to report timeout on
     const char*     timeoutMsg;     // timeout error message
-    long            timeoutDuration; // duration to report upon error
+    Tick            timeoutDuration; // duration to report upon error
 
 public:
     void            eval(Signal* eventSig);
@@ -79,6 +79,8 @@ public:
     static void     removeAll();
     static void     initVars();
     static void     initModels();       // create a thread pool and all models
+    static void     checkpointAll(FILE* f); // save all models' thread state
+    static void     restoreAll(FILE* f);
     void            addEventV(Tick dt, Signal* signal, Level level,
                               char eventType);
     void            addMinMaxEventV(Tick dtMin, Tick dtMax, Signal* signal,
@@ -92,7 +94,7 @@ public:
     void            postIndMinMaxVectorV(SignalVec* sigVec, int i, int iMax,
                         Tick dtMin, Tick dtMax, Level* levVec, int nBits);
     void            wait();                 // wait for input event
-    void            delay(int t);           // delay t ticks-- use ns(n) for ns
+    void            delay(Tick t);          // delay t ticks-- use ns(n) for ns
     static void     test();
     virtual void*   startV(Model* realTask);
 protected:
@@ -130,8 +132,10 @@ private:
 };
 
 inline Level level(bool x) { return (x ? LV_H : LV_L); }
-inline bool high(Signal* w) { return (w->level == LV_H) || (w->level == LV_W); }
-inline bool low(Signal* w) { return (w->level == LV_L) || (w->level == LV_V); }
+inline bool high(Signal* w)
+                { return (w->level() == LV_H) || (w->level() == LV_W); }
+inline bool low(Signal* w)
+                { return (w->level() == LV_L) || (w->level() == LV_V); }
 inline Level inv(Signal* w) { return (low(w) ? LV_H : LV_L); }
 
 void setDependency(Signal* dependent, Signal* signal);
@@ -38,6 +38,9 @@
 #include "PCode.h"
 #include "VL.h"
 #include "Model.h"
+#include "Checkpoint.h"
+#include "Profile.h"
+#include "NativeCode.h"
 
 #if _MSC_VER
 #define time_t __time64_t
@@ -59,6 +62,7 @@ struct ThreadContext
     size_t* stack;          // thread private stack
     size_t  arg[10];        // subroutine arguments
     Tick    wakeTime;       // sleep wake tick
+    void*   natSubr;        // native subroutine last run, a lookup hint
 
     // OLD
     ThreadEntryPtr  threadEntry;    // thread start address
@@ -83,6 +87,7 @@ Model::Model(const char* name, EvHandCodePtr evHandCode, char* instModule)
     ThreadContext* ctxt = new ThreadContext;
     this->ctxt = ctxt;
     ctxt->threadEntry = 0;
+    ctxt->natSubr = 0;
 
     // create the new stack
     ctxt->stack = new size_t[size_ThreadStack];
@@ -90,6 +95,8 @@ Model::Model(const char* name, EvHandCodePtr evHandCode, char* instModule)
     if (!ctxt->stack)
         throw new VError(verr_memOverflow, "can't allocate a model's stack");
     this->isTask = FALSE;
+    ckptAddRegion(this, sizeof(Model), FALSE);
+    ckptAddRegion(ctxt->stack, size_ThreadStack * sizeof(size_t), FALSE);
 }
 
 //-----------------------------------------------------------------------------
@@ -166,7 +173,7 @@ void Model::init()
     if (this->isTask)
     {
         if (debugLevel(3))
-            printf("@%2.3f model %s init\n", (float)gTick/gTicksNS,
+            printf("@%2.3f model %s init\n", (double)gTick/gTicksNS,
                    this->desig);
 
         ctxt->pc = (PCode*)ctxt->threadEntry;
@@ -206,6 +213,94 @@ void Model::removeAll()
     gModelsList = 0;
 }
 
+//-----------------------------------------------------------------------------
+// A model's thread state in a checkpoint, followed by its used stack words.
+
+struct ModelCkpt
+{
+    size_t  pc;
+    size_t  depth;          // number of words on stack
+    size_t  tos;
+    size_t  inst;
+    size_t  arg[10];
+    Tick    wakeTime;
+    Tick    timeoutTime;
+    Tick    timeoutDuration;
+    size_t  timeoutMsg;
+    unsigned triggerSignal; // signal number + 1, or 0
+    unsigned timeoutSignal; // signal number + 1, or 0
+    bool    isSleeping;
+    bool    isWaiting;
+    bool    timeoutsMode;
+};
+
+//-----------------------------------------------------------------------------
+// Save each model's thread state to a checkpoint file.
+
+void Model::checkpointAll(FILE* f)
+{
+    for (Model* m = gModelsList; m; m = m->next)
+    {
+        ThreadContext* ctxt = m->ctxt;
+        ModelCkpt mc;
+        memset(&mc, 0, sizeof(mc));
+        mc.pc = (size_t)ctxt->pc;
+        mc.depth = ctxt->stack + size_ThreadStack - ctxt->sp;
+        mc.tos = ctxt->tos;
+        mc.inst = (size_t)ctxt->inst;
+        memcpy(mc.arg, ctxt->arg, sizeof(mc.arg));
+        mc.wakeTime = ctxt->wakeTime;
+        mc.timeoutTime = m->timeoutTime;
+        mc.timeoutDuration = m->timeoutDuration;
+        mc.timeoutMsg = (size_t)m->timeoutMsg;
+        mc.triggerSignal = m->triggerSignal ?
+                                m->triggerSignal->index() + 1 : 0;
+        mc.timeoutSignal = m->timeoutSignal ?
+                                m->timeoutSignal->index() + 1 : 0;
+        mc.isSleeping = m->isSleeping;
+        mc.isWaiting = m->isWaiting;
+        mc.timeoutsMode = m->timeoutsMode;
+        ckptWrite(f, &mc, sizeof(mc));
+        ckptWrite(f, ctxt->sp, mc.depth * sizeof(size_t));
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Restore each model's thread state from a checkpoint file, relocating any
+//  saved pointers.
+
+void Model::restoreAll(FILE* f)
+{
+    for (Model* m = gModelsList; m; m = m->next)
+    {
+        ThreadContext* ctxt = m->ctxt;
+        ModelCkpt mc;
+        ckptRead(f, &mc, sizeof(mc));
+        if (mc.depth > (size_t)size_ThreadStack)
+            throw new VError(verr_illegal, "bad model stack in checkpoint");
+        ctxt->pc = (PCode*)ckptRelocate(mc.pc);
+        ctxt->sp = ctxt->stack + size_ThreadStack - mc.depth;
+        ctxt->tos = ckptRelocate(mc.tos);
+        ctxt->inst = (char*)ckptRelocate(mc.inst);
+        for (int i = 0; i < 10; i++)
+            ctxt->arg[i] = ckptRelocate(mc.arg[i]);
+        ctxt->wakeTime = mc.wakeTime;
+        m->timeoutTime = mc.timeoutTime;
+        m->timeoutDuration = mc.timeoutDuration;
+        m->timeoutMsg = (const char*)ckptRelocate(mc.timeoutMsg);
+        m->triggerSignal = mc.triggerSignal ?
+                                gSignals + mc.triggerSignal - 1 : 0;
+        m->timeoutSignal = mc.timeoutSignal ?
+                                gSignals + mc.timeoutSignal - 1 : 0;
+        m->isSleeping = mc.isSleeping;
+        m->isWaiting = mc.isWaiting;
+        m->timeoutsMode = mc.timeoutsMode;
+        ckptRead(f, ctxt->sp, mc.depth * sizeof(size_t));
+        for (size_t* p = ctxt->sp; p < ctxt->stack + size_ThreadStack; p++)
+            *p = ckptRelocate(*p);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // Print current data stack contents for debugging.
 
@@ -225,9 +320,63 @@ void dumpDataStack(ThreadContext* ctxt, size_t* sp, size_t tos)
 
 //-----------------------------------------------------------------------------
 //  Continue executing model's PCode.
+//
+//  Each op is dispatched directly to its handler through a computed goto on
+//  its label in opLabels[], and each handler ends by dispatching the next op,
+//  so the fast path has no switch bounds check and no per-op debug tests.
+//  When tracing (debug level 3) or profiling, every entry of the dispatch
+//  table instead leads to the slow path at traceOp or countOp, which logs or
+//  counts the op before jumping on to its handler.
+
+// Handler labels: a dual op's operand word is loaded into n on entry.
+#define OP(op)          L_##op:
+#define DUAL_OP(op)     L_##op: n = (pc+1)->n;
+#define DISPATCH()      goto *dispatch[pc->p.op]
+#define NEXT(len)       pc += (len); DISPATCH()
 
 void execCode(Model* model)
 {
+    // op handlers, in PCodeOp order
+    static void* const opLabels[] =
+    {
+        &&L_p_nop,      &&L_p_dup,      &&L_p_swap,     &&L_p_rot,
+        &&L_p_func,     &&L_p_rts,      &&L_p_wait,     &&L_p_del,
+        &&L_p_leam,     &&L_p_leai,     &&L_p_add,      &&L_p_sub,
+        &&L_p_mul,      &&L_p_div,      &&L_p_and,      &&L_p_or,
+        &&L_p_xor,      &&L_p_sla,      &&L_p_sra,      &&L_p_eq,
+        &&L_p_ne,       &&L_p_gt,       &&L_p_le,       &&L_p_lt,
+        &&L_p_ge,       &&L_p_not,      &&L_p_nots,     &&L_p_com,
+        &&L_p_neg,      &&L_p_cvis,     &&L_p_ldl,      &&L_p_end,
+        &&L_p_liw,      &&L_p_lds,      &&L_p_pick,     &&L_p_drop,
+        &&L_p_ldsn,     &&L_p_delw,
+        &&L_p_bsr0,     &&L_p_bsr1,     &&L_p_bsr2,     &&L_p_bsr3,
+        &&L_p_bsr4,     &&L_p_bsr5,     &&L_p_bsr,      &&L_p_bsr1v1,
+        &&L_p_bsr2v1,   &&L_p_bsr3v1,   &&L_p_bsr4v1,   &&L_p_bsr5v1,
+        &&L_p_bsrv1,    &&L_p_bsr2v2,   &&L_p_bsr3v2,   &&L_p_bsr4v2,
+        &&L_p_bsr5v2,   &&L_p_bsrv2,    &&L_p_btsk,     &&L_p_br,
+        &&L_p_beq,      &&L_p_bne,      &&L_p_li,       &&L_p_lea,
+        &&L_p_ld,       &&L_p_ldx,      &&L_p_ldbx,     &&L_p_st,
+        &&L_p_stb,      &&L_p_stx,      &&L_p_addi,     &&L_p_andi,
+        &&L_p_sbop,
+        &&L_p_leaw,     &&L_p_liw2,     &&L_p_bsr2w,    &&L_p_bsr3w,
+        &&L_p_bsr5w,    &&L_p_bsr2f,    &&L_p_stw,      &&L_p_stk,
+        &&L_p_addv,     &&L_p_bfeq,     &&L_p_bfne,     &&L_p_bfgt,
+        &&L_p_bfle,     &&L_p_bflt,     &&L_p_bfge
+    };
+    static_assert(sizeof(opLabels) / sizeof(opLabels[0]) == p_last,
+                  "opLabels[] must list every PCodeOp");
+    // slow-path tables, sending every op through traceOp or countOp
+    static void* traceLabels[p_last];
+    static void* countLabels[p_last];
+    if (!traceLabels[0])
+    {
+        for (int op = 0; op < p_last; op++)
+        {
+            traceLabels[op] = &&traceOp;
+            countLabels[op] = &&countOp;
+        }
+    }
+
     ThreadContext* ctxt = model->ctxt;
     // if delay in progress and not done then don't restart task
     // (also when an 'initial' completes)
@@ -241,11 +390,34 @@ void execCode(Model* model)
     size_t* sp = ctxt->sp;      // integer stack pointer
     size_t  tos = ctxt->tos;    // top of stack
     char*   inst = ctxt->inst;  // module variables base
+    size_t  n;                  // dual op's operand
     size_t  arg[10];            // subroutine arguments
     size_t  result = 0;         // function return value
     bool    showPcode = debugLevel(3);
     int     i;
     size_t  temp;
+    size_t  nOps = 0;           // instructions executed, for profiling
+    double  startSeconds = (gProfile ? profSeconds() : 0.);
+    void* const* dispatch = (showPcode ? traceLabels :
+                             gProfile ? countLabels : opLabels);
+
+    // run as far as possible in native code, then interpret the rest
+    if (gNativeLoaded && !showPcode)
+    {
+        NativeState ns;
+        ns.pc = pc;
+        ns.sp = sp;
+        ns.tos = tos;
+        ns.inst = inst;
+        ns.model = model;
+        ns.subr = ctxt->natSubr;
+        runNativeCode(&ns);
+        ctxt->natSubr = ns.subr;
+        pc = ns.pc;
+        sp = ns.sp;
+        tos = ns.tos;
+        inst = ns.inst;
+    }
 
     if (showPcode)
     {
@@ -258,429 +430,529 @@ void execCode(Model* model)
             printf("%p: %-4s %-8x ", pc, kPCodeName[pc->p.op], pc->p.w);
         else
             printf("%p: %-4s          ", pc, kPCodeName[pc->p.op]);
+        nOps++;
+        goto *opLabels[pc->p.op];
     }
-    while (1)
-    {
-        size_t n = (pc+1)->n;
-        switch (pc->p.op)
-        {
-            case p_nop:
-                throw new VError(verr_bug, "NOP!");
-                break;
-
-            case p_bsr0:
-                result = (*(Func0*)(n))();
-                break;
+    DISPATCH();
 
-            case p_bsr1:
-                result = (*(Func1*)(n))(tos);
+    // slow path: list the stack and the next op before executing it
+  traceOp:
+    dumpDataStack(ctxt, sp, tos);
+    if (pc->p.op >= first_dualOp)
+    {
+        n = (pc+1)->n;
+        if (n > 1000)
+            printf("%p: %-4s %-9" PRIxPTR " ", pc,
+                   kPCodeName[pc->p.op], (uintptr_t)n);
+        else
+            printf("%p: %-4s %-9" PRIuPTR " ", pc,
+                   kPCodeName[pc->p.op], (uintptr_t)n);
+    }
+    else if (pc->p.op >= first_wordOp)
+        printf("%p: %-4s %-9x ", pc, kPCodeName[pc->p.op], pc->p.w);
+    else
+        printf("%p: %-4s           ", pc, kPCodeName[pc->p.op]);
+  countOp:
+    nOps++;
+    goto *opLabels[pc->p.op];
+
+    // op handlers
+        OP(p_nop)
+            throw new VError(verr_bug, "NOP!");
+
+        DUAL_OP(p_bsr0)
+            result = (*(Func0*)(n))();
+            NEXT(2);
+
+        DUAL_OP(p_bsr1)
+            result = (*(Func1*)(n))(tos);
+            tos = *sp++;
+            NEXT(2);
+
+        DUAL_OP(p_bsr2)
+            result = (*(Func2*)(n))(sp[0], tos);
+            tos = sp[1];
+            sp += 2;
+            NEXT(2);
+
+        DUAL_OP(p_bsr3)
+            result = (*(Func3*)(n))(sp[1], sp[0], tos);
+            tos = sp[2];
+            sp += 3;
+            NEXT(2);
+
+        DUAL_OP(p_bsr4)
+            result = (*(Func4*)(n))(sp[2], sp[1], sp[0], tos);
+            tos = sp[3];
+            sp += 4;
+            NEXT(2);
+
+        DUAL_OP(p_bsr5)
+            result = (*(Func5*)(n))(sp[3], sp[2], sp[1], sp[0], tos);
+            tos = sp[4];
+            sp += 5;
+            NEXT(2);
+
+        DUAL_OP(p_bsr)
+            i = pc->p.nArgs - 1;
+            if (i >= 0)
+                arg[i] = tos;
+            for (i--; i >= 0; i--)
+                arg[i] = *sp++;
+            result = (*(Func9*)(n))(arg[0], arg[1], arg[2], arg[3],
+                                arg[4], arg[5], arg[6], arg[7], arg[8]);
+            if (pc->p.nArgs > 0)
                 tos = *sp++;
-                break;
-
-            case p_bsr2:
-                result = (*(Func2*)(n))(sp[0], tos);
-                tos = sp[1];
-                sp += 2;
-                break;
-
-            case p_bsr3:
-                result = (*(Func3*)(n))(sp[1], sp[0], tos);
-                tos = sp[2];
-                sp += 3;
-                break;
-
-            case p_bsr4:
-                result = (*(Func4*)(n))(sp[2], sp[1], sp[0], tos);
-                tos = sp[3];
-                sp += 4;
-                break;
-
-            case p_bsr5:
-                result = (*(Func5*)(n))(sp[3], sp[2], sp[1], sp[0], tos);
-                tos = sp[4];
-                sp += 5;
-                break;
-
-            case p_bsr:
-                i = pc->p.nArgs - 1;
-                if (i >= 0)
-                    arg[i] = tos;
-                for (i--; i >= 0; i--)
-                    arg[i] = *sp++;
-                result = (*(Func9*)(n))(arg[0], arg[1], arg[2], arg[3],
-                                    arg[4], arg[5], arg[6], arg[7], arg[8]);
-                if (pc->p.nArgs > 0)
-                    tos = *sp++;
-                break;
-
-            case p_bsr1v1:
-                result = (*(VariFunc1*)(n))(tos);
+            NEXT(2);
+
+        DUAL_OP(p_bsr1v1)
+            result = (*(VariFunc1*)(n))(tos);
+            tos = *sp++;
+            NEXT(2);
+
+        DUAL_OP(p_bsr2v1)
+            result = (*(VariFunc1*)(n))(sp[0], tos);
+            tos = sp[1];
+            sp += 2;
+            NEXT(2);
+
+        DUAL_OP(p_bsr3v1)
+            result = (*(VariFunc1*)(n))(sp[1], sp[0], tos);
+            tos = sp[2];
+            sp += 3;
+            NEXT(2);
+
+        DUAL_OP(p_bsr4v1)
+            result = (*(VariFunc1*)(n))(sp[2], sp[1], sp[0], tos);
+            tos = sp[3];
+            sp += 4;
+            NEXT(2);
+
+        DUAL_OP(p_bsr5v1)
+            result = (*(VariFunc1*)(n))(sp[3], sp[2], sp[1], sp[0], tos);
+            tos = sp[4];
+            sp += 5;
+            NEXT(2);
+
+        DUAL_OP(p_bsrv1)
+            i = pc->p.nArgs - 1;
+            if (i >= 0)
+                arg[i] = tos;
+            for (i--; i >= 0; i--)
+                arg[i] = *sp++;
+            result = (*(VariFunc1*)(n))(arg[0], arg[1], arg[2], arg[3],
+                                arg[4], arg[5], arg[6], arg[7], arg[8]);
+            if (pc->p.nArgs > 0)
                 tos = *sp++;
-                break;
-
-            case p_bsr2v1:
-                result = (*(VariFunc1*)(n))(sp[0], tos);
-                tos = sp[1];
-                sp += 2;
-                break;
-
-            case p_bsr3v1:
-                result = (*(VariFunc1*)(n))(sp[1], sp[0], tos);
-                tos = sp[2];
-                sp += 3;
-                break;
-
-            case p_bsr4v1:
-                result = (*(VariFunc1*)(n))(sp[2], sp[1], sp[0], tos);
-                tos = sp[3];
-                sp += 4;
-                break;
-
-            case p_bsr5v1:
-                result = (*(VariFunc1*)(n))(sp[3], sp[2], sp[1], sp[0], tos);
-                tos = sp[4];
-                sp += 5;
-                break;
-
-            case p_bsrv1:
-                i = pc->p.nArgs - 1;
-                if (i >= 0)
-                    arg[i] = tos;
-                for (i--; i >= 0; i--)
-                    arg[i] = *sp++;
-                result = (*(VariFunc1*)(n))(arg[0], arg[1], arg[2], arg[3],
-                                    arg[4], arg[5], arg[6], arg[7], arg[8]);
-                if (pc->p.nArgs > 0)
-                    tos = *sp++;
-                break;
-
-            case p_bsr2v2:
-                result = (*(VariFunc2*)(n))(sp[0], tos);
-                tos = sp[1];
-                sp += 2;
-                break;
-
-            case p_bsr3v2:
-                result = (*(VariFunc2*)(n))(sp[1], sp[0], tos);
-                tos = sp[2];
-                sp += 3;
-                break;
-
-            case p_bsr4v2:
-                result = (*(VariFunc2*)(n))(sp[2], sp[1], sp[0], tos);
-                tos = sp[3];
-                sp += 4;
-                break;
-
-            case p_bsr5v2:
-                result = (*(VariFunc2*)(n))(sp[3], sp[2], sp[1], sp[0], tos);
-                tos = sp[4];
-                sp += 5;
-                break;
-
-            case p_bsrv2:
-                i = pc->p.nArgs - 1;
-                if (i >= 0)
-                    arg[i] = tos;
-                for (i--; i >= 0; i--)
-                    arg[i] = *sp++;
-                result = (*(VariFunc2*)(n))(arg[0], arg[1], arg[2], arg[3],
-                                    arg[4], arg[5], arg[6], arg[7], arg[8]);
-                if (pc->p.nArgs > 0)
-                    tos = *sp++;
-                break;
-
-           case p_btsk:
-                *(--sp) = (size_t)inst; // save current module variables base
-                inst = (char*)tos;      // new extScopeRef on stack
-                tos = (size_t)(pc + 2); // save return addr
-                pc = (PCode*)(n);       // jump to verilog task subroutine
-                goto nextOp;
-
-            case p_leam:
-                *(--sp) = tos;
-                tos = (size_t)model;
-                break;
-
-            case p_leai:
-                *(--sp) = tos;
-                tos = (size_t)inst;
-                break;
-
-            case p_func:
-                *(--sp) = tos;
-                tos = result;
-                break;
-
-            case p_rts:
-                pc = (PCode*)tos;       // pop return addr and module vars base
-                inst = (char*)*sp++;
+            NEXT(2);
+
+        DUAL_OP(p_bsr2v2)
+            result = (*(VariFunc2*)(n))(sp[0], tos);
+            tos = sp[1];
+            sp += 2;
+            NEXT(2);
+
+        DUAL_OP(p_bsr3v2)
+            result = (*(VariFunc2*)(n))(sp[1], sp[0], tos);
+            tos = sp[2];
+            sp += 3;
+            NEXT(2);
+
+        DUAL_OP(p_bsr4v2)
+            result = (*(VariFunc2*)(n))(sp[2], sp[1], sp[0], tos);
+            tos = sp[3];
+            sp += 4;
+            NEXT(2);
+
+        DUAL_OP(p_bsr5v2)
+            result = (*(VariFunc2*)(n))(sp[3], sp[2], sp[1], sp[0], tos);
+            tos = sp[4];
+            sp += 5;
+            NEXT(2);
+
+        DUAL_OP(p_bsrv2)
+            i = pc->p.nArgs - 1;
+            if (i >= 0)
+                arg[i] = tos;
+            for (i--; i >= 0; i--)
+                arg[i] = *sp++;
+            result = (*(VariFunc2*)(n))(arg[0], arg[1], arg[2], arg[3],
+                                arg[4], arg[5], arg[6], arg[7], arg[8]);
+            if (pc->p.nArgs > 0)
                 tos = *sp++;
-                goto nextOp;
-
-            case p_wait:    // Suspend task until an input signal event occurs.
-                model->isWaiting = TRUE;
+            NEXT(2);
+
+        DUAL_OP(p_btsk)
+            *(--sp) = (size_t)inst; // save current module variables base
+            inst = (char*)tos;      // new extScopeRef on stack
+            tos = (size_t)(pc + 2); // save return addr
+            pc = (PCode*)(n);       // jump to verilog task subroutine
+            DISPATCH();
+
+        OP(p_leam)
+            *(--sp) = tos;
+            tos = (size_t)model;
+            NEXT(1);
+
+        OP(p_leai)
+            *(--sp) = tos;
+            tos = (size_t)inst;
+            NEXT(1);
+
+        OP(p_func)
+            *(--sp) = tos;
+            tos = result;
+            NEXT(1);
+
+        OP(p_rts)
+            pc = (PCode*)tos;       // pop return addr and module vars base
+            inst = (char*)*sp++;
+            tos = *sp++;
+            DISPATCH();
+
+        OP(p_wait)    // Suspend task until an input signal event occurs.
+            model->isWaiting = TRUE;
+            goto pauseThread;
+
+        OP(p_del)    // Delay a task (sleep) for given number of ticks.
+            if (tos > 0)
+            {
+                addEvent((Tick)tos, model->modelSignal, LV_L, WAKEUP);
+                ctxt->wakeTime = gTick + tos - 1;
+                model->isSleeping = TRUE;
                 goto pauseThread;
+            }
+            NEXT(1);
 
-            case p_del:     // Delay a task (sleep) for given number of ticks.
-                if (tos > 0)
-                {
-                    addEvent((Tick)tos, model->modelSignal, LV_L, WAKEUP);
-                    ctxt->wakeTime = gTick + tos - 1;
-                    model->isSleeping = TRUE;
-                    goto pauseThread;
-                }
-                break;
-
-            case p_br:
-                pc = (PCode*)n;
-                goto nextOp;
-
-            case p_beq:
-                if (!tos)
-                {
-                    pc = (PCode*)n;
-                    tos = *sp++;
-                    goto nextOp;
-                }
-                tos = *sp++;
-                break;
-
-            case p_bne:
-                if (tos)
-                {
-                    pc = (PCode*)n;
-                    tos = *sp++;
-                    goto nextOp;
-                }
-                tos = *sp++;
-                break;
-
-            case p_dup:
-                *(--sp) = tos;
-                break;
-
-            case p_swap:
-                temp = tos;
-                tos = *sp;
-                *sp = temp;
-                break;
-
-            case p_rot:
-                temp = tos;
-                tos = sp[1];
-                sp[1] = sp[0];
-                sp[0] = temp;
-                break;
-
-            case p_pick:
-                *(--sp) = tos;
-                tos = sp[pc->p.w];
-                break;
-
-            case p_drop:
-                sp += pc->p.w;
-                tos = sp[-1];
-                break;
-
-            case p_li:
-                *(--sp) = tos;
-                tos = n;
-                break;
-
-            case p_liw:
-                *(--sp) = tos;
-                tos = pc->p.w;
-                break;
-
-            case p_lea:
-                *(--sp) = tos;
-                tos = (size_t)(inst + n);
-                break;
-
-            case p_ld:
-                *(--sp) = tos;
-                tos = *(size_t*)(inst + n);
-                break;
-
-            case p_lds:
-                *(--sp) = tos;
-                tos = *(char*)(*(size_t*)(inst + pc->p.w));
-                break;
-
-            case p_ldx:
-                tos = *(size_t*)(tos + n);
-                break;
-
-            case p_ldbx:
-                tos = *(char*)(tos + n);
-                break;
-
-            case p_st:
-                *(size_t*)(inst + n) = tos;
-                tos = *sp++;
-                break;
+        DUAL_OP(p_br)
+            pc = (PCode*)n;
+            DISPATCH();
 
-            case p_stb:
-                *(char*)(inst + n) = tos;
+        DUAL_OP(p_beq)
+            if (!tos)
+            {
+                pc = (PCode*)n;
                 tos = *sp++;
-                break;
+                DISPATCH();
+            }
+            tos = *sp++;
+            NEXT(2);
 
-            case p_stx:
-                *(size_t*)(tos + n) = *sp++;
+        DUAL_OP(p_bne)
+            if (tos)
+            {
+                pc = (PCode*)n;
                 tos = *sp++;
-                break;
-
-            case p_addi:
-                tos += n;
-                break;
-
-            case p_andi:
-                tos &= n;
-                break;
-
-            case p_add:
-                tos += *sp++;
-                break;
-
-            case p_sub:
-                tos = *sp++ - tos;
-                break;
-
-            case p_mul:
-                tos *= *sp++;
-                break;
-
-            case p_div:
-                if (tos == 0)
-                    throw new VError(verr_illegal, "Divide by zero");
-                tos = *sp++ / tos;
-                break;
-
-            case p_and:
-                tos &= *sp++;
-                break;
-
-            case p_or:
-                tos |= *sp++;
-                break;
-
-            case p_xor:
-                tos ^= *sp++;
-                break;
-
-            case p_sla:
-                tos = *sp++ << tos;
-                break;
-
-            case p_sra:
-                tos = *sp++ >> tos;
-                break;
-
-            case p_eq:
-                tos = *sp++ == tos;
-                break;
-
-            case p_ne:
-                tos = *sp++ != tos;
-                break;
-
-            case p_gt:
-                tos = *sp++ > tos;
-                break;
-
-            case p_le:
-                tos = *sp++ <= tos;
-                break;
-
-            case p_lt:
-                tos = *sp++ < tos;
-                break;
-
-            case p_ge:
-                tos = *sp++ >= tos;
-                break;
-
-            case p_sbop:
-                // 2-operand scalar operation using table at n
-                tos = ((Level*)n)[*sp++ + (tos << 4)];
-                break;
-
-            case p_not:
-                tos = !tos;
-                break;
-
-            case p_nots:
-                tos = funcTable.INVERTtable[tos];
-                break;
-
-            case p_com:
-                // shift left & right by count of leading zeros
-                // (except LSB)
-                // to clear them after complimenting other bits
-                i = __builtin_clzll(tos | 1);
-                tos = ((tos ^ 0xffffffff) << i) >> i;
-                break;
-
-            case p_neg:
-                tos = -tos;
-                break;
-
-            case p_cvis:
-                // turn a 1 into a 7 (LV_H)
-                tos &= 1;
-                tos = (tos << 2) | (tos << 1) | tos;
-                break;
-
-            case p_end:
+                DISPATCH();
+            }
+            tos = *sp++;
+            NEXT(2);
+
+        OP(p_dup)
+            *(--sp) = tos;
+            NEXT(1);
+
+        OP(p_swap)
+            temp = tos;
+            tos = *sp;
+            *sp = temp;
+            NEXT(1);
+
+        OP(p_rot)
+            temp = tos;
+            tos = sp[1];
+            sp[1] = sp[0];
+            sp[0] = temp;
+            NEXT(1);
+
+        OP(p_pick)
+            *(--sp) = tos;
+            tos = sp[pc->p.w];
+            NEXT(1);
+
+        OP(p_drop)
+            sp += pc->p.w;
+            tos = sp[-1];
+            NEXT(1);
+
+        DUAL_OP(p_li)
+            *(--sp) = tos;
+            tos = n;
+            NEXT(2);
+
+        OP(p_liw)
+            *(--sp) = tos;
+            tos = pc->p.w;
+            NEXT(1);
+
+        DUAL_OP(p_lea)
+            *(--sp) = tos;
+            tos = (size_t)(inst + n);
+            NEXT(2);
+
+        DUAL_OP(p_ld)
+            *(--sp) = tos;
+            tos = *(size_t*)(inst + n);
+            NEXT(2);
+
+        OP(p_lds)
+            *(--sp) = tos;
+            tos = (*(Signal**)(inst + pc->p.w))->level();
+            NEXT(1);
+
+        DUAL_OP(p_ldx)
+            tos = *(size_t*)(tos + n);
+            NEXT(2);
+
+        DUAL_OP(p_ldbx)
+            tos = *(char*)(tos + n);
+            NEXT(2);
+
+        DUAL_OP(p_st)
+            *(size_t*)(inst + n) = tos;
+            tos = *sp++;
+            NEXT(2);
+
+        DUAL_OP(p_stb)
+            *(char*)(inst + n) = tos;
+            tos = *sp++;
+            NEXT(2);
+
+        DUAL_OP(p_stx)
+            *(size_t*)(tos + n) = *sp++;
+            tos = *sp++;
+            NEXT(2);
+
+        DUAL_OP(p_addi)
+            tos += n;
+            NEXT(2);
+
+        DUAL_OP(p_andi)
+            tos &= n;
+            NEXT(2);
+
+        OP(p_add)
+            tos += *sp++;
+            NEXT(1);
+
+        OP(p_sub)
+            tos = *sp++ - tos;
+            NEXT(1);
+
+        OP(p_mul)
+            tos *= *sp++;
+            NEXT(1);
+
+        OP(p_div)
+            if (tos == 0)
+                throw new VError(verr_illegal, "Divide by zero");
+            tos = *sp++ / tos;
+            NEXT(1);
+
+        OP(p_and)
+            tos &= *sp++;
+            NEXT(1);
+
+        OP(p_or)
+            tos |= *sp++;
+            NEXT(1);
+
+        OP(p_xor)
+            tos ^= *sp++;
+            NEXT(1);
+
+        OP(p_sla)
+            tos = *sp++ << tos;
+            NEXT(1);
+
+        OP(p_sra)
+            tos = *sp++ >> tos;
+            NEXT(1);
+
+        OP(p_eq)
+            tos = *sp++ == tos;
+            NEXT(1);
+
+        OP(p_ne)
+            tos = *sp++ != tos;
+            NEXT(1);
+
+        OP(p_gt)
+            tos = *sp++ > tos;
+            NEXT(1);
+
+        OP(p_le)
+            tos = *sp++ <= tos;
+            NEXT(1);
+
+        OP(p_lt)
+            tos = *sp++ < tos;
+            NEXT(1);
+
+        OP(p_ge)
+            tos = *sp++ >= tos;
+            NEXT(1);
+
+        DUAL_OP(p_sbop)
+            // 2-operand scalar operation using table at n
+            tos = ((Level*)n)[*sp++ + (tos << 4)];
+            NEXT(2);
+
+        OP(p_not)
+            tos = !tos;
+            NEXT(1);
+
+        OP(p_nots)
+            tos = funcTable.INVERTtable[tos];
+            NEXT(1);
+
+        OP(p_com)
+            // shift left & right by count of leading zeros
+            // (except LSB)
+            // to clear them after complimenting other bits
+            i = __builtin_clzll(tos | 1);
+            tos = ((tos ^ 0xffffffff) << i) >> i;
+            NEXT(1);
+
+        OP(p_neg)
+            tos = -tos;
+            NEXT(1);
+
+        OP(p_cvis)
+            // turn a 1 into a 7 (LV_H)
+            tos &= 1;
+            tos = (tos << 2) | (tos << 1) | tos;
+            NEXT(1);
+
+        OP(p_ldl)
+            tos = ((Signal*)tos)->level();
+            NEXT(1);
+
+        // superinstructions, each doing the work of the ops it was fused from
+
+        OP(p_ldsn)
+            *(--sp) = tos;
+            tos = (*(Signal**)(inst + pc->p.w))->level();
+            tos = funcTable.INVERTtable[tos];
+            NEXT(1);
+
+        OP(p_delw)
+            *(--sp) = tos;
+            tos = pc->p.w;
+            if (tos > 0)
             {
-                size_t spRem = ctxt->stack + size_ThreadStack - sp;
-                if (spRem)
-                {
-                    dumpDataStack(ctxt, sp, tos);
-                    throw new VError(verr_bug,
-                        "BUG: %d items left on stack at end of %s pcode at %p",
-                        spRem, model->desig, pc);
-                }
-                // done: put task to sleep forever
-                ctxt->wakeTime = 0x7fffffff;
+                addEvent((Tick)tos, model->modelSignal, LV_L, WAKEUP);
+                ctxt->wakeTime = gTick + tos - 1;
                 model->isSleeping = TRUE;
                 goto pauseThread;
             }
-            default:
-                printf("*** unknown PCode op %d\n", pc->p.op);
-                break;
-        }
-
-        // advance to next PCode
-        if (pc->p.op >= first_dualOp)
-            pc += 2;
-        else
-            pc++;
+            NEXT(1);
+
+        DUAL_OP(p_leaw)
+            *(--sp) = tos;
+            *(--sp) = (size_t)(inst + n);
+            tos = pc->p.w;
+            NEXT(2);
+
+        DUAL_OP(p_liw2)
+            *(--sp) = tos;
+            *(--sp) = pc->p.w;
+            tos = n;
+            NEXT(2);
+
+        DUAL_OP(p_bsr2w)
+            result = (*(Func2*)(n))(tos, pc->p.w);
+            tos = *sp++;
+            NEXT(2);
+
+        DUAL_OP(p_bsr3w)
+            result = (*(Func3*)(n))(sp[0], tos, pc->p.w);
+            tos = sp[1];
+            sp += 2;
+            NEXT(2);
+
+        DUAL_OP(p_bsr5w)
+            result = (*(Func5*)(n))(sp[2], sp[1], sp[0], tos, pc->p.w);
+            tos = sp[3];
+            sp += 4;
+            NEXT(2);
+
+        DUAL_OP(p_bsr2f)
+            result = (*(Func2*)(n))(sp[0], tos);
+            tos = result;
+            sp++;
+            NEXT(2);
+
+        DUAL_OP(p_stw)
+            *(size_t*)(inst + n) = pc->p.w;
+            NEXT(2);
+
+        DUAL_OP(p_stk)
+            *(size_t*)(inst + n) = tos;
+            NEXT(2);
+
+        DUAL_OP(p_addv)
+            *(size_t*)(inst + n) += pc->p.w;
+            NEXT(2);
+
+        DUAL_OP(p_bfeq)
+            temp = *sp++;
+            i = (temp == tos);
+            goto branchIfFalse;
+
+        DUAL_OP(p_bfne)
+            temp = *sp++;
+            i = (temp != tos);
+            goto branchIfFalse;
+
+        DUAL_OP(p_bfgt)
+            temp = *sp++;
+            i = (temp > tos);
+            goto branchIfFalse;
+
+        DUAL_OP(p_bfle)
+            temp = *sp++;
+            i = (temp <= tos);
+            goto branchIfFalse;
+
+        DUAL_OP(p_bflt)
+            temp = *sp++;
+            i = (temp < tos);
+            goto branchIfFalse;
+
+        DUAL_OP(p_bfge)
+            temp = *sp++;
+            i = (temp >= tos);
+          branchIfFalse:
+            tos = *sp++;
+            if (!i)
+            {
+                pc = (PCode*)n;
+                DISPATCH();
+            }
+            NEXT(2);
 
-      nextOp:
-        if (showPcode)
+        OP(p_end)
         {
-            dumpDataStack(ctxt, sp, tos);
-            if (pc->p.op >= first_dualOp)
+            size_t spRem = ctxt->stack + size_ThreadStack - sp;
+            if (spRem)
             {
-                size_t n = (pc+1)->n;
-                if (n > 1000)
-                    printf("%p: %-4s %-9" PRIxPTR " ", pc,
-                           kPCodeName[pc->p.op], (uintptr_t)n);
-                else
-                    printf("%p: %-4s %-9" PRIuPTR " ", pc,
-                           kPCodeName[pc->p.op], (uintptr_t)n);
+                dumpDataStack(ctxt, sp, tos);
+                throw new VError(verr_bug,
+                    "BUG: %d items left on stack at end of %s pcode at %p",
+                    spRem, model->desig, pc);
             }
-            else if (pc->p.op >= first_wordOp)
-                printf("%p: %-4s %-9x ", pc, kPCodeName[pc->p.op], pc->p.w);
-            else
-                printf("%p: %-4s           ", pc, kPCodeName[pc->p.op]);
+            // done: put task to sleep forever
+            ctxt->wakeTime = tick_forever;
+            model->isSleeping = TRUE;
+            goto pauseThread;
         }
-    }
+
   pauseThread:
     if (showPcode)
         dumpDataStack(ctxt, sp, tos);
+    if (gProfile)
+        profModel(model->modelSignal, nOps, startSeconds);
 
     // advance to next PCode
     if (pc->p.op >= first_dualOp)
@@ -693,6 +965,11 @@ void execCode(Model* model)
     ctxt->inst = inst;
 }
 
+#undef OP
+#undef DUAL_OP
+#undef DISPATCH
+#undef NEXT
+
 //-----------------------------------------------------------------------------
 // Execute task code.
 // Note that the task code must get this task address var before
@@ -776,15 +1053,13 @@ void Model::returnToMainTask()
         {
             flagError(timeoutSignal, "TO", FALSE,
                 "Timeout waiting for %s since %2.3f ns", this->timeoutMsg,
-                (float)(now() - this->timeoutDuration)/gTicksNS);
+                (double)(now() - this->timeoutDuration)/gTicksNS);
             this->timeoutTime = 0;
             throw merr_retry;       // escape and reset sequencer
         }
         else                        // not expired yet: wait some more
         {
             Tick dt = this->timeoutTime - gTick;
-            if (dt >= (Tick)gEventHistLen)
-                dt = gEventHistLen - 1;
             // 'LV_H' means TIMEOUT event
             addEvent(dt, this->modelSignal, LV_H, WAKEUP);
         }
@@ -878,7 +1153,7 @@ size_t Model::justRisen(Signal* signal)
 {
     if (debugLevel(3) && triggerSignal)
         printf("@%2.3f %s justRisen if (%d && %d)\n",
-               (float)gTick/gTicksNS, triggerSignal->name,
+               (double)gTick/gTicksNS, triggerSignal->name(),
                triggerSignal == signal, high(signal));
     return (size_t)(triggerSignal == signal && high(signal));
 }
@@ -890,7 +1165,7 @@ size_t Model::justFallen(Signal* signal)
 {
     if (debugLevel(3) && triggerSignal)
         printf("@%2.3f %s justFallen if (%d && %d)\n",
-               (float)gTick/gTicksNS, triggerSignal->name,
+               (double)gTick/gTicksNS, triggerSignal->name(),
                triggerSignal == signal, low(signal));
     return (size_t)(triggerSignal == signal && low(signal));
 }
@@ -1047,7 +1322,7 @@ void Model::wait()
 {
     if (debugLevel(3))
         printf("@%2.3f model %s: wait()\n",
-                (float)gTick/gTicksNS, this->desig);
+                (double)gTick/gTicksNS, this->desig);
 }
 
 //-----------------------------------------------------------------------------
@@ -1063,8 +1338,6 @@ void Model::setTimeout(Tick dt, Signal* errSig, char* errMsg)
         timeoutSignal = errSig;
         timeoutMsg = errMsg;
         timeoutDuration = dt;
-        if (dt >= (Tick)gEventHistLen)
-            dt = gEventHistLen - 1;
         addEvent(dt, modelSignal, LV_H, WAKEUP);   // 'LV_H' means TIMEOUT event
     }
 }
@@ -1168,10 +1441,10 @@ void flagError(Signal* signal, const char* errName, int inFront,
             }
             display("// *** Error at ");
             if (gTick/gTicksNS > 1000000) // int run times are in milliseconds
-                display("%7.6f ms ", ((float)gTick/gTicksNS)/1000000.);
+                display("%7.6f ms ", ((double)gTick/gTicksNS)/1000000.);
             else
-                display("%2.3f ns ", (float)gTick/gTicksNS);
-            display(" on %s:\n", signal->name);
+                display("%2.3f ns ", (double)gTick/gTicksNS);
+            display(" on %s:\n", signal->name());
             gErrorTickB -= 2*gTicksNS;
             display("// ***       %s: %s\n", errName, msg);
         }
@@ -1212,8 +1485,8 @@ void Model::test()
     m->modelSignal = s;
     s->is = C_MODEL + REGISTERED;
     s->model = m;
-    s->srcLoc = 0;
-    s->srcLocObjName = s->name;
+    s->info()->srcLoc = 0;
+    s->info()->srcLocObjName = s->name();
     m->isTask = TRUE;
     m->init();
     m->executeHandCode();
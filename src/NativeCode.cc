@@ -0,0 +1,1034 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Native Code Compiler
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include "NativeCode.h"
+#include "Profile.h"
+
+// Each subroutine's function is named pvnat_<hash>, from a hash of its ops,
+// their stack depths and its internal branch offsets. Operands, such as
+// variable displacements and subroutine addresses, are read from the P-code
+// as the function runs, so that subroutines differing only in the variables
+// they use, such as one always block repeated for each bit, share one
+// function. The library is named pvnat_<hash> from the hashes of all of the
+// design's subroutines, and is built once, then reused.
+
+const int nat_abiVersion =      1;  // change when NativeState changes
+
+// A coded subroutine and its native function, if any.
+struct NatSubr
+{
+    PCode*      start;          // first op
+    PCode*      end;            // end of last op
+    size_t      hash;           // hash of its ops, naming its native function
+    NativeFunc* func;           // native function, or 0 to interpret it
+};
+
+// -------- global variables --------
+
+bool    gNativeCode;            // run native code, from -x or 'native'
+bool    gNativeLoaded;          // native code library loaded for design
+char    gNativeDir[max_nameLen] = "."; // native code library directory
+
+NatSubr* natSubrs;              // all coded subroutines, in coded order
+NatSubr* natSubrsEnd;
+NatSubr* natSubrsLimit;
+Space   natSubrSpace =          // coded subroutines space
+{
+    "native subroutines",
+    0,
+    &natSubrs,
+    sizeof(NatSubr),
+    &natSubrsEnd,
+    &natSubrsLimit
+};
+
+static void*    natLib;         // loaded library's handle
+
+EqnFunc** gSigEqnFunc;          // each signal's native equation, or 0
+size_t  gNSigEqnFuncs;          // number of signals in gSigEqnFunc
+static void*    eqnLib;         // loaded equations library's handle
+static size_t*  eqnHash;        // each signal's equation hash, or 0
+
+static void closeLibrary(void* lib);
+
+//-----------------------------------------------------------------------------
+// Unload the native gate equations.
+
+static void clearNativeEqns()
+{
+    free(gSigEqnFunc);
+    gSigEqnFunc = 0;
+    gNSigEqnFuncs = 0;
+    closeLibrary(eqnLib);
+    eqnLib = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Forget all coded subroutines and unload their native code, for a new
+// compile.
+
+void nativeClearSubrs()
+{
+    freeSpace(&natSubrSpace);
+    gNativeLoaded = FALSE;
+    closeLibrary(natLib);
+    natLib = 0;
+    clearNativeEqns();
+}
+
+//-----------------------------------------------------------------------------
+// Register a subroutine's finished P-code.
+
+void nativeAddSubr(PCode* start, PCode* end)
+{
+    if (natSubrsEnd >= natSubrsLimit)
+        reAllocSpace(&natSubrSpace, 2 * (natSubrsEnd - natSubrs) + 256);
+    NatSubr* subr = natSubrsEnd++;
+    subr->start = start;
+    subr->end = end;
+    subr->hash = 0;
+    subr->func = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Return the number of PCode words in op p.
+
+static inline int opLen(PCode* p)
+{
+    return (p->p.op >= first_dualOp ? 2 : 1);
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if op branches to its operand.
+
+static bool isBranchOp(PCodeOp op)
+{
+    switch (op)
+    {
+        case p_br:   case p_beq:  case p_bne:
+        case p_bfeq: case p_bfne: case p_bfgt:
+        case p_bfle: case p_bflt: case p_bfge:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Return the word offset of op p's branch destination within subr, or -1 if
+// it branches outside of it.
+
+static int branchDest(NatSubr* subr, PCode* p)
+{
+    PCode* dest = (PCode*)(p+1)->n;
+    if (dest < subr->start || dest >= subr->end)
+        return -1;
+    return (int)(dest - subr->start);
+}
+
+//-----------------------------------------------------------------------------
+// Add a word to an FNV-1a hash.
+
+static void hashWord(size_t* hash, size_t word)
+{
+    for (int i = 0; i < (int)sizeof(size_t); i++)
+    {
+        *hash ^= (word >> (8 * i)) & 0xff;
+        *hash *= 0x100000001b3ULL;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Hash everything about a subroutine that its native code depends on.
+
+static size_t subrHash(NatSubr* subr)
+{
+    size_t hash = 0xcbf29ce484222325ULL;
+    hashWord(&hash, subr->end - subr->start);
+    for (PCode* p = subr->start; p < subr->end; p += opLen(p))
+    {
+        size_t word = p->p.op;
+        switch (p->p.op)
+        {
+            case p_pick: case p_drop:
+                word |= (size_t)(unsigned short)p->p.w << 8;
+                break;
+            case p_bsr: case p_bsrv1: case p_bsrv2:
+                word |= (size_t)(unsigned char)p->p.nArgs << 8;
+                break;
+            default:
+                break;
+        }
+        hashWord(&hash, word);
+        if (isBranchOp(p->p.op))
+            hashWord(&hash, branchDest(subr, p));
+    }
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if op p suspends its thread, so that the op after it is where
+// the thread resumes.
+
+static bool isPause(PCode* p)
+{
+    switch (p->p.op)
+    {
+        case p_wait: case p_del: case p_delw: case p_end: case p_btsk:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Write a branch to op p's destination, taken if cond is nonzero.
+
+static void genBranch(FILE* f, NatSubr* subr, PCode* p, const char* cond)
+{
+    int dest = branchDest(subr, p);
+    if (dest >= 0)
+        fprintf(f, "    if (%s) goto L%d;\n", cond, dest);
+    else
+        fprintf(f, "    if (%s) { s->pc = (size_t*)code[%d]; r = 1;"
+                   " goto leave; }\n", cond, (int)(p - subr->start) + 1);
+}
+
+//-----------------------------------------------------------------------------
+// Write a call to subroutine type fn, taking nArgs arguments from the stack
+// and an optional pushed short word w.
+
+static void genCall(FILE* f, int k, const char* fn, int nArgs,
+                    const char* w = 0)
+{
+    fprintf(f, "    result = (*(%s*)code[%d])(", fn, k + 1);
+    int nStacked = nArgs - (w ? 1 : 0);
+    for (int i = nStacked - 2; i >= 0; i--)
+        fprintf(f, "sp[%d], ", i);
+    if (nStacked > 0)
+        fprintf(f, "tos%s", (w ? ", " : ""));
+    if (w)
+        fprintf(f, "%s", w);
+    fprintf(f, ");\n");
+    if (nStacked > 0)
+        fprintf(f, "    tos = sp[%d];\n"
+                   "    sp += %d;\n", nStacked - 1, nStacked);
+}
+
+//-----------------------------------------------------------------------------
+// Write a call through the arg[] array to a subroutine of nArgs arguments,
+// as p_bsr, p_bsrv1 and p_bsrv2 do.
+
+static void genArgsCall(FILE* f, int k, const char* fn, int nArgs)
+{
+    if (nArgs > 0)
+        fprintf(f, "    arg[%d] = tos;\n", nArgs - 1);
+    for (int i = nArgs - 2; i >= 0; i--)
+        fprintf(f, "    arg[%d] = *sp++;\n", i);
+    fprintf(f, "    result = (*(%s*)code[%d])(arg[0], arg[1], arg[2], arg[3],"
+               " arg[4], arg[5], arg[6], arg[7], arg[8]);\n", fn, k + 1);
+    if (nArgs > 0)
+        fprintf(f, "    tos = *sp++;\n");
+}
+
+//-----------------------------------------------------------------------------
+// Write the code for op p, at word offset k in subr. Returns FALSE if the op
+// isn't handled natively, so it is left to the interpreter.
+
+static bool genOp(FILE* f, NatSubr* subr, PCode* p, int k)
+{
+    char w[16];         // op's short word, read from the P-code
+    char n[24];         // dual op's operand
+    snprintf(w, sizeof(w), "W(%d)", k);
+    snprintf(n, sizeof(n), "code[%d]", k + 1);
+    static const char* cmpOp[] = { "==", "!=", ">", "<=", "<", ">=" };
+    switch (p->p.op)
+    {
+        case p_dup:
+            fprintf(f, "    *--sp = tos;\n");
+            break;
+        case p_swap:
+            fprintf(f, "    temp = tos; tos = *sp; *sp = temp;\n");
+            break;
+        case p_rot:
+            fprintf(f, "    temp = tos; tos = sp[1]; sp[1] = sp[0];"
+                       " sp[0] = temp;\n");
+            break;
+        case p_func:
+            fprintf(f, "    *--sp = tos; tos = result;\n");
+            break;
+        case p_rts:
+            fprintf(f, "    s->pc = (size_t*)tos; inst = (char*)*sp++;"
+                       " tos = *sp++; r = 1; goto leave;\n");
+            break;
+        case p_del:
+            fprintf(f, "    if (tos > 0) { s->pc = code + %d; goto leave; }\n",
+                    k);
+            break;
+        case p_leam:
+            fprintf(f, "    *--sp = tos; tos = (size_t)s->model;\n");
+            break;
+        case p_leai:
+            fprintf(f, "    *--sp = tos; tos = (size_t)inst;\n");
+            break;
+        case p_add: fprintf(f, "    tos += *sp++;\n");                break;
+        case p_sub: fprintf(f, "    tos = *sp++ - tos;\n");           break;
+        case p_mul: fprintf(f, "    tos *= *sp++;\n");                break;
+        case p_and: fprintf(f, "    tos &= *sp++;\n");                break;
+        case p_or:  fprintf(f, "    tos |= *sp++;\n");                break;
+        case p_xor: fprintf(f, "    tos ^= *sp++;\n");                break;
+        case p_sla: fprintf(f, "    tos = *sp++ << tos;\n");          break;
+        case p_sra: fprintf(f, "    tos = *sp++ >> tos;\n");          break;
+        case p_eq:  fprintf(f, "    tos = *sp++ == tos;\n");          break;
+        case p_ne:  fprintf(f, "    tos = *sp++ != tos;\n");          break;
+        case p_gt:  fprintf(f, "    tos = *sp++ > tos;\n");           break;
+        case p_le:  fprintf(f, "    tos = *sp++ <= tos;\n");          break;
+        case p_lt:  fprintf(f, "    tos = *sp++ < tos;\n");           break;
+        case p_ge:  fprintf(f, "    tos = *sp++ >= tos;\n");          break;
+        case p_not: fprintf(f, "    tos = !tos;\n");                  break;
+        case p_neg: fprintf(f, "    tos = -tos;\n");                  break;
+        case p_div:
+            fprintf(f, "    if (tos == 0) s->divideByZero();\n"
+                       "    tos = *sp++ / tos;\n");
+            break;
+        case p_nots:
+            fprintf(f, "    tos = s->invert[tos];\n");
+            break;
+        case p_com:
+            fprintf(f, "    i = __builtin_clzll(tos | 1);\n"
+                       "    tos = ((tos ^ 0xffffffff) << i) >> i;\n");
+            break;
+        case p_cvis:
+            fprintf(f, "    tos &= 1; tos = (tos << 2) | (tos << 1) | tos;\n");
+            break;
+        case p_ldl:
+            fprintf(f, "    tos = LEVEL(tos);\n");
+            break;
+
+        case p_liw:
+            fprintf(f, "    *--sp = tos; tos = %s;\n", w);
+            break;
+        case p_lds:
+            fprintf(f, "    *--sp = tos; tos = LEVEL(*(size_t*)(inst + %s));\n",
+                    w);
+            break;
+        case p_pick:
+            fprintf(f, "    *--sp = tos; tos = sp[%d];\n", p->p.w);
+            break;
+        case p_drop:
+            fprintf(f, "    sp += %d; tos = sp[-1];\n", p->p.w);
+            break;
+        case p_ldsn:
+            fprintf(f, "    *--sp = tos;"
+                       " tos = s->invert[LEVEL(*(size_t*)(inst + %s))];\n",
+                    w);
+            break;
+        case p_delw:
+            fprintf(f, "    if (%s != 0) { s->pc = code + %d; goto leave; }\n"
+                       "    *--sp = tos; tos = 0;\n", w, k);
+            break;
+
+        case p_bsr0: genCall(f, k, "Func0", 0);                  break;
+        case p_bsr1: genCall(f, k, "Func1", 1);                  break;
+        case p_bsr2: genCall(f, k, "Func2", 2);                  break;
+        case p_bsr3: genCall(f, k, "Func3", 3);                  break;
+        case p_bsr4: genCall(f, k, "Func4", 4);                  break;
+        case p_bsr5: genCall(f, k, "Func5", 5);                  break;
+        case p_bsr1v1: genCall(f, k, "VariFunc1", 1);            break;
+        case p_bsr2v1: genCall(f, k, "VariFunc1", 2);            break;
+        case p_bsr3v1: genCall(f, k, "VariFunc1", 3);            break;
+        case p_bsr4v1: genCall(f, k, "VariFunc1", 4);            break;
+        case p_bsr5v1: genCall(f, k, "VariFunc1", 5);            break;
+        case p_bsr2v2: genCall(f, k, "VariFunc2", 2);            break;
+        case p_bsr3v2: genCall(f, k, "VariFunc2", 3);            break;
+        case p_bsr4v2: genCall(f, k, "VariFunc2", 4);            break;
+        case p_bsr5v2: genCall(f, k, "VariFunc2", 5);            break;
+        case p_bsr:   genArgsCall(f, k, "Func9", p->p.nArgs);     break;
+        case p_bsrv1: genArgsCall(f, k, "VariFunc1", p->p.nArgs); break;
+        case p_bsrv2: genArgsCall(f, k, "VariFunc2", p->p.nArgs); break;
+        case p_bsr2w: genCall(f, k, "Func2", 2, w);              break;
+        case p_bsr3w: genCall(f, k, "Func3", 3, w);              break;
+        case p_bsr5w: genCall(f, k, "Func5", 5, w);              break;
+        case p_bsr2f:
+            genCall(f, k, "Func2", 2);
+            fprintf(f, "    *--sp = tos; tos = result;\n");
+            break;
+
+        case p_btsk:
+            fprintf(f, "    *--sp = (size_t)inst; inst = (char*)tos;"
+                       " tos = (size_t)(code + %d);\n"
+                       "    s->pc = (size_t*)code[%d]; r = 1; goto leave;\n",
+                    k + 2, k + 1);
+            break;
+        case p_br:
+            genBranch(f, subr, p, "1");
+            break;
+        case p_beq:
+            fprintf(f, "    temp = tos; tos = *sp++;\n");
+            genBranch(f, subr, p, "!temp");
+            break;
+        case p_bne:
+            fprintf(f, "    temp = tos; tos = *sp++;\n");
+            genBranch(f, subr, p, "temp");
+            break;
+        case p_bfeq: case p_bfne: case p_bfgt:
+        case p_bfle: case p_bflt: case p_bfge:
+            fprintf(f, "    temp = *sp++; i = (temp %s tos); tos = *sp++;\n",
+                    cmpOp[p->p.op - p_bfeq]);
+            genBranch(f, subr, p, "!i");
+            break;
+
+        case p_li:
+            fprintf(f, "    *--sp = tos; tos = %s;\n", n);
+            break;
+        case p_lea:
+            fprintf(f, "    *--sp = tos; tos = (size_t)(inst + %s);\n", n);
+            break;
+        case p_ld:
+            fprintf(f, "    *--sp = tos; tos = *(size_t*)(inst + %s);\n", n);
+            break;
+        case p_ldx:
+            fprintf(f, "    tos = *(size_t*)(tos + %s);\n", n);
+            break;
+        case p_ldbx:
+            fprintf(f, "    tos = *(char*)(tos + %s);\n", n);
+            break;
+        case p_st:
+            fprintf(f, "    *(size_t*)(inst + %s) = tos; tos = *sp++;\n", n);
+            break;
+        case p_stb:
+            fprintf(f, "    *(char*)(inst + %s) = tos; tos = *sp++;\n", n);
+            break;
+        case p_stx:
+            fprintf(f, "    *(size_t*)(tos + %s) = *sp++; tos = *sp++;\n", n);
+            break;
+        case p_addi:
+            fprintf(f, "    tos += %s;\n", n);
+            break;
+        case p_andi:
+            fprintf(f, "    tos &= %s;\n", n);
+            break;
+        case p_sbop:
+            fprintf(f, "    tos = ((const Level*)%s)[*sp++ + (tos << 4)];\n",
+                    n);
+            break;
+
+        case p_leaw:
+            fprintf(f, "    *--sp = tos; *--sp = (size_t)(inst + %s);"
+                       " tos = %s;\n", n, w);
+            break;
+        case p_liw2:
+            fprintf(f, "    *--sp = tos; *--sp = %s; tos = %s;\n", w, n);
+            break;
+        case p_stw:
+            fprintf(f, "    *(size_t*)(inst + %s) = %s;\n", n, w);
+            break;
+        case p_stk:
+            fprintf(f, "    *(size_t*)(inst + %s) = tos;\n", n);
+            break;
+        case p_addv:
+            fprintf(f, "    *(size_t*)(inst + %s) += %s;\n", n, w);
+            break;
+
+        default:    // wait, end: let the interpreter suspend the thread
+            return FALSE;
+    }
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Write the native function for subroutine subr.
+
+static void genSubr(FILE* f, NatSubr* subr)
+{
+    int len = (int)(subr->end - subr->start);
+    char* isLabel = (char*)calloc(len + 1, 1);
+    char* isEntry = (char*)calloc(len + 1, 1);
+    if (!isLabel || !isEntry)
+        throw new VError(verr_memOverflow, "no memory for native code");
+    isEntry[0] = TRUE;
+    for (PCode* p = subr->start; p < subr->end; p += opLen(p))
+    {
+        int k = (int)(p - subr->start);
+        if (isPause(p))
+            isEntry[k + opLen(p)] = TRUE;
+        if (isBranchOp(p->p.op) && branchDest(subr, p) >= 0)
+            isLabel[branchDest(subr, p)] = TRUE;
+    }
+
+    fprintf(f, "\n// %s ... %s\n", kPCodeName[subr->start->p.op],
+            kPCodeName[(subr->end - 1)->p.op]);
+    fprintf(f, "extern \"C\" int pvnat_%016llx(NativeState* s, size_t* code)\n"
+               "{\n", (unsigned long long)subr->hash);
+    fprintf(f, "    size_t* sp = s->sp;\n"
+               "    size_t tos = s->tos;\n"
+               "    char* inst = s->inst;\n"
+               "    size_t result = 0, temp, arg[10];\n"
+               "    int i, r = 0;\n"
+               "    (void)temp; (void)arg; (void)i; (void)result;\n"
+               "    switch (s->pc - code)\n"
+               "    {\n");
+    for (int k = 0; k < len; k++)
+        if (isEntry[k])
+            fprintf(f, "        case %d: goto L%d;\n", k, k);
+    fprintf(f, "        default: return 0;\n"
+               "    }\n");
+    for (PCode* p = subr->start; p < subr->end; p += opLen(p))
+    {
+        int k = (int)(p - subr->start);
+        if (isLabel[k] || isEntry[k])
+            fprintf(f, "  L%d:\n", k);
+        fprintf(f, "    // %s\n", kPCodeName[p->p.op]);
+        if (!genOp(f, subr, p, k))
+            fprintf(f, "    s->pc = code + %d; goto leave;\n", k);
+    }
+    fprintf(f, "    s->pc = code + %d;\n"
+               "  leave:\n"
+               "    s->sp = sp;\n"
+               "    s->tos = tos;\n"
+               "    s->inst = inst;\n"
+               "    return r;\n"
+               "}\n", len);
+    free(isLabel);
+    free(isEntry);
+}
+
+//-----------------------------------------------------------------------------
+// Create a native code source file and write the declarations common to all
+// native code into it. Returns the open file, or 0 if it can't be created.
+
+static FILE* genPreamble(const char* fileName, size_t designHash)
+{
+    FILE* f = fopen(fileName, "w");
+    if (!f)
+        return 0;
+    fprintf(f, "// PVSim %s native code for design %016llx\n\n",
+            gPSVersion, (unsigned long long)designHash);
+    fprintf(f, "#include <stddef.h>\n\n"
+               "typedef %s Level;\n\n"
+               "extern \"C\" int pvnat_abi() { return %d; }\n\n",
+            (sizeof(Level) == 1 ? "unsigned char" : "unsigned int"),
+            nat_abiVersion);
+    return f;
+}
+
+//-----------------------------------------------------------------------------
+// Write the C++ source for all of the design's distinct subroutines.
+// Returns FALSE if the file can't be created.
+
+static bool genSource(const char* fileName, size_t designHash)
+{
+    FILE* f = genPreamble(fileName, designHash);
+    if (!f)
+        return FALSE;
+    fprintf(f, "typedef size_t (Func0)();\n"
+               "typedef size_t (Func1)(size_t);\n"
+               "typedef size_t (Func2)(size_t, size_t);\n"
+               "typedef size_t (Func3)(size_t, size_t, size_t);\n"
+               "typedef size_t (Func4)(size_t, size_t, size_t, size_t);\n"
+               "typedef size_t (Func5)(size_t, size_t, size_t, size_t,"
+               " size_t);\n"
+               "typedef size_t (Func9)(size_t, size_t, size_t, size_t,"
+               " size_t, size_t, size_t, size_t, size_t);\n"
+               "typedef size_t (VariFunc1)(size_t, ...);\n"
+               "typedef size_t (VariFunc2)(size_t, size_t, ...);\n\n");
+    fprintf(f, "struct NativeState\n"
+               "{\n"
+               "    size_t*     pc;\n"
+               "    size_t*     sp;\n"
+               "    size_t      tos;\n"
+               "    char*       inst;\n"
+               "    void*       model;\n"
+               "    Level*      sigLevel;\n"
+               "    char*       signals;\n"
+               "    const Level* invert;\n"
+               "    void        (*divideByZero)();\n"
+               "    void*       subr;\n"
+               "};\n\n"
+               "#define LEVEL(sig) (s->sigLevel[((char*)(sig) - s->signals)"
+               " / %d])\n"
+               "#define W(k) ((size_t)*(const short*)((const char*)(code + (k))"
+               " + %d))\n",
+            (int)sizeof(Signal), (int)offsetof(PCode, p.w));
+
+    // subroutines are sorted by hash here, so each distinct one is written once
+    for (NatSubr* subr = natSubrs; subr < natSubrsEnd; subr++)
+        if (subr == natSubrs || subr->hash != (subr-1)->hash)
+            genSubr(f, subr);
+    fclose(f);
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Throw the interpreter's divide-by-zero error, for native code.
+
+static void divideByZero()
+{
+    throw new VError(verr_illegal, "Divide by zero");
+}
+
+//-----------------------------------------------------------------------------
+// qsort() comparison of subroutines by address.
+
+static int compareSubrStart(const void* a, const void* b)
+{
+    PCode* pa = ((const NatSubr*)a)->start;
+    PCode* pb = ((const NatSubr*)b)->start;
+    return (pa < pb ? -1 : (pa > pb ? 1 : 0));
+}
+
+//-----------------------------------------------------------------------------
+// qsort() comparison of subroutines by hash.
+
+static int compareSubrHash(const void* a, const void* b)
+{
+    size_t ha = ((const NatSubr*)a)->hash;
+    size_t hb = ((const NatSubr*)b)->hash;
+    return (ha < hb ? -1 : (ha > hb ? 1 : 0));
+}
+
+#ifndef _WIN32
+//-----------------------------------------------------------------------------
+// Copy a file name into dest single-quoted for the shell, truncating it if
+// dest is too small.
+
+static void shellQuote(char* dest, size_t size, const char* name)
+{
+    size_t n = 0;
+    dest[n++] = '\'';
+    for ( ; *name && n + 6 < size; name++)
+    {
+        if (*name == '\'')
+        {
+            strcpy(dest + n, "'\\''");
+            n += 4;
+        }
+        else
+            dest[n++] = *name;
+    }
+    dest[n++] = '\'';
+    dest[n] = 0;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Open native library <dir>/<prefix>_<hash>.so, first writing its source with
+// gen() and compiling it if it hasn't been built yet. Returns its handle, or 0
+// after warning that the design's 'what' will be interpreted.
+
+static void* openLibrary(const char* prefix, size_t hash,
+                         bool (*gen)(const char* fileName, size_t hash),
+                         const char* what)
+{
+#ifdef _WIN32
+    display("    native code isn't supported here: interpreting %s\n", what);
+    return 0;
+#else
+    char baseName[2*max_nameLen];
+    char libName[2*max_nameLen + 8];
+    snprintf(baseName, sizeof(baseName), "%s/%s_%016llx", gNativeDir, prefix,
+             (unsigned long long)hash);
+    snprintf(libName, sizeof(libName), "%s.so", baseName);
+
+    if (access(libName, R_OK) != 0)
+    {
+        double start = profSeconds();
+        if (!gQuietMode)
+            display("    compiling native code %s...\n", libName);
+        // build under per-process names, so runs of the same design started
+        // together don't overwrite each other's files
+        char srcName[2*max_nameLen + 8];
+        char logName[2*max_nameLen + 8];
+        char tmpSrc[2*max_nameLen + 24];
+        char tmpLib[2*max_nameLen + 24];
+        char tmpLog[2*max_nameLen + 24];
+        int pid = (int)getpid();
+        snprintf(srcName, sizeof(srcName), "%s.cc", baseName);
+        snprintf(logName, sizeof(logName), "%s.log", baseName);
+        snprintf(tmpSrc, sizeof(tmpSrc), "%s.%d.cc", baseName, pid);
+        snprintf(tmpLib, sizeof(tmpLib), "%s.%d.tmp", baseName, pid);
+        snprintf(tmpLog, sizeof(tmpLog), "%s.%d.log", baseName, pid);
+        if (!(*gen)(tmpSrc, hash))
+        {
+            display("    *** can't create %s: interpreting %s\n", tmpSrc,
+                    what);
+            return 0;
+        }
+        char qSrc[4*max_nameLen + 64];
+        char qLib[4*max_nameLen + 64];
+        char qLog[4*max_nameLen + 64];
+        char cmd[16*max_nameLen];
+        shellQuote(qSrc, sizeof(qSrc), tmpSrc);
+        shellQuote(qLib, sizeof(qLib), tmpLib);
+        shellQuote(qLog, sizeof(qLog), tmpLog);
+        const char* cxx = getenv("CXX");
+        snprintf(cmd, sizeof(cmd), "%s -O2 -fPIC -shared -o %s %s > %s 2>&1",
+                 (cxx ? cxx : "c++"), qLib, qSrc, qLog);
+        bool built = (system(cmd) == 0 && rename(tmpLib, libName) == 0);
+        rename(tmpSrc, srcName);
+        rename(tmpLog, logName);
+        if (!built)
+        {
+            unlink(tmpLib);
+            display("    *** native code compile failed, see %s:"
+                    " interpreting %s\n", logName, what);
+            return 0;
+        }
+        if (!gQuietMode)
+            display("      [%5.3f sec]\n", profSeconds() - start);
+    }
+
+    void* lib = dlopen(libName, RTLD_NOW | RTLD_LOCAL);
+    int (*abi)() = (lib ? (int (*)())dlsym(lib, "pvnat_abi") : 0);
+    if (!abi || abi() != nat_abiVersion)
+    {
+        display("    *** can't load native code %s: interpreting %s\n",
+                libName, what);
+        if (lib)
+            dlclose(lib);
+        return 0;
+    }
+    return lib;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Look up function <prefix>_<hash> in a native library.
+
+static void* findFunc(void* lib, const char* prefix, size_t hash)
+{
+#ifdef _WIN32
+    return 0;
+#else
+    char funcName[32];
+    snprintf(funcName, sizeof(funcName), "%s_%016llx", prefix,
+             (unsigned long long)hash);
+    return dlsym(lib, funcName);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Close a native library.
+
+static void closeLibrary(void* lib)
+{
+#ifndef _WIN32
+    if (lib)
+        dlclose(lib);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Load the design's native code library, building it first if needed. Any
+// subroutine without native code, or the whole design if the library can't
+// be built, is interpreted.
+
+void loadNativeCode()
+{
+    gNativeLoaded = FALSE;
+    if (!gNativeCode || natSubrsEnd == natSubrs)
+        return;
+    size_t designHash = 0xcbf29ce484222325ULL;
+    hashWord(&designHash, nat_abiVersion);
+    hashWord(&designHash, sizeof(Signal));
+    for (NatSubr* subr = natSubrs; subr < natSubrsEnd; subr++)
+    {
+        subr->hash = subrHash(subr);
+        hashWord(&designHash, subr->hash);
+    }
+
+    qsort(natSubrs, natSubrsEnd - natSubrs, sizeof(NatSubr), compareSubrHash);
+    natLib = openLibrary("pvnat", designHash, genSource, "P-code");
+    if (!natLib)
+        return;
+    int nFuncs = 0;
+    for (NatSubr* subr = natSubrs; subr < natSubrsEnd; subr++)
+    {
+        subr->func = (NativeFunc*)findFunc(natLib, "pvnat", subr->hash);
+        if (subr->func)
+            nFuncs++;
+    }
+    qsort(natSubrs, natSubrsEnd - natSubrs, sizeof(NatSubr),
+          compareSubrStart);
+    gNativeLoaded = TRUE;
+    if (!gQuietMode)
+        display("    native code for %d of %d subroutines loaded.\n",
+                nFuncs, (int)(natSubrsEnd - natSubrs));
+}
+
+//-----------------------------------------------------------------------------
+// Run a thread's native code from s->pc for as long as it can, leaving the
+// registers where the interpreter is to continue.
+
+void runNativeCode(NativeState* s)
+{
+    s->sigLevel = gSigLevel;
+    s->signals = (char*)gSignals;
+    s->invert = funcTable.INVERTtable;
+    s->divideByZero = divideByZero;
+    NatSubr* subr = (NatSubr*)s->subr;
+    while (1)
+    {
+        // find the subroutine holding pc, usually the one the thread last ran
+        if (!subr || s->pc < subr->start || s->pc >= subr->end)
+        {
+            NatSubr* lo = natSubrs;
+            NatSubr* hi = natSubrsEnd;
+            while (hi - lo > 1)
+            {
+                NatSubr* mid = lo + (hi - lo) / 2;
+                if (mid->start <= s->pc)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            if (s->pc < lo->start || s->pc >= lo->end)
+                return;
+            subr = lo;
+            s->subr = subr;
+        }
+        if (!subr->func || !(*subr->func)(s, subr->start))
+            return;
+    }
+}
+
+// -------- gate equations --------
+
+// A signal's gate equation (see runEqnCode()) is a list of EqnOp opcodes,
+// each followed by the numbers of the signals it reads. Its native function
+// is named pveq_<hash>, from a hash of just the opcodes: each signal number
+// is read from the equation code as the function runs, so that all
+// equations of the same shape, such as the same tri-state bus in every
+// instance of a module, share one function.
+
+//-----------------------------------------------------------------------------
+// Return the number of signal operands following equation opcode op, or -1
+// if op isn't one that native code handles.
+
+static int eqnOperands(short op)
+{
+    switch (op)
+    {
+        case AND_OP: case LOAD_OP:
+            return 1;
+        case ENABLE_OP:
+            return 2;
+        case SAVEOR_OP: case TRUE_OP: case FALSE_OP: case NEWTS_OP:
+        case STORE_OP:
+            return 0;
+        default:
+            return -1;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Return the hash of a signal's equation opcodes, or 0 if it is empty or has
+// an opcode that native code doesn't handle.
+
+static size_t eqnCodeHash(EqnItem* ic)
+{
+    size_t hash = 0xcbf29ce484222325ULL;
+    const char* p = (const char*)ic;
+    if (*(const short*)p == STORE_OP)
+        return 0;
+    for (;;)
+    {
+        short op = *(const short*)p;
+        int nOprs = eqnOperands(op);
+        if (nOprs < 0)
+            return 0;
+        hashWord(&hash, op);
+        if (op == STORE_OP)
+            return (hash ? hash : 1);
+        p += sizeof(short) + nOprs * sizeof(EqnItem);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Write the native function for a signal's equation code, using the same
+// FuncTable lookups as runEqnCode().
+
+static void genEqn(FILE* f, size_t hash, EqnItem* ic)
+{
+    fprintf(f, "\nextern \"C\" int pveq_%016llx(const char* ic,"
+               " const Level* lv,\n    const FuncTable* t)\n"
+               "{\n"
+               "    int andAcc = 0, orAcc = 0, opr1, opr2;\n"
+               "    (void)andAcc; (void)opr1; (void)opr2;\n",
+            (unsigned long long)hash);
+    const char* p = (const char*)ic;
+    for (;;)
+    {
+        short op = *(const short*)p;
+        int k = (int)(p - (const char*)ic) + sizeof(short);
+        int k2 = k + sizeof(EqnItem);
+        switch (op)
+        {
+            case AND_OP:
+                fprintf(f, "    andAcc = t->ANDtable[lv[OPR(%d)]][andAcc];\n",
+                        k);
+                break;
+            case LOAD_OP:
+                fprintf(f, "    andAcc = lv[OPR(%d)];\n", k);
+                break;
+            case SAVEOR_OP:
+                fprintf(f, "    orAcc = andAcc;\n");
+                break;
+            case TRUE_OP:
+                fprintf(f, "    andAcc = %d;\n", LV_H);
+                break;
+            case FALSE_OP:
+                fprintf(f, "    andAcc = %d;\n", LV_L);
+                break;
+            case NEWTS_OP:
+                fprintf(f, "    orAcc = %d;\n", LV_Z);
+                break;
+            case ENABLE_OP:
+                fprintf(f, "    opr1 = lv[OPR(%d)];\n"
+                           "    opr2 = lv[OPR(%d)];\n"
+                           "    andAcc = t->ENABLEtable[opr1][opr2];\n"
+                           "    orAcc = t->TStable[orAcc][andAcc];\n", k, k2);
+                break;
+            case STORE_OP:
+                fprintf(f, "    return orAcc;\n"
+                           "}\n");
+                return;
+        }
+        p += sizeof(short) + eqnOperands(op) * sizeof(EqnItem);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// qsort() comparison of signal numbers by equation hash.
+
+static int compareEqnHash(const void* a, const void* b)
+{
+    size_t ha = eqnHash[*(const unsigned*)a];
+    size_t hb = eqnHash[*(const unsigned*)b];
+    return (ha < hb ? -1 : (ha > hb ? 1 : 0));
+}
+
+//-----------------------------------------------------------------------------
+// Write the C++ source for all of the design's distinct gate equations.
+// Returns FALSE if the file can't be created.
+
+static bool genEqnSource(const char* fileName, size_t designHash)
+{
+    FILE* f = genPreamble(fileName, designHash);
+    if (!f)
+        return FALSE;
+    fprintf(f, "struct FuncTable\n"
+               "{\n"
+               "    Level   ANDtable[12][16];\n"
+               "    Level   ORtable[12][16];\n"
+               "    Level   XORtable[12][16];\n"
+               "    Level   ENABLEtable[12][16];\n"
+               "    Level   TStable[12][16];\n"
+               "};\n\n"
+               "#define OPR(k) (*(const long*)(ic + (k)))\n");
+
+    // list the equations' signals sorted by hash, to write each one once
+    size_t nSignals = gNextSignal - gSignals;
+    unsigned* sigs = (unsigned*)malloc(nSignals * sizeof(unsigned));
+    if (!sigs)
+        throw new VError(verr_memOverflow, "no memory for native code");
+    size_t nEqns = 0;
+    for (size_t i = 0; i < nSignals; i++)
+        if (eqnHash[i])
+            sigs[nEqns++] = (unsigned)i;
+    qsort(sigs, nEqns, sizeof(unsigned), compareEqnHash);
+    for (size_t i = 0; i < nEqns; i++)
+        if (i == 0 || eqnHash[sigs[i]] != eqnHash[sigs[i-1]])
+            genEqn(f, eqnHash[sigs[i]], gSignals[sigs[i]].evalCode);
+    free(sigs);
+    fclose(f);
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Load native code for the design's gate equations once they have all been
+// coded, building it first if needed. Any signal without native code is
+// evaluated by runEqnCode().
+
+void loadNativeEqns()
+{
+    clearNativeEqns();
+    if (!gNativeCode)
+        return;
+    size_t nSignals = gNextSignal - gSignals;
+    eqnHash = (size_t*)calloc(nSignals, sizeof(size_t));
+    if (!eqnHash)
+        throw new VError(verr_memOverflow, "no memory for native code");
+    size_t designHash = 0xcbf29ce484222325ULL;
+    hashWord(&designHash, nat_abiVersion);
+    hashWord(&designHash, sizeof(EqnItem));
+    int nEqns = 0;
+    for (size_t i = 0; i < nSignals; i++)
+    {
+        Signal* signal = gSignals + i;
+        if (signal->evalCode && !(signal->is & C_MODEL))
+        {
+            eqnHash[i] = eqnCodeHash(signal->evalCode);
+            hashWord(&designHash, eqnHash[i]);
+            if (eqnHash[i])
+                nEqns++;
+        }
+    }
+
+    if (nEqns > 0)
+        eqnLib = openLibrary("pveq", designHash, genEqnSource,
+                             "gate equations");
+    if (eqnLib)
+    {
+        gSigEqnFunc = (EqnFunc**)calloc(nSignals, sizeof(EqnFunc*));
+        if (!gSigEqnFunc)
+            throw new VError(verr_memOverflow, "no memory for native code");
+        int nFuncs = 0;
+        for (size_t i = 0; i < nSignals; i++)
+            if (eqnHash[i])
+            {
+                gSigEqnFunc[i] = (EqnFunc*)findFunc(eqnLib, "pveq",
+                                                    eqnHash[i]);
+                if (gSigEqnFunc[i])
+                    nFuncs++;
+            }
+        gNSigEqnFuncs = nSignals;
+        if (!gQuietMode)
+            display("    native code for %d of %d gate equations loaded.\n",
+                    nFuncs, nEqns);
+    }
+    free(eqnHash);
+    eqnHash = 0;
+}
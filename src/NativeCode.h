@@ -0,0 +1,83 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Native Code Compiler
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include "Utils.h"
+#include "PSignal.h"
+#include "PCode.h"
+
+// In native mode, each event handler and task subroutine's P-code is
+// translated ahead of time into a C++ function, and all of a design's
+// functions are built by the system compiler into a shared library in the
+// native code directory, named by a hash of the design's P-code. Later runs
+// of the same design load that library instead of building it again.
+//
+// A native function runs its subroutine's P-code machine on the thread's
+// stack, just as execCode() does, reading each op's operand word from the
+// P-code itself, so one library serves every compile of the design.
+// It returns when the thread leaves the subroutine, or when it reaches a
+// wait, del or end, which execCode() then interprets to suspend the thread.
+//
+// The gate equations coded for tri-state signals when a simulation starts
+// are compiled the same way, into a second library, and evalSignalCode()
+// calls a signal's native equation in place of runEqnCode().
+
+class Model;
+
+// P-code machine registers shared with a native function. A copy of this
+// layout is written into each generated source file.
+struct NativeState
+{
+    PCode*      pc;             // PCode program counter
+    size_t*     sp;             // integer stack pointer
+    size_t      tos;            // top of stack
+    char*       inst;           // module variables base
+    Model*      model;          // model running the thread
+    Level*      sigLevel;       // gSigLevel, each signal's level
+    char*       signals;        // gSignals
+    const Level* invert;        // funcTable.INVERTtable
+    void        (*divideByZero)();
+    void*       subr;           // subroutine last run, a lookup hint
+};
+
+// A native function: returns FALSE if s->pc isn't one of its entry points,
+// or it stopped at an op to interpret, else TRUE to dispatch on s->pc again.
+typedef int (NativeFunc)(NativeState* s, PCode* base);
+
+// A native gate equation: returns a signal's new level from its equation
+// code, the signal levels and the level function tables.
+typedef int (EqnFunc)(EqnItem* ic, const Level* sigLevel,
+                      const FuncTable* func);
+
+extern bool     gNativeCode;    // run native code, from -x or 'native'
+extern bool     gNativeLoaded;  // native code library loaded for design
+extern char     gNativeDir[max_nameLen]; // native code library directory
+extern EqnFunc** gSigEqnFunc;   // each signal's native equation, or 0
+extern size_t   gNSigEqnFuncs;  // number of signals in gSigEqnFunc
+
+void nativeClearSubrs();
+void nativeAddSubr(PCode* start, PCode* end);
+void loadNativeCode();
+void runNativeCode(NativeState* s);
+void loadNativeEqns();
@@ -59,12 +59,15 @@ enum PCodeOp {
     p_com,      //      integer ~TOS to TOS
     p_neg,      //      integer negate TOS to TOS
     p_cvis,     //      convert integer to scalar
+    p_ldl,      //      load level of signal at address TOS
     p_end,      //      return from pcode execution
 
     p_liw,      // w    load immediate 16-bit integer w to TOS
-    p_lds,      // w    load byte from variable at address at inst[w]
+    p_lds,      // w    load level of signal at address at inst[w]
     p_pick,     // w    pick wth item from stack
     p_drop,     // w    drop w items
+    p_ldsn,     // w    lds w, nots
+    p_delw,     // w    liw w, del
 
     p_bsr0,     // n    branch to C subroutine at n with no args
     p_bsr1,     // n    1 arg
@@ -99,6 +102,23 @@ enum PCodeOp {
     p_addi,     // n    add immediate n to TOS
     p_andi,     // n    and immediate n to TOS
     p_sbop,     // n    scalar op TOS+1 with TOS, using table at n
+
+    // superinstructions, fused from common sequences by optimizePCode()
+    p_leaw,     // n w  lea n, liw w
+    p_liw2,     // n w  liw w, liw n
+    p_bsr2w,    // n w  liw w, bsr2 n
+    p_bsr3w,    // n w  liw w, bsr3 n
+    p_bsr5w,    // n w  liw w, bsr5 n
+    p_bsr2f,    // n    bsr2 n, func
+    p_stw,      // n w  liw w, st n
+    p_stk,      // n    st n, ld n: store TOS at inst[n], keeping it
+    p_addv,     // n w  ld n, addi w, st n
+    p_bfeq,     // n    eq, beq n: pop 2 and branch to n if TOS+1 != TOS
+    p_bfne,     // n    ne, beq n
+    p_bfgt,     // n    gt, beq n
+    p_bfle,     // n    le, beq n
+    p_bflt,     // n    lt, beq n
+    p_bfge,     // n    ge, beq n
     p_last };
 
 const int first_wordOp = p_liw;
@@ -122,3 +142,5 @@ extern PCode*   pc;         // current PCode being compiled
 
 void codeOp(PCodeOp op);
 void codeOpI(PCodeOp op, size_t arg);
+
+PCode* optimizePCode(PCode* start, PCode* end);
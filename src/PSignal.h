@@ -89,26 +89,24 @@ extern const FuncTable funcTable;
 
 const int   max_signals =       9000;   // default
 const int   ns_runTime =       10000;
+const DLong ns_maxRunTime = 1000000000000000LL; // duration 0: 10^15 ns
 
-typedef long long   DLong;
-//typedef DLong     Tick;
-typedef unsigned long Tick;
+typedef unsigned long long Tick;    // 64 bits, even where long is 32
+const Tick  tick_forever =      ~(Tick)0;   // a time never reached
 
 struct Signal;
 class Event;
 class Model;
 
-// One node in a linked-list of signals
+// One dependency between two signals, recorded while the design is
+// elaborated. Each signal's edges are linked newest first, by edge number + 1.
 
-class SigNode : SimObject
+struct SigEdge
 {
-    Signal*     mSignal;
-    SigNode*    mNext;
-public:
-                SigNode(Signal* signal, SigNode* next)
-                        { mSignal = signal; mNext = next; }
-    Signal*     signal()        { return mSignal; }
-    SigNode*    next()          { return mNext; }
+    unsigned    signal;         // input signal number
+    unsigned    dependent;      // dependent signal number
+    unsigned    prevDepend;     // signal's previous dependent edge, or 0
+    unsigned    prevInput;      // dependent's previous input edge, or 0
 };
 
 // 'signal is' flags bits:
@@ -117,7 +115,9 @@ const int DISPLAYED =       0x02;
 const int TRI_STATE =       0x04;
 const int TRACED =          0x08;
 const int INTERNAL =        0x10;   // _i0, _e0, etc. Affects initialization.
+const int LEVELIZED =       0x20;   // model signal of a levelized assign
 const int C_MODEL =         0x40;
+const int SWEPT =           0x80;   // net set directly by levelized sweep
 
 // signal modes
 const int MODE_WENT_META =  0x40;   // updateDependents: adjusts preLevel
@@ -128,18 +128,48 @@ const int DISP_INVERTED =   0x02;
 const int DISP_BUS_BIT =    0x04;
 const int DISP_STATE =      0x08;
 
-struct Signal8
+// Per-signal state that the simulation loop touches on every event is kept
+// out of the Signal record, in dense arrays indexed by signal number, so that
+// equation evaluation only reads the level array. The naming and display
+// fields are kept in a separate SignalInfo table, also by signal number.
+
+struct SignalInfo
 {
-    char    level[8];       // (*8) signal current level
-    char    nlevel[8];      // (*8) signal current level, inverted
-    char    preLevel[8];    // (*8) signal's (latched) pre-delay level
+    const char* name;       // signal name
+    Token*  srcLoc;         // location in source of signal's definition
+    const char* srcLocObjName; // name of object at srcLoc (may be parent's)
+    char    busOpt;         // bus display options
+    char    busWidth;       // number of following signals to display as a bus
+    char    busBitNo;       // bit-number in a bus: must have MSB first
 };
 
+extern Signal*  gSignals;       // gSignals array
+extern Level*   gSigLevel;      // each signal's current level
+extern Level*   gSigNLevel;     // each signal's current level, inverted
+extern Level*   gSigPreLevel;   // each signal's (latched) pre-delay level
+extern Tick*    gSigLastTime;   // time of each signal's last event
+extern SignalInfo* gSigInfo;    // each signal's name and display info
+
+// Once frozen, each signal's dependents and inputs are a run of signal
+// numbers in gDepends and gInputs, starting at its entry in gDependStart or
+// gInputStart and ending at the next signal's. Before that these entries
+// hold the signal's newest edge number + 1, or 0.
+extern unsigned* gDepends;      // dependent signal numbers
+extern unsigned* gDependStart;  // each signal's first entry in gDepends
+extern unsigned* gInputs;       // input signal numbers
+extern unsigned* gInputStart;   // each signal's first entry in gInputs
+
+// When levelizing, zero-delay assigns are evaluated by a sweep at the end of
+// each tick, in topological order. gSweepOrder lists their model signals in
+// that order, and gSigSweepPos holds a model signal's position + 1, or 0.
+extern unsigned* gSweepOrder;   // sweep's model signal numbers, in order
+extern size_t   gNSweepModels;  // number of models in gSweepOrder
+extern unsigned* gSigSweepPos;  // each signal's sweep position + 1, or 0
+
 // 'signals' structure: (size is a multiple of 8; note the grouping:)
 
 struct Signal
 {
-    Level   level:8;        // (*8) signal current level
     Level   lastLevel:8;    // level at last rise, fall
     Level   initLevel:8;    // signal initialization level
     Level   clockPol:8;     // registered signal's clock level after edge
@@ -147,38 +177,28 @@ struct Signal
     Level   floatLevel;     // tri-state signal's pull or float to level
     char    is;             // simulator flags
     char    mode;           // compiler signal-mode flags
+    char    ambDepth;       // ambiguity depth
 
-    const char* name;       // signal name
     EqnItem* evalCode;      // evaluation code
 
-    Level   nlevel:8;       // (*8) signal current level, inverted
-    char    ambDepth;       // ambiguity depth
-    short   minTime;        // signal's delay min time
-    short   maxTime;        // signal's delay max time
-    short   setupTime;      // registered signal's setup time
-
-    Level   preLevel:8;     // (*8) signal's (latched) pre-delay level
+    Tick    minTime;        // signal's delay min time
+    Tick    maxTime;        // signal's delay max time
+    Tick    setupTime;      // registered signal's setup time
+    Tick    holdTime;       // registered signal's hold time
+    Tick    metaTime;       // registered signal's metastable time
+    Tick    RCminTime;      // pulled-up signal's min RC time constant
+    Tick    RCmaxTime;      // pulled-up signal's max RC time constant
     Level   aMetaLevel:8;   // after metastable period level
     Level   initDspLevel:8; // level at start of displayed portion
     char    randDlyCnt;     // random delay counter
-    short   holdTime;       // registered signal's hold time
-    short   metaTime;       // registered signal's metastable time
+    char    srcNo;          // source number for tri-state signals
 
-    Tick    lastTime;       // time of signal's last event
     Tick    lastInTime;     // time of signal's last input event
     Tick    lastClkTm;      // time of signal's clock's last event
     Event*  firstDispEvt;   // signal's displayed events linked-list
     Event*  scrollEvt;      // first event in scrolled window
     Event*  lastEvtPosted;  // last event posted (end of linked list)
 
-    char    busOpt;         // bus display options
-    char    busWidth;       // number of following signals to display as a bus
-    char    busBitNo;       // bit-number in a bus: must have MSB first
-    char    srcNo;          // source number for tri-state signals
-    Event*  dispEvent;      // current event being drawn for bit in bus
-
-    SigNode* inputsList;    // linked-list of signal's input signals
-    SigNode* dependList;    // linked-list of signals affected by this one
     Signal* clock;          // signal's clock signal, if registered
     Signal* enable;         // internal (_i0) signal's enable (_e0) signal
     Signal* set;            // signal's ASET signal, if reg, or TG's otherTSSig
@@ -186,11 +206,26 @@ struct Signal
     Signal* clockEn;        // signal's CE signal, if registered
     Model*  model;          // C-model object model if C-model
     Event*  floatList;      // list of signal's pending float events
-    short   RCminTime;      // pulled-up signal's min RC time constant
-    short   RCmaxTime;      // pulled-up signal's max RC time constant
-    Token*  srcLoc;         // location in source of signal's definition
-    const char* srcLocObjName; // name of object at srcLoc (may be parent's)
     Signal* randTrkSig;     // signal to track random delay counter of, or zero
+
+    size_t  index() const   { return this - gSignals; }
+    Level   level() const   { return gSigLevel[index()]; }
+    void    setLevel(Level level)       { gSigLevel[index()] = level; }
+    void    setNLevel(Level level)      { gSigNLevel[index()] = level; }
+    Level   preLevel() const            { return gSigPreLevel[index()]; }
+    void    setPreLevel(Level level)    { gSigPreLevel[index()] = level; }
+    void    setLastTime(Tick t)         { gSigLastTime[index()] = t; }
+    SignalInfo* info() const    { return gSigInfo + index(); }
+    // signals affected by this one, and this signal's input signals
+    const unsigned* dependBegin() const
+                        { return gDepends + gDependStart[index()]; }
+    const unsigned* dependEnd() const
+                        { return gDepends + gDependStart[index()+1]; }
+    const unsigned* inputBegin() const
+                        { return gInputs + gInputStart[index()]; }
+    const unsigned* inputEnd() const
+                        { return gInputs + gInputStart[index()+1]; }
+    const char* name() const    { return gSigInfo[index()].name; }
 }  __attribute__((aligned(8)));
 
 // 'event is' flags bits
@@ -204,25 +239,70 @@ const int DELETED_FLOAT =   0x10;   // deleted float event
 const int ATTACHED_TEXT =   0x20;   // attached-text event
 const int FREE =            0x40;   // deleted event
 
-// 'events' structure: ( should be even long length for speed)
+// 'events' structure: a compact record for the simulation loop, with its
+// links held as 32-bit indices into the event pool (index 0 is no event). The
+// rarely used fields are kept in a side table for each pool slab, allocated
+// the first time an event in that slab needs them.
 const int MAX_ATT_TEXT_LEN = 16;
+const int eventSlabBits = 14;
+const size_t eventSlabLen = 1 << eventSlabBits; // events per pool slab
 
-class Event
+class Event;
+struct EventCold;
+
+struct EventSlab
+{
+    Event*      events;     // slab's events
+    EventCold*  cold;       // slab's side table, or 0 if not yet needed
+};
+
+extern EventSlab* gEventSlabs;  // event pool slab table
+
+void allocEventCold(EventSlab* slab);
+
+// A link to an event, stored as the event's pool index.
+
+class EventRef
 {
+    unsigned    index;
 public:
-    Level   level:8;        // signal's new level
-    char    is;             // event flags
-    Tick    tick;           // event time
+    inline      operator Event*() const;
+    inline Event* operator->() const;
+    inline EventRef& operator=(Event* event);
+};
+
+// A link to a signal, stored as the signal's index in gSignals.
 
-    Signal* signal;         // event signal
-    Event*  next;           // next event in list for this time
-    Event*  nextFloat;      // next float event in list
-    Event*  prevInSignal;   // previous event for this signal
-    Event*  nextInSignal;   // next event for this signal
+class SignalRef
+{
+    unsigned    index;
+public:
+                operator Signal*() const    { return gSignals + index; }
+    Signal*     operator->() const          { return gSignals + index; }
+    SignalRef&  operator=(Signal* signal)
+                    { index = signal - gSignals; return *this; }
+};
 
-    char    attText[MAX_ATT_TEXT_LEN]; // optional attached-text
+class Event
+{
+public:
+    Tick        tick;           // event time
+    SignalRef   signal;         // event signal
+    EventRef    next;           // next event in list for this time
+    EventRef    prevInSignal;   // previous event for this signal
+    EventRef    nextInSignal;   // next event for this signal
+    unsigned    index;          // this event's pool index
+    Level       level:8;        // signal's new level
+    char        is;             // event flags
+
+    inline EventCold* cold();
+    inline char* attText();     // optional attached-text
+    inline Event* nextFloat();  // next float event in list
+    inline void setNextFloat(Event* event);
+    inline void clearNextFloat();
 #ifdef EVENT_HISTORY
-    Event*  cause;          // event that caused this event
+    inline Event* cause();      // event that caused this event
+    inline void setCause(Event* event);
 #endif
     void    insertS(Signal* sig, Event* after)
             {
@@ -239,7 +319,7 @@ public:
                     if (sig->firstDispEvt == 0)
                         sig->firstDispEvt = this;
                     if (sig->is & TRACED)
-                        printfEvt("   insertS %s after\n", sig->name);
+                        printfEvt("   insertS %s after\n", sig->name());
                 }
                 else
                 {
@@ -252,7 +332,7 @@ public:
                     if (!sig->lastEvtPosted)
                         sig->lastEvtPosted = this;
                     if (sig->is & TRACED)
-                        printfEvt("   insertS %s at beginning\n", sig->name);
+                        printfEvt("   insertS %s at beginning\n", sig->name());
                 }
             }
     void    removeFromSignal()
@@ -265,7 +345,7 @@ public:
                     sig->firstDispEvt = next;
                     if (sig->is & TRACED)
                         display("remove %s @%ld -> %ld\n",
-                                sig->name, this->tick, next->tick);
+                                sig->name(), this->tick, next->tick);
                 }
                 if (sig->lastEvtPosted == this)
                     sig->lastEvtPosted = prev;
@@ -276,6 +356,51 @@ public:
             }
 };
 
+struct EventCold
+{
+    char        attText[MAX_ATT_TEXT_LEN]; // optional attached-text
+    EventRef    nextFloat;      // next float event in list
+#ifdef EVENT_HISTORY
+    EventRef    cause;          // event that caused this event
+#endif
+};
+
+inline Event* eventPtr(unsigned index)
+{
+    return (index ? gEventSlabs[index >> eventSlabBits].events +
+                    (index & (eventSlabLen - 1)) : 0);
+}
+
+inline EventRef::operator Event*() const    { return eventPtr(index); }
+inline Event* EventRef::operator->() const  { return eventPtr(index); }
+inline EventRef& EventRef::operator=(Event* event)
+{
+    index = (event ? event->index : 0);
+    return *this;
+}
+
+inline EventCold* Event::cold()
+{
+    EventSlab* slab = &gEventSlabs[index >> eventSlabBits];
+    if (!slab->cold)
+        allocEventCold(slab);
+    return slab->cold + (index & (eventSlabLen - 1));
+}
+
+inline char* Event::attText()   { return cold()->attText; }
+inline Event* Event::nextFloat() { return cold()->nextFloat; }
+inline void Event::setNextFloat(Event* event) { cold()->nextFloat = event; }
+inline void Event::clearNextFloat()
+{
+    EventSlab* slab = &gEventSlabs[index >> eventSlabBits];
+    if (slab->cold)
+        slab->cold[index & (eventSlabLen - 1)].nextFloat = 0;
+}
+#ifdef EVENT_HISTORY
+inline Event* Event::cause()    { return cold()->cause; }
+inline void Event::setCause(Event* event) { cold()->cause = event; }
+#endif
+
 class OpenFile
 {
     FILE*   file;
@@ -290,7 +415,11 @@ public:
 
 extern size_t   gMaxSignals;    // storage limits, from initApplication
 extern size_t   gMaxEvents;
-extern Signal*  gSignals;       // gSignals array
+extern size_t   gEventMemLimit; // cap on event pool size in bytes, or 0
+extern size_t   gCmdEventMemLimit; // cap from -m, or 0
+extern int      gEvalThreads;   // threads evaluating dependents, from -j
+extern bool     gLevelize;      // sweep zero-delay assigns, from -l
+extern DLong    gTelemetryNS;   // ns between scheduler samples, or 0
 
 extern Signal*  gNextSignal;    // next available signal table offset
 extern int      gTicksNS;       // number of ns per simulation step
@@ -322,28 +451,32 @@ extern PyObject* gSigs;         // Python list of all displayed signals
 #endif
 extern OpenFile* gOpenFiles;        // list of open data files
 extern const char* gLevelNames;
-extern size_t   gEventHistLen;  // length of 1/2 time line FIFO
-extern Event**  timeLine;       // time line: array of event lists per tick
+extern size_t   gEventHistLen;  // length of event history, in tick bins
 
 // -------- global function prototypes --------
 
 // Simulator.cc
 void newSimulation();
+void saveTimeFormat();
 Event* addEvent(Tick t, Signal* signal, Level level, char eventType);
 void addMinMaxEvent(Tick    dtMin,
                     Tick    dtMax,
                     Signal* signal,
                     Level   level);
-void removeEvent(Event** link, Event* event);
+void removeEvent(EventRef* link, Event* event);
 void attachSignalText(Signal* signal,
                       char* s,
                       bool inFront = FALSE,
                       int ticksAllotted = 600);
+Event** listPendingEvents(size_t* nEvents);
+void resetTimeline(Tick tick);
+Event* restoreEvent(Tick tick, Signal* signal, Level level, char eventType);
 void simulate();
 
 // EvalSignal.cc
 Level evalSignalCode(Signal* signal, Signal* sigs, const FuncTable* func);
 Level warnUnused(Signal* signal);
+signed char* evalDependents(Signal* signal);
 
 inline Level evalSignal(Signal* sig)
 {
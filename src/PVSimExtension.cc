@@ -23,12 +23,17 @@
 
 #include <Python.h>
 #include <time.h>
+#include <unistd.h>
 #include <new>
 
 #include "Utils.h"
 #include "Model.h"
 #include "VLCompiler.h"
 #include "PSignal.h"
+#include "EventHist.h"
+#include "TestChoices.h"
+#include "Checkpoint.h"
+#include "DesignCache.h"
 
 // -------- constants --------
 
@@ -66,6 +71,11 @@ Tick nTicks;
 static PyObject* displayFn = NULL;
 static PyObject* readFileFn = NULL;
 
+// what the loaded design was compiled from, for deciding if it can be reused
+static char loadedProjName[max_nameLen];
+static char loadedTestChoice[max_nameLen];
+static int  loadedDebugLevel;
+
 
 //-----------------------------------------------------------------------------
 // Tell backend which Python functions to use for display, file reading.
@@ -136,6 +146,11 @@ void display(const char* format, ...)
     vsnprintf(msg, max_messageLen-1, format, ap);
     va_end(ap);
 
+    if (gLogFile)                       // test choice worker's log
+    {
+        fputs(msg, gLogFile);
+        return;
+    }
     PyObject* args = Py_BuildValue("(s)", msg);
     PyObject* result = PyObject_CallObject(displayFn, args);
     Py_DECREF(args);
@@ -155,7 +170,7 @@ void printfEvt(const char* format, ...)
     vsnprintf(msg, max_messageLen-1, format, ap);
     va_end(ap);
 
-    display("%6.3f: %s", (float)gTick/gTicksNS, msg);
+    display("%6.3f: %s", (double)gTick/gTicksNS, msg);
 }
 
 //-----------------------------------------------------------------------------
@@ -170,11 +185,11 @@ void newSignalPy(Signal* signal, Level newLevel, bool isBus,
     //                          srcFile, srcPos, isBus, lsub, rsub)
     const char* srcName = "-";
     size_t srcPos = 0;
-    Token* srcLoc = signal->srcLoc;
+    Token* srcLoc = signal->info()->srcLoc;
     if (debugLevel(3))
     {
-        display("newSignalPy signal %s: isBus=%d (%s)\n", signal->name, isBus,
-                signal->srcLocObjName);
+        display("newSignalPy signal %s: isBus=%d (%s)\n", signal->name(),
+                isBus, signal->info()->srcLocObjName);
         if (srcLoc)
         {
             display(" srcLoc tokCode=%d\n", srcLoc->tokCode);
@@ -187,12 +202,12 @@ void newSignalPy(Signal* signal, Level newLevel, bool isBus,
     }
     size_t index = signal - gSignals;
     PyObject* args = Py_BuildValue("(ns[ic]snsiii)", index,
-      signal->name, 0, gLevelNames[newLevel], srcName, srcPos,
-      signal->srcLocObjName, isBus, lsub, rsub);
+      signal->name(), 0, gLevelNames[newLevel], srcName, srcPos,
+      signal->info()->srcLocObjName, isBus, lsub, rsub);
     PyObject* sig = PyObject_CallObject(gPySignalClass, args);
     Py_DECREF(args);
 
-    if (signal->busOpt & DISP_BUS_BIT && !(signal->is & TRACED))
+    if (signal->info()->busOpt & DISP_BUS_BIT && !(signal->is & TRACED))
     {
         // sig.isDisplayed = False
         PyObject* isDisp = PyObject_GetAttrString(sig, "isDisplayed");
@@ -223,7 +238,7 @@ void addEventPy(Signal* signal, Tick tick, PyObject* val)
     if (debugLevel(3))
     {
         PyObject* sVal = PyObject_Repr(val);
-        display("addEventPy %s %ld %s\n", signal->name, tick,
+        display("addEventPy %s %llu %s\n", signal->name(), tick,
                 PyUnicode_AsUTF8(sVal));
     }
     // sig = sigs[signal-gSignals]
@@ -234,7 +249,7 @@ void addEventPy(Signal* signal, Tick tick, PyObject* val)
     Py_DECREF(key);
     if (sig == NULL)
         throw new VError(verr_notFound, "Signal %s not in gSigs",
-                         signal->name);
+                         signal->name());
     Py_INCREF(sig);
 
     // sig.events += [tick, val]
@@ -246,8 +261,8 @@ void addEventPy(Signal* signal, Tick tick, PyObject* val)
     }
     else if (!PyList_CheckExact(events))
         throw new VError(verr_illegal, "Signal.events %s not a list",
-                         signal->name);
-    PyObject* t = Py_BuildValue("l", tick);
+                         signal->name());
+    PyObject* t = Py_BuildValue("K", tick);
     PyList_Append(events, t);
     Py_DECREF(t);
     PyList_Append(events, val);
@@ -268,55 +283,57 @@ void buildBusSignals()
 
     for (Signal* busSig = gSignals; busSig < gNextSignal; busSig++)
     {
-        if (!(busSig->busOpt & DISP_BUS && busSig->is & DISPLAYED))
+        if (!(busSig->info()->busOpt & DISP_BUS && busSig->is & DISPLAYED))
             continue;
 
         Signal* msbSig = busSig + 1;
-        Signal* lsbSig = busSig + msbSig->busWidth + 1;
-        int busInv = ((busSig->busOpt & DISP_INVERTED) != 0);
+        Signal* lsbSig = busSig + msbSig->info()->busWidth + 1;
+        int busInv = ((busSig->info()->busOpt & DISP_INVERTED) != 0);
         Signal* bitSig;
         if (debugLevel(3) || busSig->is & TRACED)
             display("buildBusSignals signal %s [ %s : %s ]\n",
-                    busSig->name, msbSig->name, lsbSig->name);
+                    busSig->name(), msbSig->name(), lsbSig->name());
 
-        // start all bit-signals at the beginning of display time
+        // start all bit-signals at the beginning of display time, reading
+        // their older events forward from the history store as they come due
+        HistScan scan;
+        scan.start(msbSig, lsbSig);
         for (bitSig = msbSig; bitSig < lsbSig; bitSig++)
         {
-            bitSig->dispEvent = bitSig->firstDispEvt;
-            bitSig->level = bitSig->initDspLevel;
+            bitSig->setLevel(bitSig->initDspLevel);
             bitSig->lastLevel = bitSig->initDspLevel;
             if (busSig->is & TRACED)
-                display("bbs bit signal %s start %ld\n",
-                        bitSig->name, bitSig->firstDispEvt->tick);
+                display("bbs bit signal %s\n", bitSig->name());
         }
         Tick curTick = 0;
 
         // loop for each event on any bit-signal, in chronological order.
-        int loopCount = 0;
+        Tick loopCount = 0;
         bool lastPass = FALSE;
         Level curLevel = LV_L;
         for (;;)
         {
             // get all "current" bits levels, and look for the next event time
-            const Tick infinity = 0x7fffffff;
-            Tick nextTick = infinity;
+            // (events not read yet are no earlier than scan.aheadTick)
+            const Tick infinity = tick_forever;
+            scan.readTo(curTick);
+            Tick nextTick = scan.aheadTick;
             Signal* bitSig;
             for (bitSig = msbSig; bitSig < lsbSig; bitSig++)
             {
-                Event* event = bitSig->dispEvent;
-                while (event && (event->is & ATTACHED_TEXT))
-                    event = event->nextInSignal;
-                if (event)
+                Tick tick;
+                Level level;
+                if (scan.peekLevel(bitSig, &tick, &level))
                 {
-                    if (event->tick <= curTick)         // if event is current
-                        bitSig->level = event->level;   // use its level
-                    if (event->tick < nextTick)         // find next event
-                        nextTick = event->tick;
+                    if (tick <= curTick)                // if event is current
+                        bitSig->setLevel(level);        // use its level
+                    if (tick < nextTick)                // find next event
+                        nextTick = tick;
                 }
             }
             if (busSig->is & TRACED)
-                display("bbs %s: curTick=%ld nextTick=%ld\n",
-                        busSig->name, curTick, nextTick);
+                display("bbs %s: curTick=%llu nextTick=%llu\n",
+                        busSig->name(), curTick, nextTick);
 
             if (nextTick == infinity)
             {
@@ -325,12 +342,12 @@ void buildBusSignals()
             }
 
             // merge "current" bits into one bus signal level
-            curLevel = msbSig->level;
+            curLevel = msbSig->level();
             size_t busValue = 0;
             bool busValueValid = TRUE;
             for (bitSig = msbSig; bitSig < lsbSig; bitSig++)
             {
-                Level bitLevel = bitSig->level;
+                Level bitLevel = bitSig->level();
                 if (curLevel != bitLevel)
                 {
                     if (curLevel == LV_C || bitLevel == LV_C)
@@ -353,27 +370,24 @@ void buildBusSignals()
                     else
                         busValueValid = FALSE;
                 }
-                Event* event = bitSig->dispEvent;
-                if (event)
+                if (scan.due(bitSig, curTick))
                 {
-                    if (event->tick <= curTick)
+                    HistCursor* event = scan.cursor(bitSig);
+                    if (event->is() & ATTACHED_TEXT)
                     {
-                        bitSig->dispEvent = event->nextInSignal;
-                        if (event->is & ATTACHED_TEXT)
-                        {
-                            PyObject* val = Py_BuildValue("(cs)",
-                                gLevelNames[bitSig->lastLevel],
-                                event->attText);
-                            addEventPy(busSig, event->tick, val);
-                        }
-                        else
-                            bitSig->lastLevel = bitSig->level;
+                        PyObject* val = Py_BuildValue("(cs)",
+                            gLevelNames[bitSig->lastLevel],
+                            event->text());
+                        addEventPy(busSig, event->tick(), val);
                     }
+                    else
+                        bitSig->lastLevel = bitSig->level();
+                    scan.next(bitSig);
                 }
             }
             if (busSig->is & TRACED)
                 display(" bbs %s: busValue=%ld\n",
-                        busSig->name, (long)busValue);
+                        busSig->name(), (long)busValue);
 
             // store the bus event
             PyObject* val = PyLong_FromSize_t(busValue);
@@ -386,14 +400,15 @@ void buildBusSignals()
                 break;
 
             // quit loop if stuck
-            if (loopCount++ > gNSDuration*gTicksNS + 100)
+            if (loopCount++ > (Tick)gNSDuration*gTicksNS + 100)
             {
                 display("\n// *** While locating bit events for bus %s",
-                        busSig->name);
+                        busSig->name());
                 throw new VError(verr_bug,
                     "stuck in infinite loop in buildBusSignals()");
             }
         }
+        scan.finish();
     }
 }
 
@@ -419,7 +434,7 @@ void freeTempSpace(Space* space)
 {
     if (space->mallocBase != NULL)
     {
-        free(space->mallocBase);
+        heapFree(space->mallocBase);
         space->mallocBase = NULL;
     }
 }
@@ -433,7 +448,7 @@ void allocTempSpace(Space* space, long numElems)
 {
     assert(space->mallocBase == NULL);
     long size = space->elemSize * numElems + 4;
-    char* mallocBase = (char*)malloc(size);
+    char* mallocBase = (char*)heapAlloc(size);
     if (mallocBase == NULL)
         throw new VError(verr_memOverflow,
                         "Out of non-application memory for %s", space->name);
@@ -467,19 +482,46 @@ void handleNewErr()
 }
 
 //-----------------------------------------------------------------------------
-// Compile and simulate thread.
+// Reset the back end's memory and settings, discarding any compiled design.
 
-static PyObject* pvsim_Simulate(PyObject* self, PyObject* args)
+static void initBackEnd()
 {
-    PyObject* result = NULL;
-    const char* projFullPathNameTemp;
-    const char* testChoice;
-    if (!PyArg_ParseTuple(args, "ss", &projFullPathNameTemp, &testChoice))
+    gDP = gDPEnd = 0;                   // init memory space
+    gBlockList = 0;
+    gNSStart = 0;
+    gNSDuration = ns_runTime;
+    gLogFile = 0;
+
+    initFiles();
+
+    std::set_new_handler(handleNewErr);
+    gHashTable = (Symbol**)heapAlloc(max_hashCodes*sizeof(Symbol*));
+    if (gHashTable == 0)
     {
-        return NULL;
+        reportErrDialog("can't allocate hash table");
+        throw;
     }
 
-    strncpy(gProjFullPathName, projFullPathNameTemp, max_nameLen-1);
+    SimObject::simObjList = 0;
+    gNextSignal = gSignals; // for newSignals startup
+    freeBlocks();
+    Model::initModels();
+
+    // Allocate application free memory for signals, bitmap, etc.
+    gMaxSignals = max_signals;
+    // !!! readPrefsFile();
+    gMaxSignals = gMaxSignals & 0xfffffff8;
+    gMaxStringSpace = 100 * gMaxSignals;
+
+    gSimFileLoaded = FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// Set the project's full path name, and its base name.
+
+static void setProjName(const char* projFullPathName)
+{
+    strncpy(gProjFullPathName, projFullPathName, max_nameLen-1);
     char* p;
     char* start = gProjFullPathName;
     for (p = gProjFullPathName; *p; p++)
@@ -489,6 +531,35 @@ static PyObject* pvsim_Simulate(PyObject* self, PyObject* args)
     for (p = start; *p && *p != '.'; p++)
         *p2++ = *p;
     *p2 = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Set up a newly forked test choice worker: its display output goes to its
+//  own log file, <gProjName>.log, instead of the display function.
+
+void startTestWorker()
+{
+    char logFileName[max_nameLen];
+    snprintf(logFileName, sizeof(logFileName), "%s.log", gProjName);
+    gLogFile = fopen(logFileName, "w");
+    if (!gLogFile)
+        exitTestWorker(TRUE);
+}
+
+//-----------------------------------------------------------------------------
+// Compile and simulate thread.
+
+static PyObject* pvsim_Simulate(PyObject* self, PyObject* args)
+{
+    PyObject* result = NULL;
+    const char* projFullPathNameTemp;
+    const char* testChoice;
+    if (!PyArg_ParseTuple(args, "ss", &projFullPathNameTemp, &testChoice))
+    {
+        return NULL;
+    }
+
+    setProjName(projFullPathNameTemp);
 
     Py_XDECREF(gSigs);
     gSigs = PyDict_New();
@@ -520,6 +591,21 @@ static PyObject* pvsim_Simulate(PyObject* self, PyObject* args)
         gWarningCount = 0;
         gFlaggedErrCount = 0;
         gFatalLoadErrors = FALSE;
+        // The elaborated design is reused as is within this process, or
+        // read from the design cache by loadProjectFile() in a new one.
+        if (gSimFileLoaded)
+        {
+            if (strcmp(gProjFullPathName, loadedProjName) == 0 &&
+                strcmp(testChoice, loadedTestChoice) == 0 &&
+                VL::debugLevel == loadedDebugLevel && srcStampsCurrent())
+            {
+                if (!gQuietMode)
+                    display("    reusing compiled design...\n");
+                ckptRestoreInitialState();
+            }
+            else
+                initBackEnd();
+        }
         if (!gSimFileLoaded)
         {
             newSimulation();
@@ -534,10 +620,18 @@ static PyObject* pvsim_Simulate(PyObject* self, PyObject* args)
                 display("      [%ld signals, %5.3f sec]\n",
                    gNextSignal-gSignals, (float)compileRealTime/CLOCKS_PER_SEC);
             gSimFileLoaded = TRUE;
+            if (!gFatalLoadErrors)
+                ckptSaveInitialState();
+            strcpy(loadedProjName, gProjFullPathName);
+            strncpy(loadedTestChoice, testChoice, max_nameLen-1);
+            loadedDebugLevel = VL::debugLevel;
         }
         if (gFatalLoadErrors)
+        {
+            loadedProjName[0] = 0;      // don't reuse a failed compile
             throw new VError(verr_stop,
                              "fatal errors encountered-- see log above");
+        }
 
         // Run the simulation
         if (gNSStart < 0)
@@ -557,7 +651,7 @@ static PyObject* pvsim_Simulate(PyObject* self, PyObject* args)
             Py_DECREF(barSig);
             barSig = PyLong_FromSize_t(gBarSignal - gSignals);
         }
-        result = Py_BuildValue("OiS", gSigs, nTicks, barSig);
+        result = Py_BuildValue("OKS", gSigs, nTicks, barSig);
     }
     catch (VError* err)
     {
@@ -575,12 +669,110 @@ static PyObject* pvsim_Simulate(PyObject* self, PyObject* args)
     return result;
 }
 
+//-----------------------------------------------------------------------------
+// Compile and simulate all test choices, each in a worker process.
+
+const char* pvsim_SimulateAll_docstring =
+"SimulateAll(projFullPathName, nWorkers=0)\n"
+"Run every test choice declared by a \"test_choice <name>\" line in the\n"
+"project file. The design is compiled once up to where a test choice\n"
+"first makes a difference, then a worker process is forked for each\n"
+"choice to finish compiling and simulating it. A worker's output goes to\n"
+"<project>_<choice>.log. Returns a list of (choice, status, seconds), where\n"
+"status is 0 if the test passed, the number of errors flagged (up to\n"
+"254), or 255 if it failed to compile or simulate. Not supported on\n"
+"Windows, which can't fork.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"projFullPathName : str\n"
+"    Project (.psim) file.\n"
+"nWorkers : int, optional\n"
+"    Number of workers run at once (default is one per processor).\n";
+
+static PyObject* pvsim_SimulateAll(PyObject* self, PyObject* args)
+{
+    PyObject* result = NULL;
+    const char* projFullPathNameTemp;
+    int nWorkers = 0;
+    if (!PyArg_ParseTuple(args, "s|i", &projFullPathNameTemp, &nWorkers))
+    {
+        return NULL;
+    }
+
+    setProjName(projFullPathNameTemp);
+    gTestWorkers = nWorkers > 0 ? nWorkers : defaultTestWorkers();
+
+    try
+    {
+        char projFileName[max_nameLen];
+        snprintf(projFileName, sizeof(projFileName), "%s.psim", gProjName);
+        gatherTestChoices(projFileName);
+
+        // workers define their own test choice macros, so no design built
+        // for a single test choice can be shared
+        initBackEnd();
+        loadedProjName[0] = 0;
+        gWarningCount = 0;
+        gFlaggedErrCount = 0;
+        gFatalLoadErrors = FALSE;
+        newSimulation();
+        initSimulator();
+        gWarningCount = 0;
+        loadProjectFile(projFileName);
+
+        // only a worker gets here, with its test choice compiled
+        if (gFatalLoadErrors)
+            throw new VError(verr_stop,
+                             "fatal errors encountered-- see log above");
+        if (gNSStart < 0)
+            gNSStart = 0;
+        if (gNSDuration < 10)
+            gNSDuration = 10;
+        simulate();
+        exitTestWorker(FALSE);
+    }
+    catch (VError* err)
+    {
+        err->display();
+    }
+    catch (MainErrorCode errNo)
+    {
+        if (errNo == merr_testsDone)        // all test choices have been run
+        {
+            result = PyList_New(gNTestChoices);
+            for (int i = 0; i < gNTestChoices; i++)
+            {
+                TestResult* test = &gTestResults[i];
+                PyList_SET_ITEM(result, i, Py_BuildValue("(sid)",
+                                test->choice, test->status, test->seconds));
+            }
+        }
+        else
+            display("\n*** ERROR: pvsim_SimulateAll: code %d\n", errNo);
+    }
+    catch (...)
+    {
+        display("\n*** ERROR: pvsim_SimulateAll: unknown\n");
+    }
+    if (isTestWorker())
+        exitTestWorker(TRUE);
+    gTestWorkers = 0;
+
+    return result;
+}
+
 //-----------------------------------------------------------------------------
 // Initialize back end and set operating modes.
 
 const char* pvsim_Init_docstring =
-"Init(debugLevel=0, quietMode=0, tagDebug=0)\n"
-"Initialize the back end.\n"
+"Init(debugLevel=0, quietMode=0, tagDebug=0, cacheDir=None)\n"
+"Initialize the back end and set operating modes. A design compiled by\n"
+"Simulate() is kept in memory, and reused by the next Simulate() in this\n"
+"process of the same project and test choice if none of its source files\n"
+"have changed. Each reuse starts from the design's state as compiled.\n"
+"Given a cacheDir, compiled designs are also kept in files there, where\n"
+"Simulate() in any process, or pvsim -k, finds them the same way.\n"
 "\n"
 "Parameters\n"
 "----------\n"
@@ -593,15 +785,20 @@ const char* pvsim_Init_docstring =
 "quietMode : int, optional\n"
 "    Quiet mode flag (default is 0).\n"
 "tagDebug : int, optional\n"
-"    Tag debug flag (default is 0).\n";
+"    Tag debug flag (default is 0).\n"
+"cacheDir : str, optional\n"
+"    Design cache directory (default is none, unless the project file\n"
+"    has a 'cache' line).\n";
 
 static PyObject* pvsim_Init(PyObject* self, PyObject* args)
 {
     int debugLevel = 0;
     int quietMode = 0;
     int tagDebug = 0;
+    const char* cacheDir = 0;
 
-    if (!PyArg_ParseTuple(args, "|iii", &debugLevel, &quietMode, &tagDebug))
+    if (!PyArg_ParseTuple(args, "|iiiz", &debugLevel, &quietMode, &tagDebug,
+                          &cacheDir))
     {
         return NULL;
     }
@@ -610,36 +807,13 @@ static PyObject* pvsim_Init(PyObject* self, PyObject* args)
     VL::debugLevel = debugLevel;
     gQuietMode = quietMode;
     gTagDebug = tagDebug;
+    gDesignCache = (cacheDir != 0);
+    if (cacheDir)
+        strncpy(gCacheDir, cacheDir, max_nameLen-1);
 
-    // initialization
-    gDP = gDPEnd = 0;                   // init memory space
-    gBlockList = 0;
-    gNSStart = 0;
-    gNSDuration = ns_runTime;
-    gLogFile = 0;
-
-    initFiles();
-
-    std::set_new_handler(handleNewErr);
-    gHashTable = (Symbol**)malloc(max_hashCodes*sizeof(Symbol*));
-    if (gHashTable == 0)
-    {
-        reportErrDialog("can't allocate hash table");
-        throw;
-    }
-
-    SimObject::simObjList = 0;
-    gNextSignal = gSignals; // for newSignals startup
-    freeBlocks();
-    Model::initModels();
-
-    // Allocate application free memory for signals, bitmap, etc.
-    gMaxSignals = max_signals;
-    // !!! readPrefsFile();
-    gMaxSignals = gMaxSignals & 0xfffffff8;
-    gMaxStringSpace = 100 * gMaxSignals;
-
-    gSimFileLoaded = FALSE;
+    // keep a compiled design for Simulate() to reuse if still current
+    if (!gSimFileLoaded)
+        initBackEnd();
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -664,6 +838,8 @@ static PyMethodDef PVSimMethods[] = {
                                                 "Set callback functions."},
     {"SetSignalType",  pvsim_SetSignalType, METH_VARARGS, "Set class Signal."},
     {"Simulate",  pvsim_Simulate, METH_VARARGS, "Run simulation."},
+    {"SimulateAll",  pvsim_SimulateAll, METH_VARARGS,
+                                            pvsim_SimulateAll_docstring},
     {NULL, NULL, 0, NULL}        /* Sentinel */
 };
 
@@ -33,6 +33,11 @@
 #include "Model.h"
 #include "VLCompiler.h"
 #include "PSignal.h"
+#include "Checkpoint.h"
+#include "TestChoices.h"
+#include "Profile.h"
+#include "NativeCode.h"
+#include "DesignCache.h"
 
 // -------- constants --------
 
@@ -95,9 +100,9 @@ void printfEvt(const char* format, ...)
 
     if (!gQuietMode)
     {
-        display("%6.3f: %s", (float)gTick/gTicksNS, msg);
+        display("%6.3f: %s", (double)gTick/gTicksNS, msg);
 #ifdef WRITE_EVENTS
-        fprintf(gEvFile, "%6.3f: %s", (float)gTick/gTicksNS, msg);
+        fprintf(gEvFile, "%6.3f: %s", (double)gTick/gTicksNS, msg);
 #endif
     }
 }
@@ -120,7 +125,7 @@ void freeTempSpace(Space* space)
 {
     if (space->mallocBase != NULL)
     {
-        free(space->mallocBase);
+        heapFree(space->mallocBase);
         space->mallocBase = NULL;
     }
 }
@@ -134,7 +139,7 @@ void allocTempSpace(Space* space, long numElems)
 {
     assert(space->mallocBase == NULL);
     long size = space->elemSize * numElems + 4;
-    char* mallocBase = (char*)malloc(size);
+    char* mallocBase = (char*)heapAlloc(size);
     if (mallocBase == NULL)
         throw new VError(verr_memOverflow,
                         "Out of non-application memory for %s", space->name);
@@ -174,6 +179,18 @@ void handleNewErr()
 }
 
 
+//-----------------------------------------------------------------------------
+// Set up a newly forked test choice worker: its display output only goes to
+//  its own log file, <gProjName>.log.
+
+void startTestWorker()
+{
+    if (gLogFile)
+        fclose(gLogFile);
+    gLogFile = 0;
+    freopen("/dev/null", "w", stdout);
+}
+
 //-----------------------------------------------------------------------------
 // Compile and simulate thread.
 
@@ -203,6 +220,8 @@ void* compileAndSimulate()
             clock_t startRealTime = clock();
             char projFileName[max_nameLen];
             snprintf(projFileName, sizeof(projFileName), "%s.psim", gProjName);
+            if (gTestWorkers)
+                gatherTestChoices(projFileName);
             loadProjectFile(projFileName);
             clock_t compileRealTime = clock() - startRealTime;
             if (!gQuietMode)
@@ -249,6 +268,8 @@ void* compileAndSimulate()
     }
     catch (MainErrorCode errNo)
     {
+        if (errNo == merr_testsDone)        // all test choices have been run
+            exit(gNTestsFailed ? 1 : 0);
         exit(errNo);
     }
     catch (...)
@@ -300,7 +321,8 @@ void initApplication()
 
 void usage()
 {
-    printf("usage: pvsim [ -d<level> -q -t -v ] file.psim\n");
+    printf("usage: pvsim [ -a[N] -c<ns> -d<level> -j<N> -k[dir] -l -m<MB> -n"
+           " -p[N] -q -r<file> -s<ns> -t -v -x[dir] ] file.psim\n");
     exit(-1);
 }
 
@@ -328,14 +350,60 @@ int main(int argc, char* argv[])
                 usage();
             switch(arg[1])
             {
+                case 'a':
+                    gTestWorkers = atoi(arg + 2);
+                    if (gTestWorkers <= 0)
+                        gTestWorkers = defaultTestWorkers();
+                    break;
+
+                case 'c':
+                    gCheckpointNS = atoll(arg + 2);
+                    break;
+
                 case 'd':
                     VL::debugLevel = atoi(arg + 2);
                     break;
 
+                case 'j':
+                    gEvalThreads = atoi(arg + 2);
+                    break;
+
+                case 'k':
+                    gDesignCache = TRUE;
+                    if (arg[2])
+                        strncpy(gCacheDir, arg + 2, max_nameLen-1);
+                    break;
+
+                case 'l':
+                    gLevelize = TRUE;
+                    break;
+
+                case 'm':
+                    gCmdEventMemLimit = (size_t)atol(arg + 2) << 20;
+                    break;
+
+                case 'n':
+                    gOptimizePCode = FALSE;
+                    break;
+
+                case 'p':
+                    gProfile = TRUE;
+                    if (atoi(arg + 2) > 0)
+                        gProfileTopN = atoi(arg + 2);
+                    break;
+
                 case 'q':
                     gQuietMode = TRUE;
                     break;
 
+                case 'r':
+                    strncpy(gRestoreFileName, arg + 2, max_nameLen-1);
+                    break;
+
+                case 's':
+                    gTelemetryNS = atoll(arg + 2);
+                    break;
+
                 case 't':
                     gTagDebug = TRUE;
                     break;
@@ -344,6 +412,12 @@ int main(int argc, char* argv[])
                     printf("%s\n", gPSVersion);
                     return 0;
 
+                case 'x':
+                    gNativeCode = TRUE;
+                    if (arg[2])
+                        strncpy(gNativeDir, arg + 2, max_nameLen-1);
+                    break;
+
                 default:
                     usage();
             }
@@ -378,7 +452,7 @@ int main(int argc, char* argv[])
     initFiles();
 
     std::set_new_handler(handleNewErr);
-    gHashTable = (Symbol**)malloc(max_hashCodes*sizeof(Symbol*));
+    gHashTable = (Symbol**)heapAlloc(max_hashCodes*sizeof(Symbol*));
     if (gHashTable == 0)
     {
         reportErrDialog("can't allocate hash table");
@@ -392,5 +466,7 @@ int main(int argc, char* argv[])
         printf(titleDisclaimer, gPSVersion);
 
     doFirstSimulation();
+    if (isTestWorker())
+        exitTestWorker(FALSE);
     return 0;
 }
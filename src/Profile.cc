@@ -0,0 +1,237 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Activity Profiler
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "Profile.h"
+
+// The counters are bumped in place by the simulator when gProfile is set:
+// addEvent() counts posts, sim1Tick() counts events taken off the wheel,
+// evalSignalCode() counts evaluations (updateDependents() counts those done
+// on -j worker threads), and execCode() reports each model run through
+// profModel(). At the end of simulate(), profReport() lists the busiest
+// signals and models in the log and writes every nonzero count to
+// <project>.profile.json.
+
+const int   def_profileTopN =   20;
+
+// -------- global variables --------
+
+bool    gProfile;               // count activity, from -p or 'profile'
+int     gProfileTopN = def_profileTopN; // signals, models listed in report
+
+SigProfile* gSigProfile;        // each signal's counts, if profiling
+SigProfile* gSigProfileEnd;
+SigProfile* gSigProfileLimit;
+Space   gSigProfileSpace =      // signal profile counts space
+{
+    "signal profile counts",
+    0,
+    &gSigProfile,
+    sizeof(SigProfile),
+    &gSigProfileEnd,
+    &gSigProfileLimit
+};
+
+//-----------------------------------------------------------------------------
+// Start a run's counts at zero, or release them if not profiling.
+
+void profInit(size_t nSignals)
+{
+    freeSpace(&gSigProfileSpace);
+    if (!gProfile)
+        return;
+    allocSpace(&gSigProfileSpace, nSignals);
+    memset(gSigProfile, 0, nSignals * sizeof(SigProfile));
+}
+
+//-----------------------------------------------------------------------------
+// Return the current wall time in seconds, for timing models.
+
+double profSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//-----------------------------------------------------------------------------
+// Add one run of a model's P-code, started at startSeconds, to its counts.
+
+void profModel(Signal* modelSig, size_t nInstructions, double startSeconds)
+{
+    // hand code may run during instantiation, before profInit()
+    if (!gSigProfile || !modelSig ||
+        modelSig->index() >= (size_t)(gSigProfileEnd - gSigProfile))
+        return;
+    SigProfile* prof = gSigProfile + modelSig->index();
+    prof->activations++;
+    prof->instructions += nInstructions;
+    prof->seconds += profSeconds() - startSeconds;
+}
+
+//-----------------------------------------------------------------------------
+// qsort() comparisons of signal numbers: busiest signal first, by events
+//  processed then evaluations, and busiest model first, by time.
+
+static int compareSigActivity(const void* a, const void* b)
+{
+    const SigProfile* pa = gSigProfile + *(const unsigned*)a;
+    const SigProfile* pb = gSigProfile + *(const unsigned*)b;
+    if (pa->processed != pb->processed)
+        return (pa->processed < pb->processed ? 1 : -1);
+    if (pa->evals != pb->evals)
+        return (pa->evals < pb->evals ? 1 : -1);
+    return (*(const unsigned*)a < *(const unsigned*)b ? -1 : 1);
+}
+
+static int compareModelTime(const void* a, const void* b)
+{
+    const SigProfile* pa = gSigProfile + *(const unsigned*)a;
+    const SigProfile* pb = gSigProfile + *(const unsigned*)b;
+    if (pa->seconds != pb->seconds)
+        return (pa->seconds < pb->seconds ? 1 : -1);
+    if (pa->instructions != pb->instructions)
+        return (pa->instructions < pb->instructions ? 1 : -1);
+    return (*(const unsigned*)a < *(const unsigned*)b ? -1 : 1);
+}
+
+//-----------------------------------------------------------------------------
+// Return signal number i's name, or "" if it has none.
+
+static const char* profName(unsigned i)
+{
+    const char* name = gSignals[i].name();
+    return (name ? name : "");
+}
+
+//-----------------------------------------------------------------------------
+// Write a name as a JSON string.
+
+static void writeJSONName(FILE* f, const char* name)
+{
+    fputc('"', f);
+    for (const char* p = name; *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            fputc('\\', f);
+        if ((unsigned char)*p >= ' ')
+            fputc(*p, f);
+    }
+    fputc('"', f);
+}
+
+//-----------------------------------------------------------------------------
+// Report the busiest signals and models, and write all counts to
+//  <project>.profile.json, each list in report order.
+
+void profReport()
+{
+    if (!gProfile || !gSigProfile)
+        return;
+    size_t nSignals = gNextSignal - gSignals;
+    unsigned* sigs = (unsigned*)malloc((nSignals + 1) * sizeof(unsigned));
+    unsigned* models = (unsigned*)malloc((nSignals + 1) * sizeof(unsigned));
+    if (!sigs || !models)
+        throw new VError(verr_memOverflow, "no memory for profile report");
+    size_t nSigs = 0;
+    size_t nModels = 0;
+    size_t totPosted = 0, totProcessed = 0, totEvals = 0;
+    size_t totRuns = 0, totInstructions = 0;
+    double totSeconds = 0.;
+    for (unsigned i = 0; i < nSignals; i++)
+    {
+        SigProfile* prof = gSigProfile + i;
+        if (prof->posted || prof->processed || prof->evals)
+            sigs[nSigs++] = i;
+        if (prof->activations)
+            models[nModels++] = i;
+        totPosted += prof->posted;
+        totProcessed += prof->processed;
+        totEvals += prof->evals;
+        totRuns += prof->activations;
+        totInstructions += prof->instructions;
+        totSeconds += prof->seconds;
+    }
+    qsort(sigs, nSigs, sizeof(unsigned), compareSigActivity);
+    qsort(models, nModels, sizeof(unsigned), compareModelTime);
+
+    size_t nShow = (nSigs < (size_t)gProfileTopN ? nSigs : gProfileTopN);
+    display("\n    profile: %ld events posted, %ld processed, %ld evals\n",
+            (long)totPosted, (long)totProcessed, (long)totEvals);
+    display("     processed     posted      evals  signal\n");
+    for (size_t i = 0; i < nShow; i++)
+    {
+        SigProfile* prof = gSigProfile + sigs[i];
+        display("    %10ld %10ld %10ld  %s\n", (long)prof->processed,
+                (long)prof->posted, (long)prof->evals,
+                profName(sigs[i]));
+    }
+    nShow = (nModels < (size_t)gProfileTopN ? nModels : gProfileTopN);
+    display("\n    profile: %ld model runs, %ld instructions, %3.3f sec\n",
+            (long)totRuns, (long)totInstructions, totSeconds);
+    display("       seconds       runs     instructions  model\n");
+    for (size_t i = 0; i < nShow; i++)
+    {
+        SigProfile* prof = gSigProfile + models[i];
+        display("    %10.6f %10ld %16ld  %s\n", prof->seconds,
+                (long)prof->activations, (long)prof->instructions,
+                profName(models[i]));
+    }
+
+    char fileName[max_nameLen];
+    snprintf(fileName, sizeof(fileName), "%s.profile.json", gProjName);
+    FILE* f = openFile(fileName, "w");
+    fprintf(f, "{\n  \"ticks\": %llu,\n  \"ticksNS\": %d,\n", gTick, gTicksNS);
+    fprintf(f, "  \"signals\": [");
+    for (size_t i = 0; i < nSigs; i++)
+    {
+        SigProfile* prof = gSigProfile + sigs[i];
+        fprintf(f, "%s\n    {\"name\": ", (i ? "," : ""));
+        writeJSONName(f, profName(sigs[i]));
+        fprintf(f, ", \"posted\": %ld, \"processed\": %ld, \"evals\": %ld}",
+                (long)prof->posted, (long)prof->processed, (long)prof->evals);
+    }
+    fprintf(f, "\n  ],\n  \"models\": [");
+    for (size_t i = 0; i < nModels; i++)
+    {
+        SigProfile* prof = gSigProfile + models[i];
+        fprintf(f, "%s\n    {\"name\": ", (i ? "," : ""));
+        writeJSONName(f, profName(models[i]));
+        fprintf(f, ", \"activations\": %ld, \"instructions\": %ld,"
+                " \"seconds\": %.9f}", (long)prof->activations,
+                (long)prof->instructions, prof->seconds);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    closeFile(f);
+    free(sigs);
+    free(models);
+    if (!gQuietMode)
+        display("\n    wrote profile %s.\n", fileName);
+}
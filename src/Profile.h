@@ -0,0 +1,49 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Activity Profiler
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include "Utils.h"
+#include "PSignal.h"
+
+// When profiling, activity is counted per signal. A model's counts are kept
+// with its dummy model signal, so both are reported by signal name.
+
+struct SigProfile
+{
+    size_t      posted;         // events posted to signal
+    size_t      processed;      // events taken off the time wheel
+    size_t      evals;          // evalSignal() calls
+    size_t      activations;    // model's execCode() runs
+    size_t      instructions;   // model's P-code instructions executed
+    double      seconds;        // wall time in model's execCode()
+};
+
+extern bool     gProfile;       // count activity, from -p or 'profile'
+extern int      gProfileTopN;   // signals and models listed in report
+extern SigProfile* gSigProfile; // each signal's counts, if profiling
+
+void profInit(size_t nSignals);
+double profSeconds();
+void profModel(Signal* modelSig, size_t nInstructions, double startSeconds);
+void profReport();
@@ -49,12 +49,214 @@ Space   gSignalSpace =      // signals space
     &signalsLimit
 };
 
+// Each of the per-signal arrays below is allocated alongside gSignals, with
+// the same limit, and is indexed by signal number.
+
+Level*  gSigLevel;          // signal levels array
+Level*  gSigLevelEnd;
+Level*  gSigLevelLimit;
+Space   gSigLevelSpace =    // signal levels space
+{
+    "signal levels",
+    0,
+    &gSigLevel,
+    sizeof(Level),
+    &gSigLevelEnd,
+    &gSigLevelLimit
+};
+
+Level*  gSigNLevel;         // inverted signal levels array
+Level*  gSigNLevelEnd;
+Level*  gSigNLevelLimit;
+Space   gSigNLevelSpace =   // inverted signal levels space
+{
+    "signal inverted levels",
+    0,
+    &gSigNLevel,
+    sizeof(Level),
+    &gSigNLevelEnd,
+    &gSigNLevelLimit
+};
+
+Level*  gSigPreLevel;       // signal pre-delay levels array
+Level*  gSigPreLevelEnd;
+Level*  gSigPreLevelLimit;
+Space   gSigPreLevelSpace = // signal pre-delay levels space
+{
+    "signal pre-delay levels",
+    0,
+    &gSigPreLevel,
+    sizeof(Level),
+    &gSigPreLevelEnd,
+    &gSigPreLevelLimit
+};
+
+Tick*   gSigLastTime;       // signal last event times array
+Tick*   gSigLastTimeEnd;
+Tick*   gSigLastTimeLimit;
+Space   gSigLastTimeSpace = // signal last event times space
+{
+    "signal last times",
+    0,
+    &gSigLastTime,
+    sizeof(Tick),
+    &gSigLastTimeEnd,
+    &gSigLastTimeLimit
+};
+
+SignalInfo* gSigInfo;       // signal names and display info array
+SignalInfo* gSigInfoEnd;
+SignalInfo* gSigInfoLimit;
+Space   gSigInfoSpace =     // signal names and display info space
+{
+    "signal info",
+    0,
+    &gSigInfo,
+    sizeof(SignalInfo),
+    &gSigInfoEnd,
+    &gSigInfoLimit
+};
+
+unsigned* gDependStart;     // each signal's first dependent
+unsigned* gDependStartEnd;
+unsigned* gDependStartLimit;
+Space   gDependStartSpace = // signal dependent starts space
+{
+    "signal dependent starts",
+    0,
+    &gDependStart,
+    sizeof(unsigned),
+    &gDependStartEnd,
+    &gDependStartLimit
+};
+
+unsigned* gInputStart;      // each signal's first input
+unsigned* gInputStartEnd;
+unsigned* gInputStartLimit;
+Space   gInputStartSpace =  // signal input starts space
+{
+    "signal input starts",
+    0,
+    &gInputStart,
+    sizeof(unsigned),
+    &gInputStartEnd,
+    &gInputStartLimit
+};
+
+// Dependency edges are collected here during elaboration, then frozen into
+// the gDepends and gInputs arrays.
+
+SigEdge* gSigEdges;         // dependency edges array
+SigEdge* gSigEdgesEnd;
+SigEdge* gSigEdgesLimit;
+Space   gSigEdgesSpace =    // dependency edges space
+{
+    "signal edges",
+    0,
+    &gSigEdges,
+    sizeof(SigEdge),
+    &gSigEdgesEnd,
+    &gSigEdgesLimit
+};
+
+unsigned* gDepends;         // frozen dependent signal numbers
+unsigned* gDependsEnd;
+unsigned* gDependsLimit;
+Space   gDependsSpace =     // frozen dependents space
+{
+    "signal dependents",
+    0,
+    &gDepends,
+    sizeof(unsigned),
+    &gDependsEnd,
+    &gDependsLimit
+};
+
+unsigned* gInputs;          // frozen input signal numbers
+unsigned* gInputsEnd;
+unsigned* gInputsLimit;
+Space   gInputsSpace =      // frozen inputs space
+{
+    "signal inputs",
+    0,
+    &gInputs,
+    sizeof(unsigned),
+    &gInputsEnd,
+    &gInputsLimit
+};
+
+bool    gDependsFrozen;     // set once edges are frozen into gDepends, etc.
+
+// Each zero-delay assign's output signals are recorded here during
+// elaboration, for levelizeAssigns(). A model's outputs are consecutive.
+
+struct SweepOut
+{
+    unsigned    model;          // assign's model signal number
+    unsigned    out;            // output signal number
+};
+
+SweepOut* gSweepOuts;       // assign outputs array
+SweepOut* gSweepOutsEnd;
+SweepOut* gSweepOutsLimit;
+Space   gSweepOutsSpace =   // assign outputs space
+{
+    "assign outputs",
+    0,
+    &gSweepOuts,
+    sizeof(SweepOut),
+    &gSweepOutsEnd,
+    &gSweepOutsLimit
+};
+
+unsigned* gSweepOrder;      // levelized model signal numbers, in order
+unsigned* gSweepOrderEnd;
+unsigned* gSweepOrderLimit;
+Space   gSweepOrderSpace =  // levelized models space
+{
+    "sweep order",
+    0,
+    &gSweepOrder,
+    sizeof(unsigned),
+    &gSweepOrderEnd,
+    &gSweepOrderLimit
+};
+
+unsigned* gSigSweepPos;     // each signal's sweep position + 1, or 0
+unsigned* gSigSweepPosEnd;
+unsigned* gSigSweepPosLimit;
+Space   gSigSweepPosSpace = // sweep positions space
+{
+    "sweep positions",
+    0,
+    &gSigSweepPos,
+    sizeof(unsigned),
+    &gSigSweepPosEnd,
+    &gSigSweepPosLimit
+};
+
+unsigned* sweepCount;       // per-signal scratch counts for levelizeAssigns
+unsigned* sweepCountEnd;
+unsigned* sweepCountLimit;
+Space   sweepCountSpace =   // scratch counts space
+{
+    "sweep counts",
+    0,
+    &sweepCount,
+    sizeof(unsigned),
+    &sweepCountEnd,
+    &sweepCountLimit
+};
+
+size_t  gNSweepModels;      // number of models in gSweepOrder
+bool    gLevelize;          // sweep zero-delay assigns, from -l or 'levelize'
+
 // -------- global variables --------
 
 short   gNSignals;          // number of signals created
 int     gTicksNS = 1000;    // scaled-time ticks per NS
-int     gNSStart;           // sim start in NS
-int     gNSDuration;        // desired simulation run in NS
+DLong   gNSStart;           // sim start in NS
+DLong   gNSDuration;        // desired simulation run in NS
 Signal* gBreakSignal;
 Signal* gStopSignal;
 bool    gSignalDisplayOn;   // set if following signals to be displayed
@@ -193,11 +395,9 @@ internalName:
             throw new VError(verr_memOverflow,
                                 "too many signals. Enlarge gMaxSignals.");
         sym = newSymbol(name, (size_t)newSignal);
-        newSignal->name = sym->name;
+        newSignal->info()->name = sym->name;
         newSignal->initLevel = initLevel;
         newSignal->floatLevel = LV_X;
-        newSignal->dependList = 0;
-        newSignal->inputsList = 0;
         newSignal->RCminTime = 1;
         newSignal->RCmaxTime = 1;
         newSignal->mode = 0;
@@ -205,9 +405,10 @@ internalName:
         newSignal->randTrkSig = 0;
         if (gDispBusBitNo >= 0)
         {
-            newSignal->busOpt = DISP_BUS_BIT;
-            newSignal->busWidth = gDispBusWidth;
-            newSignal->busBitNo = gDispBusBitNo;
+            SignalInfo* info = newSignal->info();
+            info->busOpt = DISP_BUS_BIT;
+            info->busWidth = gDispBusWidth;
+            info->busBitNo = gDispBusBitNo;
             gDispBusBitNo--;
         }
         gNSignals++;
@@ -233,6 +434,17 @@ void newSignalsS()
     int* endp = (int* )(gSignals + gMaxSignals);
     for (int* p = (int* )gSignals; p < endp; )  // clear signal table
         *p++ = 0;
+    memset(gSigLevel, 0, gMaxSignals * sizeof(Level));
+    memset(gSigNLevel, 0, gMaxSignals * sizeof(Level));
+    memset(gSigPreLevel, 0, gMaxSignals * sizeof(Level));
+    memset(gSigLastTime, 0, gMaxSignals * sizeof(Tick));
+    memset(gSigInfo, 0, gMaxSignals * sizeof(SignalInfo));
+    memset(gDependStart, 0, (gMaxSignals+1) * sizeof(unsigned));
+    memset(gInputStart, 0, (gMaxSignals+1) * sizeof(unsigned));
+    freeSpace(&gSigEdgesSpace);
+    freeSpace(&gSweepOutsSpace);
+    gDependsFrozen = FALSE;
+    gNSweepModels = 0;
     gSignalDisplayOn = FALSE;
     addSignal("__signal0__", LV_L);     // dummy signal #0, used to
                                         //  check for unassigned pins
@@ -255,16 +467,192 @@ void setDependency(Signal* dependent, Signal* signal)
 {
     if (!dependent)
         throw new VError(verr_notFound,
-                "setDependency: missing dependent for %s", signal->name);
+                "setDependency: missing dependent for %s", signal->name());
     if (!signal)
         throw new VError(verr_notFound,
-                "setDependency: missing signal for %s", dependent->name);
-    for (SigNode* dnode = signal->dependList; dnode; dnode = dnode->next())
-        if (dnode->signal() == dependent)
+                "setDependency: missing signal for %s", dependent->name());
+    if (gDependsFrozen)
+        throw new VError(verr_bug,
+                "setDependency: dependencies already frozen, for %s",
+                dependent->name());
+    size_t sigNo = signal->index();
+    size_t depNo = dependent->index();
+    for (unsigned n = gDependStart[sigNo]; n; n = gSigEdges[n-1].prevDepend)
+        if (gSigEdges[n-1].dependent == depNo)
             return;
 
-    signal->dependList    = new SigNode(dependent, signal->dependList);
-    dependent->inputsList = new SigNode(signal, dependent->inputsList);
+    if (gSigEdgesEnd >= gSigEdgesLimit)
+        reAllocSpace(&gSigEdgesSpace, 2 * (gSigEdgesEnd - gSigEdges));
+    SigEdge* edge = gSigEdgesEnd++;
+    edge->signal = sigNo;
+    edge->dependent = depNo;
+    edge->prevDepend = gDependStart[sigNo];
+    edge->prevInput = gInputStart[depNo];
+    gDependStart[sigNo] = gInputStart[depNo] = gSigEdgesEnd - gSigEdges;
+}
+
+//-----------------------------------------------------------------------------
+// Convert the dependency edges collected during elaboration into dense
+//  per-signal runs of dependent and input signal numbers, keeping each run
+//  in newest-first order. Done once, before the first simulation run.
+
+void freezeDependencies()
+{
+    if (gDependsFrozen)
+        return;
+    size_t nSignals = gNextSignal - gSignals;
+    size_t nEdges = gSigEdgesEnd - gSigEdges;
+    allocSpace(&gDependsSpace, nEdges);
+    allocSpace(&gInputsSpace, nEdges);
+
+    // each start entry is replaced by a run offset as its list is copied
+    unsigned* dep = gDepends;
+    unsigned* in = gInputs;
+    for (size_t i = 0; i < nSignals; i++)
+    {
+        unsigned n = gDependStart[i];
+        gDependStart[i] = dep - gDepends;
+        for ( ; n; n = gSigEdges[n-1].prevDepend)
+            *dep++ = gSigEdges[n-1].dependent;
+        n = gInputStart[i];
+        gInputStart[i] = in - gInputs;
+        for ( ; n; n = gSigEdges[n-1].prevInput)
+            *in++ = gSigEdges[n-1].signal;
+    }
+    gDependStart[nSignals] = dep - gDepends;
+    gInputStart[nSignals] = in - gInputs;
+    gDependsEnd = dep;
+    gInputsEnd = in;
+    freeSpace(&gSigEdgesSpace);
+    gDependsFrozen = TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Record that a zero-delay assign, with model signal 'model', drives signal
+//  'out', so that the assign may be levelized.
+
+void setSweepOutput(Signal* model, Signal* out)
+{
+    if (gSweepOutsEnd >= gSweepOutsLimit)
+        reAllocSpace(&gSweepOutsSpace, 2 * (gSweepOutsEnd - gSweepOuts));
+    SweepOut* so = gSweepOutsEnd++;
+    so->model = model->index();
+    so->out = out->index();
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if signal number 'sigNo' is the model signal of a sweep
+//  candidate, and if mustBeReady, one with no unresolved inputs left.
+
+inline bool isSweepModel(unsigned sigNo, bool mustBeReady)
+{
+    return gSigSweepPos[sigNo] && (gSignals[sigNo].is & C_MODEL) &&
+           (!mustBeReady || sweepCount[sigNo] == 0);
+}
+
+//-----------------------------------------------------------------------------
+// Levelize the zero-delay assigns: put those whose outputs feed each other
+//  without a loop into topological order, for the simulator to evaluate
+//  once each per tick in a single sweep. An output that isn't displayed or
+//  traced, and that only triggers other levelized assigns, is set directly
+//  by the sweep with no event. Any others still get events, one tick later
+//  as usual. Must follow freezeDependencies().
+
+void levelizeAssigns()
+{
+    size_t nSignals = gNextSignal - gSignals;
+    for (Signal* sig = gSignals; sig < gNextSignal; sig++)
+        sig->is &= ~(LEVELIZED | SWEPT);
+    gNSweepModels = 0;
+    if (!gLevelize || gSweepOutsEnd == gSweepOuts)
+        return;
+
+    allocSpace(&gSigSweepPosSpace, nSignals);
+    allocSpace(&sweepCountSpace, nSignals);
+    memset(gSigSweepPos, 0, nSignals * sizeof(unsigned));
+    memset(sweepCount, 0, nSignals * sizeof(unsigned));
+
+    // first mark each candidate model with its first output's entry + 1,
+    // and each output with its one driving model + 1, or ~0 if several
+    SweepOut* so;
+    for (so = gSweepOuts; so < gSweepOutsEnd; so++)
+    {
+        if (!gSigSweepPos[so->model])
+            gSigSweepPos[so->model] = so - gSweepOuts + 1;
+        unsigned& driver = sweepCount[so->out];
+        if (!driver)
+            driver = so->model + 1;
+        else if (driver != so->model + 1)
+            driver = ~0u;
+    }
+    // drop models driving a shared, tri-state, or equation-driven output.
+    // (An assign's output signals are its own C-model signals.)
+    for (so = gSweepOuts; so < gSweepOutsEnd; so++)
+    {
+        Signal* out = gSignals + so->out;
+        if (sweepCount[so->out] == ~0u || out->evalCode ||
+            (out->is & (TRI_STATE | REGISTERED)) ||
+            !(out->is & C_MODEL) || out->model != gSignals[so->model].model)
+            gSigSweepPos[so->model] = 0;
+    }
+
+    // count each candidate's inputs from other candidates' outputs
+    memset(sweepCount, 0, nSignals * sizeof(unsigned));
+    SweepOut* end = gSweepOutsEnd;
+    for (so = gSweepOuts; so < end; so++)
+        if (isSweepModel(so->model, FALSE))
+            for (const unsigned* d = gSignals[so->out].dependBegin();
+                 d < gSignals[so->out].dependEnd(); d++)
+                if (isSweepModel(*d, FALSE))
+                    sweepCount[*d]++;
+
+    // then order them, starting with those that have no such inputs
+    allocSpace(&gSweepOrderSpace, end - gSweepOuts);
+    unsigned* order = gSweepOrder;
+    size_t n = 0;
+    for (so = gSweepOuts; so < end; so++)
+        if (gSigSweepPos[so->model] == (unsigned)(so - gSweepOuts + 1) &&
+            isSweepModel(so->model, TRUE))
+            order[n++] = so->model;
+    for (size_t i = 0; i < n; i++)
+    {
+        for (so = gSweepOuts + gSigSweepPos[order[i]] - 1;
+             so < end && so->model == order[i]; so++)
+            for (const unsigned* d = gSignals[so->out].dependBegin();
+                 d < gSignals[so->out].dependEnd(); d++)
+                if (isSweepModel(*d, FALSE) && --sweepCount[*d] == 0)
+                    order[n++] = *d;
+    }
+
+    // an output is set directly if all its dependents are in the sweep
+    for (size_t i = 0; i < n; i++)
+    {
+        for (so = gSweepOuts + gSigSweepPos[order[i]] - 1;
+             so < end && so->model == order[i]; so++)
+        {
+            Signal* out = gSignals + so->out;
+            if ((out->is & (DISPLAYED | TRACED)) || out == gStopSignal ||
+                out == gBreakSignal)
+                continue;
+            const unsigned* d;
+            for (d = out->dependBegin(); d < out->dependEnd(); d++)
+                if (!isSweepModel(*d, TRUE))
+                    break;
+            if (d == out->dependEnd())
+                out->is |= SWEPT;
+        }
+    }
+
+    // models left in a loop aren't levelized
+    memset(gSigSweepPos, 0, nSignals * sizeof(unsigned));
+    for (size_t i = 0; i < n; i++)
+    {
+        gSigSweepPos[order[i]] = i + 1;
+        gSignals[order[i]].is |= LEVELIZED;
+    }
+    gSweepOrderEnd = order + n;
+    gNSweepModels = n;
+    freeSpace(&sweepCountSpace);
 }
 
 //-----------------------------------------------------------------------------
@@ -285,18 +673,21 @@ void initSimulator()
     if (sizeof(Signal) & 7)
         throw new VError(verr_bug,
                     "Signal structure size must be a multiple of 8 bytes");
-#ifdef FULL_DEBUG
-    if ((OFFSET(Signal8, level) & 7) | (OFFSET(Signal8, nlevel) & 7) |
-        (OFFSET(Signal8, preLevel) & 7))
-        throw new VError(verr_bug,
-           "level, nlevel, and preLevel in Signal must be on 8 byte boundries");
-#endif
     if (gMaxSignals & 7)
         throw new VError(verr_bug, "gMaxSignals must be a multiple of 8");
 
     // first clean up any previous signal's linked lists
 
     allocSpace(&gSignalSpace, gMaxSignals);
+    allocSpace(&gSigLevelSpace, gMaxSignals);
+    allocSpace(&gSigNLevelSpace, gMaxSignals);
+    allocSpace(&gSigPreLevelSpace, gMaxSignals);
+    allocSpace(&gSigLastTimeSpace, gMaxSignals);
+    allocSpace(&gSigInfoSpace, gMaxSignals);
+    allocSpace(&gDependStartSpace, gMaxSignals+1);
+    allocSpace(&gInputStartSpace, gMaxSignals+1);
+    allocSpace(&gSigEdgesSpace, 1024);
+    allocSpace(&gSweepOutsSpace, 1024);
 
     gNSignals = 0;
 
@@ -54,8 +54,8 @@ extern Space    gSignalSpace;
 
 extern short    gNSignals;          // number of signals created
 extern int      gTicksNS;           // scaled-time ticks per NS
-extern int      gNSStart;           // sim start in NS
-extern int      gNSDuration;        // desired simulation run in NS
+extern DLong    gNSStart;           // sim start in NS
+extern DLong    gNSDuration;        // desired simulation run in NS
 extern Signal*  gBreakSignal;
 extern Signal*  gStopSignal;
 extern bool     gSignalDisplayOn;   // set if following signals to be displayed
@@ -75,5 +75,8 @@ int hash(const char* s);
 Symbol* lookup(const char* name, bool caseSensitive = FALSE);
 Symbol* newSymbol(const char* name, int arg);
 void setDependency(Signal* dependent, Signal* signal);
+void freezeDependencies();
+void setSweepOutput(Signal* model, Signal* out);
+void levelizeAssigns();
 Signal* addSignal(const char* name, Level initLevel);
 void initSimulator();
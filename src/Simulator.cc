@@ -24,11 +24,17 @@
 #ifdef EXTENSION
 #include <Python.h>
 #endif
+#include <stdlib.h>
 #include <time.h>
 #include "Src.h"
 #include "PSignal.h"
 #include "Utils.h"
 #include "Model.h"
+#include "EventHist.h"
+#include "Checkpoint.h"
+#include "Profile.h"
+#include "NativeCode.h"
+#include "MemPages.h"
 
 // #define RANGE_CHECKING
 #define DEBUG_ADDEVENT
@@ -36,56 +42,109 @@
 
 // -------- global variables --------
 
-size_t  gEventHistLen;      // length of 1/2 time line FIFO
+size_t  gEventHistLen;      // length of event history, in tick bins
 #ifdef WRITE_EVENTS
 FILE*   gEvFile;
 #endif
 OpenFile*   gOpenFiles; // list of open data files
 const char* gLevelNames = "LSXRFUDHZCVW";
 Tick    gTEnd;          // sim & display end tick, adjusted by gStopSignal
-Tick    gTickBinSize = 100; // size of each tick bin
+Tick    gTickBinSize = 100; // size of each event history bin
 
 // -------- storage space pointers --------
 
-size_t  gMaxEvents;
-Event*  events;         // events array
-Event*  lastEvent;
-Event*  eventLimit;
-Space   eventSpace =        // events space
+// Events are allocated from slabs of eventSlabLen events, added to the pool
+// as the free list runs dry, and released at the start of each run. An
+// event's pool index gives its slab and its position there.
+
+EventSlab* gEventSlabs;     // event pool slab table
+EventSlab* gEventSlabsEnd;
+EventSlab* gEventSlabsLimit;
+Space   eventSlabSpace =    // event pool slab table space
 {
-    "events",
+    "event slabs",
     0,
-    &events,
-    sizeof(Event),
-    &lastEvent,
-    &eventLimit
+    &gEventSlabs,
+    sizeof(EventSlab),
+    &gEventSlabsEnd,
+    &gEventSlabsLimit
 };
 
-Event** timeLine;           // time line: array of event lists for each tick
-Event** timeLineEnd;
-Event** timeLineLimit;
-Space   timeLineSpace =     // time line space
+const size_t maxEventSlabs = ((size_t)1 << 32) / eventSlabLen;
+size_t  gMaxEvents;         // number of events in all slabs
+size_t  gEventMemLimit;     // cap on event pool size in bytes, or 0 for none
+size_t  gCmdEventMemLimit;  // cap from -m, the default for each project
+size_t  nFreeEvents;        // number of events on the free list
+
+// Pending events are kept in a hierarchical timing wheel. Level 0 has one
+// slot per tick for the next wheelSlots ticks, and each higher level has one
+// slot per whole rotation of the level below it. Events are placed by their
+// distance from wheelTick, and a higher level's slot is cascaded down when
+// wheelTick enters its block. Events further out than the top level are kept
+// on an unsorted overflow list until they come within its reach.
+//
+// Each slot list holds its events newest first, so that events at the same
+// tick are simulated in the reverse of the order they were posted. Direct
+// posts go on the front of a slot; cascaded events were always posted
+// earlier than any already in their new slot, so they go on the end.
+
+const int wheelBits = 8;
+const int wheelSlots = 1 << wheelBits;
+const int wheelLevels = 4;
+
+typedef unsigned long long OccWord;
+const int occWordBits = 64;
+const int occWords = wheelSlots / occWordBits;
+
+struct WheelSlot
 {
-    "time line",
-    0,
-    &timeLine,
-    sizeof(Event* ),
-    &timeLineEnd,
-    &timeLineLimit
+    EventRef first;
+    Event*  last;
 };
 
-Event** tempTL;         // time line temporary array
-Event** tempTLEnd;
-Event** tempTLLimit;
-Space   tempTLSpace =       // time line temporary array space
+WheelSlot wheel[wheelLevels][wheelSlots];   // timing wheel slot lists
+OccWord wheelOcc[wheelLevels][occWords];    // slot occupancy bitmaps
+Tick    wheelTick;          // wheel's current tick: all before it are done
+EventRef overflowList;      // events beyond the top wheel level, newest first
+Tick    overflowMinTick;    // earliest tick on overflowList
+
+// Simulated events, oldest first, kept as history until they fall more than
+// gEventHistLen bins behind the current tick.
+
+Event*  histFirst;
+Event*  histLast;
+
+// Scheduler telemetry: every gTelemetryNS the state of the event pool and
+// timing wheel is sampled and written as one line of <project>.telemetry,
+// along with the posts, removals and longest signal-list walk by an insert
+// since the previous sample.
+
+DLong   gTelemetryNS;       // ns between samples, from -s or 'telemetry'
+FILE*   telemFile;          // telemetry file, while sampling
+Tick    telemNextTick;      // tick of next sample
+size_t  telemPosts;         // events posted since last sample
+size_t  telemRemoves;       // events removed since last sample
+size_t  telemMaxWalk;       // longest signal list walk since last sample
+int     telemEventCount;    // eventCount at last sample
+
+// Levelized assigns whose inputs changed this tick, by sweep position, to be
+// evaluated by sweepAssigns(). Words outside [sweepLow,sweepHigh) are clear.
+
+OccWord* sweepDirty;        // dirty-model bitmap
+OccWord* sweepDirtyEnd;
+OccWord* sweepDirtyLimit;
+Space   sweepDirtySpace =   // dirty-model bitmap space
 {
-    "time line temp",
+    "sweep bitmap",
     0,
-    &tempTL,
-    sizeof(Event* ),
-    &tempTLEnd,
-    &tempTLLimit
+    &sweepDirty,
+    sizeof(OccWord),
+    &sweepDirtyEnd,
+    &sweepDirtyLimit
 };
+size_t  sweepLow;           // first word that may be non-zero
+size_t  sweepHigh;          // last word that may be non-zero + 1
+bool    sweeping;           // set while sweepAssigns() is evaluating
 
 // -------- function lookup tables --------
 
@@ -295,11 +354,10 @@ bool changedVoltage[12][16] =
 
 Tick    gTick;          // current simulation time
 Tick    gPrevEvtTick;   // previous event file tick
-size_t  timeLineLen;        // length of time line FIFO in ticks
-Tick    timeLineBaseTick;   // first tick of time line FIFO
-Event** timeLineHead;       // head of time line FIFO (at time gTick)
+size_t  timeLineLen;        // length of event history plus pending, in bins
 Event*  freeEventList;      // linked list of free event spaces
 int     eventCount;         // event statistics
+Tick    skippedTickCount;   // idle ticks jumped over by simulate()
 EqnItem* firstCode;         // signal equation code space start
 #ifdef EVENT_HISTORY
 Event*  gCurEvent;
@@ -318,15 +376,62 @@ int     gTimeDispPrec;  // time display precision: number of digits
 const char* gTimeSuffixStr; // time display suffix string
 int     gTimeMinFieldWid; // time display mimimum field width
 
+// The time format left by compiling the design, which $timeformat may change
+// while simulating. Each run of the design starts with it.
+
+struct TimeFormat
+{
+    int         scaleExp;
+    double      scale;
+    int         dispPrec;
+    const char* suffixStr;
+    int         minFieldWid;
+};
+
+TimeFormat designTimeFormat;
+
 int     dummy;
 
 //-----------------------------------------------------------------------------
-// Compute and store offset to signal's field: stored after AND_OP, etc.
+// Mark a levelized assign's model as needing evaluation in this tick's sweep.
+
+inline void markSweep(Signal* modelSig)
+{
+    unsigned pos = gSigSweepPos[modelSig->index()] - 1;
+    size_t word = pos / occWordBits;
+    sweepDirty[word] |= (OccWord)1 << (pos % occWordBits);
+    if (word < sweepLow)
+        sweepLow = word;
+    if (word >= sweepHigh)
+        sweepHigh = word + 1;
+}
+
+//-----------------------------------------------------------------------------
+// Set a net driven by a levelized assign directly during the sweep, without
+//  an event, and mark the assigns it triggers, which all follow in the sweep.
+
+void setSweptLevel(Signal* signal, Level level)
+{
+    if (signal->level() == level)
+        return;
+    signal->lastLevel = signal->level();
+    signal->setLevel(level);
+    signal->setNLevel(funcTable.INVERTtable[level]);
+    if (changedVoltage[level][signal->lastLevel])
+    {
+        signal->setLastTime(gTick);
+        for (const unsigned* dep = signal->dependBegin();
+             dep < signal->dependEnd(); dep++)
+            markSweep(gSignals + *dep);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Store a signal's number, its index into gSigLevel: stored after AND_OP, etc.
 
 inline void codeSigAddr(Signal* sig, EqnItem* &nextCode)
 {
-    (nextCode++)->operand =
-        ((char* )sig - (char* )gSignals + OFFSET(Signal8, level));
+    (nextCode++)->operand = sig->index();
 }
 
 //-----------------------------------------------------------------------------
@@ -356,13 +461,13 @@ void checkEventCollision(Event* evNew, Event* evExist)
                 drawf(errFlag, "#rcoll");
                 display("// *** Error at ");
                 if (gTick/gTicksNS > 1000000) // long run times are in ms
-                    display("%7.6f ms ", ((float)gTick/gTicksNS)/1000000.);
+                    display("%7.6f ms ", ((double)gTick/gTicksNS)/1000000.);
                 else
-                    display("%2.3f ns ", (float)gTick/gTicksNS);
+                    display("%2.3f ns ", (double)gTick/gTicksNS);
                 display(":\n");
                 gErrorTickB -= 2*gTicksNS;
                 display("// ***       signal %s goes both %c and %c!\n",
-                    signal->name, gLevelNames[evExist->level],
+                    signal->name(), gLevelNames[evExist->level],
                     gLevelNames[evNew->level]);
             }
         }
@@ -374,17 +479,9 @@ void checkEventCollision(Event* evNew, Event* evExist)
 // Print warnings and errors outside of addEvent to keep floating point
 // registers out of critical code.
 
-void warnBeyondTimeline(Tick dt, Signal* signal)
-{
-    warnErr("event time for %s at %2.3fns to future %2.3fns exceeds"
-            " %2.3fns timeline!",
-                signal->name, (float)gTick/gTicksNS, 
-                (float)dt/gTicksNS, (float)gEventHistLen/gTicksNS);
-}
-
 void throwWithTime(VErrCode vcode, const char* msg)
 {
-    throw new VError(vcode, "at %2.3f ns: %s", (float)gTick/gTicksNS, msg);
+    throw new VError(vcode, "at %2.3f ns: %s", (double)gTick/gTicksNS, msg);
 }
 
 void showPostEvent(Signal* signal, Level level, char eventType, Tick t2)
@@ -403,7 +500,132 @@ void showPostEvent(Signal* signal, Level level, char eventType, Tick t2)
         default:                        flagStr = "?";
     }
     printfEvt("post Event %12s=%c%s at %2.3f\n",
-        signal->name, gLevelNames[level], flagStr, (float)t2/gTicksNS);
+        signal->name(), gLevelNames[level], flagStr, (double)t2/gTicksNS);
+}
+
+//-----------------------------------------------------------------------------
+// Release all event slabs, leaving an empty pool.
+
+void freeEventPool()
+{
+    for (EventSlab* slab = gEventSlabs; slab < gEventSlabsEnd; slab++)
+    {
+        heapFree(slab->events);
+        heapFree(slab->cold);
+    }
+    freeSpace(&eventSlabSpace);
+    gMaxEvents = 0;
+    freeEventList = 0;
+    nFreeEvents = 0;
+}
+
+//-----------------------------------------------------------------------------
+// The free event list is empty: add another slab of events to the pool, if
+// within the event memory limit.
+
+void growEventPool()
+{
+    size_t slabNo = gEventSlabsEnd - gEventSlabs;
+    if (gEventMemLimit && (gMaxEvents + eventSlabLen) * sizeof(Event) >
+                           gEventMemLimit)
+        throwWithTime(verr_memOverflow,
+                      "event space full: increase event memory limit");
+    if (slabNo >= maxEventSlabs)
+        throwWithTime(verr_memOverflow, "event space full");
+    if (gEventSlabsEnd >= gEventSlabsLimit)
+        reAllocSpace(&eventSlabSpace, slabNo ? 2 * slabNo : 64);
+    Event* events = (Event*)heapAlloc(eventSlabLen * sizeof(Event));
+    if (!events)
+        throwWithTime(verr_memOverflow, "event space full");
+    gEventSlabsEnd->events = events;
+    gEventSlabsEnd->cold = 0;
+    gEventSlabsEnd++;
+    gMaxEvents += eventSlabLen;
+
+    // link slab's events onto the free list (index 0 means no event, so the
+    // first slab's first event is never used)
+    size_t index = slabNo * eventSlabLen;
+    Event* event;
+    for (event = events; event < events+eventSlabLen; event++, index++)
+    {
+        event->index = index;
+        event->is = FREE;
+    }
+    Event* first = (slabNo == 0) ? events+1 : events;
+    for (event = first; event < events+eventSlabLen-1; event++)
+        event->next = event+1;
+    event->next = freeEventList;
+    freeEventList = first;
+    nFreeEvents += events+eventSlabLen - first;
+}
+
+//-----------------------------------------------------------------------------
+// Allocate a slab's side table of rarely used event fields.
+
+void allocEventCold(EventSlab* slab)
+{
+    slab->cold = (EventCold*)heapCalloc(eventSlabLen, sizeof(EventCold));
+    if (!slab->cold)
+        throwWithTime(verr_memOverflow, "event space full");
+}
+
+#ifdef RANGE_CHECKING
+//-----------------------------------------------------------------------------
+// Return TRUE if event points into one of the event pool's slabs.
+
+bool isPoolEvent(Event* event)
+{
+    for (EventSlab* slab = gEventSlabs; slab < gEventSlabsEnd; slab++)
+        if (event >= slab->events && event < slab->events+eventSlabLen)
+            return TRUE;
+    return FALSE;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Put an event into the timing wheel slot for its tick, relative to
+// wheelTick, or onto the overflow list if it is beyond the top level. A newly
+// posted event goes on the front of its slot; an earlier-posted one that is
+// being cascaded down goes on the end.
+
+inline void wheelPlace(Event* event, bool cascading)
+{
+    Tick dist = event->tick - wheelTick;
+    int level = 0;
+    while (dist >= wheelSlots)
+    {
+        dist >>= wheelBits;
+        if (++level == wheelLevels)
+        {
+            if (cascading)      // cascaded events are always within reach
+                throw new VError(verr_bug, "wheelPlace: cascade overflow");
+            if (!overflowList || event->tick < overflowMinTick)
+                overflowMinTick = event->tick;
+            event->next = overflowList;
+            overflowList = event;
+            return;
+        }
+    }
+    int i = (event->tick >> (level * wheelBits)) & (wheelSlots - 1);
+    WheelSlot* slot = &wheel[level][i];
+    if (!slot->first)
+    {
+        event->next = 0;
+        slot->first = event;
+        slot->last = event;
+        wheelOcc[level][i / occWordBits] |= (OccWord)1 << (i % occWordBits);
+    }
+    else if (cascading)
+    {
+        event->next = 0;
+        slot->last->next = event;
+        slot->last = event;
+    }
+    else
+    {
+        event->next = slot->first;
+        slot->first = event;
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -420,10 +642,15 @@ Event* addEvent(    Tick    dt,
     if (signal < gSignals || signal > gNextSignal)
         throw new VError(verr_bug, "BUG: addEvent: bad signal address");
 #endif
+    if (sweeping && (signal->is & SWEPT))
+    {
+        setSweptLevel(signal, level);   // internal levelized net: no event
+        return 0;
+    }
     if (dt <= 1)
     {
         // if level won't change in next tick: ignore this post
-        if (signal->level == level)
+        if (signal->level() == level)
             return 0;
         dt = 1;
     }
@@ -432,90 +659,81 @@ Event* addEvent(    Tick    dt,
     // if similar event just posted: ignore this post
     Event* earlierEv = signal->lastEvtPosted;
 #ifdef RANGE_CHECKING
-    if (earlierEv && (earlierEv < events || earlierEv >= events+gMaxEvents))
+    if (earlierEv && !isPoolEvent(earlierEv))
         throwWithTime(verr_bug, "BUG: addEvent: bad earlierEv pointer");
 #endif
     if (earlierEv && earlierEv->tick == t2 && earlierEv->level == level)
         return 0;
 
-    if (dt >= (Tick)gEventHistLen)      // don't add event if past timeline tail
-    {
-        warnBeyondTimeline(dt, signal);
-        dt = gEventHistLen - 1;
-        t2 = gTick + dt;
-    }
-
-    Tick t2EventListBin = (gTick - timeLineBaseTick + dt) / gTickBinSize;
-    if (t2EventListBin >= timeLineLen)
-        t2EventListBin -= timeLineLen;
-    Event** t2EventList = timeLine + t2EventListBin;
-
     if (signal->is & TRACED)
         showPostEvent(signal, level, eventType, t2);
+    if (gProfile)
+        gSigProfile[signal->index()].posted++;
 
+    if (freeEventList == 0)
+        growEventPool();
     Event* event = freeEventList;
     //display("      e=0x%p\n", event);
-    if (event == 0)
-        throwWithTime(verr_memOverflow, "event space full");
 #ifdef DEBUG_ADDEVENT
     if (!(event->is & FREE))
         throwWithTime(verr_bug,
                       "BUG: addEvent: non-free event on freeEventList");
 #ifdef RANGE_CHECKING
-    if (event < events || event >= events+gMaxEvents)
+    if (!isPoolEvent(event))
         throwWithTime(verr_bug,
                       "BUG: addEvent: bad event pointer from freeEventList");
 #endif
 #endif
     freeEventList = event->next;
+    nFreeEvents--;
+    telemPosts++;
     event->signal = signal;    // post event for changing signal level
     event->nextInSignal = 0;
     event->prevInSignal = 0;
-    event->nextFloat = 0;
     event->level = level;
     event->is = eventType;
     if (eventType & FLOATING)
     {
-        event->nextFloat = signal->floatList;
+        event->setNextFloat(signal->floatList);
         signal->floatList = event;
     }
+    else
+        event->clearNextFloat();
     event->tick = t2;
 #ifdef EVENT_HISTORY
-    event->cause = gCurEvent;
+    if (signal->is & TRACED)            // (cause is only shown when tracing)
+        event->setCause(gCurEvent);
 #endif
 
-    // insert event in timeLine at t2, keeping events in bin chronological
-    Event** link = t2EventList;
-    Event* e = *link;
-    while (e && e->tick < t2)
-    {
-        link = &e->next;
-        e = *link;
-    }
-    *link = event;
-    event->next = e;
+    wheelPlace(event, FALSE);           // schedule event in timing wheel
 
     if (!((signal->is & C_MODEL) && (signal->is & REGISTERED)))
                                     // add event to signal's event list
     {                               // (if not a model's event-handler signal)
         // insert new event into signal's list after time t2
         Event* earlierEv = signal->lastEvtPosted;
+        size_t walk = 0;
         while (earlierEv && earlierEv->tick > t2)
+        {
             earlierEv = earlierEv->prevInSignal;
+            walk++;
+        }
+        if (walk > telemMaxWalk)
+            telemMaxWalk = walk;
         if (earlierEv && earlierEv->tick == t2)
             checkEventCollision(event, earlierEv);
 #ifdef DEBUG_ADDEVENT
         if (signal->firstDispEvt && signal->firstDispEvt->signal != signal)
             throw new VError(verr_bug,
                     "addEvent: BUG: firstDispEv not for same signal (%s)",
-                signal->name);
+                signal->name());
 #endif
         event->insertS(signal, earlierEv);
 #ifdef DEBUG_ADDEVENT
         if (event->signal->firstDispEvt->signal != signal)
             throw new VError(verr_bug,
                     "addEvent: BUG: firstDispEv not for same signal (%s)",
-                signal->name);
+                signal->name());
 #endif
     }
 
@@ -524,7 +742,7 @@ Event* addEvent(    Tick    dt,
         dummy = 1;
 #endif
     if (!(eventType & ATTACHED_TEXT))
-        signal->preLevel = level;   // keep preLevel up-to-date in case this
+        signal->setPreLevel(level);   // keep preLevel up-to-date in case this
                               // signal is also being driven by addMinMaxEvent
     return (event);
 }
@@ -571,8 +789,8 @@ void addMinMaxEvent(Tick    dtMin,
         {
             if (signal->floatLevel == LV_V)     // pulldowns ignore
                 return;
-            if (signal->level != signal->floatLevel &&
-                signal->level != LV_H)
+            if (signal->level() != signal->floatLevel &&
+                signal->level() != LV_H)
             {
                                                 // disabling after pullup time
                 if (signal->floatLevel == LV_W)
@@ -590,8 +808,8 @@ void addMinMaxEvent(Tick    dtMin,
         {
             if (signal->floatLevel == LV_W)     // pullups ignore
                 return;
-            if (signal->level != signal->floatLevel &&
-                signal->level != LV_L)
+            if (signal->level() != signal->floatLevel &&
+                signal->level() != LV_L)
             {
                                                // disabling after pulldown time
                 if (signal->floatLevel == LV_V)
@@ -615,12 +833,12 @@ void addMinMaxEvent(Tick    dtMin,
     // If this new level is really new,
     // post an event of changing to the new level
 
-    if ((func->BSWALLOWtable[level] != signal->preLevel) &&
-                            (level != signal->preLevel))
+    if ((func->BSWALLOWtable[level] != signal->preLevel()) &&
+                            (level != signal->preLevel()))
     {                           // (BSWALLOW makes weak-high match high, etc.)
         // check if new level is going into or out of an ambiguous level
         char ambType;
-        if (func->STABLEtable[signal->preLevel] == LV_H)
+        if (func->STABLEtable[signal->preLevel()] == LV_H)
         {
             if (func->STABLEtable[level] == LV_H)
                 ambType = CLEAN;
@@ -636,7 +854,7 @@ void addMinMaxEvent(Tick    dtMin,
         }
 
         // edge has ambiguity: post starting and ending events
-        Level ambLevel = (Level)func->MINMAXtable[level][signal->preLevel];
+        Level ambLevel = (Level)func->MINMAXtable[level][signal->preLevel()];
 
         if (ambType != ENDING_AMBIG)            // start of ambiguity
             addEvent(dtMin, signal, ambLevel, STARTING_AMBIG + eventType);
@@ -647,7 +865,7 @@ void addMinMaxEvent(Tick    dtMin,
     // save current level for successive tests
     // unless setup or hold violated on previous edge, expect a late meta event
     if (!(signal->mode & MODE_WENT_META))
-        signal->preLevel = level;
+        signal->setPreLevel(level);
 }
 
 //-----------------------------------------------------------------------------
@@ -662,8 +880,8 @@ void attachSignalText(Signal* signal, char* s, bool inFront, int ticksAllotted)
         {
             if (event->tick == gTick + 1)
             {                       // if already an event at this time
-                strncpy(event->attText, s, MAX_ATT_TEXT_LEN-1);
-                *(event->attText + MAX_ATT_TEXT_LEN-1) = 0;
+                strncpy(event->attText(), s, MAX_ATT_TEXT_LEN-1);
+                *(event->attText() + MAX_ATT_TEXT_LEN-1) = 0;
                 return;
             }
             else if (event->tick > gTick - ticksAllotted)
@@ -673,8 +891,8 @@ void attachSignalText(Signal* signal, char* s, bool inFront, int ticksAllotted)
     event = addEvent(2, signal, level(inFront), ATTACHED_TEXT);
     if (event)
     {
-        strncpy(event->attText, s, MAX_ATT_TEXT_LEN-1);
-        *(event->attText + MAX_ATT_TEXT_LEN-1) = 0;
+        strncpy(event->attText(), s, MAX_ATT_TEXT_LEN-1);
+        *(event->attText() + MAX_ATT_TEXT_LEN-1) = 0;
     }
 }
 
@@ -686,9 +904,10 @@ void codeATSSig(Signal* tsSig, Signal* otherSideTG)
     EqnItem* nextCode = (EqnItem* )gDP; // prepare to code a tri-state signal
     bool startedTS = FALSE;
                                   // code each source input to tri-state signal
-    for (SigNode* node = tsSig->inputsList; node; node = node->next())
+    const unsigned* inEnd = tsSig->inputEnd();
+    for (const unsigned* in = tsSig->inputBegin(); in < inEnd; in++)
     {
-        Signal* input = node->signal();
+        Signal* input = gSignals + *in;
         if (!startedTS && (input->enable))
         {
             gDP = (char* )nextCode;
@@ -749,6 +968,15 @@ void initSignals()
     if (!gQuietMode)
         display("    initializing...\n");
     clock_t startRealTime = clock();
+    freezeDependencies();
+    levelizeAssigns();
+    allocSpace(&sweepDirtySpace, gNSweepModels / occWordBits + 1);
+    memset(sweepDirty, 0, (gNSweepModels / occWordBits + 1) * sizeof(OccWord));
+    sweepLow = ~(size_t)0;
+    sweepHigh = 0;
+    sweeping = FALSE;
+    if (gNSweepModels && !gQuietMode)
+        display("    levelized %ld assigns.\n", (long)gNSweepModels);
 
     // Create code for each tri-state signal
     for (Signal* signal = gSignals; signal < gNextSignal; signal++)
@@ -756,44 +984,43 @@ void initSignals()
         if (signal->is & TRI_STATE)
             codeATSSig(signal, 0);              // code a regular TS signal
     }
-    freeTempSpace(&eventSpace);
+    loadNativeEqns();
+    freeEventPool();
+
+    // size the event history so that it and the pending events would about
+    // fill the event pool memory limit, or 1 GB if none
     size_t signalFactor = (gNextSignal - gSignals) / 1000 + 1;
     int minEvents = 70000;
-    size_t spaceForEvents = 1000000000;
+    size_t spaceForEvents = gEventMemLimit ? gEventMemLimit : 1000000000;
+    if (spaceForEvents/sizeof(Event) < 2 * (size_t)minEvents)
+        spaceForEvents = 2 * minEvents * sizeof(Event);
     timeLineLen = (spaceForEvents/sizeof(Event) - minEvents) /
-                  signalFactor + 500000;
+                  signalFactor + 500000 * spaceForEvents / 1000000000;
     if (timeLineLen < 2000)
         timeLineLen = 2000;
     timeLineLen = timeLineLen / 1000 * 1000;
-    gMaxEvents = timeLineLen * signalFactor + minEvents;
-    allocTempSpace(&eventSpace, gMaxEvents);
-    allocSpace(&timeLineSpace, timeLineLen);
     if (!gQuietMode)
     {
-        display("    Allocated space for %ld events.\n",
-                                        spaceForEvents/sizeof(Event));
-        display("    Allocated %ld tick timeline.\n", (long)timeLineLen);
-        display("    gMaxEvents=%ld.\n", (long)gMaxEvents);
+        if (gEventMemLimit)
+            display("    Event space limited to %ld MB.\n",
+                                        (long)(gEventMemLimit >> 20));
+        display("    Allocated %ld bin event history.\n",
+                                        (long)(timeLineLen >> 1));
     }
-    // time line FIFO is 1/2 event history and 1/2 pending events
+    // 1/2 event history and 1/2 pending events
     gEventHistLen = timeLineLen >> 1;
-    timeLineEnd = timeLine + timeLineLen;
     gTick = 0;
     gPrevEvtTick = -1;
-    timeLineBaseTick = 0;
-    timeLineHead = timeLine;
 
-    for (int* p = (int* )timeLine; p < (int* )(timeLineEnd); )
-        *p++ = 0;
-    Event* event;
-    for (event = events; event < events+gMaxEvents-1; event++)
-    {
-        event->next = event+1;
-        event->is = FREE;
-    }
-    event->next = 0;
-    event->is = FREE;
-    freeEventList = events;
+    memset(wheel, 0, sizeof(wheel));
+    memset(wheelOcc, 0, sizeof(wheelOcc));
+    wheelTick = 0;
+    overflowList = 0;
+    overflowMinTick = 0;
+    histFirst = 0;
+    histLast = 0;
+    histInit(gNextSignal - gSignals);
+    profInit(gNextSignal - gSignals);
 
 #ifdef WRITE_EVENTS
     // write event file header
@@ -810,12 +1037,12 @@ void initSignals()
     for (signal = gSignals; signal < gNextSignal; signal++)
     {
         Level newLevel = signal->initLevel;
-        signal->level = newLevel;
-        signal->nlevel = funcTable.INVERTtable[newLevel];
+        signal->setLevel(newLevel);
+        signal->setNLevel(funcTable.INVERTtable[newLevel]);
         signal->inLevel = newLevel;
-        signal->preLevel = newLevel;
+        signal->setPreLevel(newLevel);
         signal->initDspLevel = newLevel;
-        signal->lastTime = -1000;
+        signal->setLastTime(-1000);
         signal->lastInTime = -1000;
         signal->lastClkTm = -1000;
         signal->ambDepth = 0;
@@ -827,19 +1054,19 @@ void initSignals()
         signal->is |= TRACED;   // to look at all events
 #endif
         if (debugLevel(3))
-            display("new signal %s: %s%s\n", signal->name,
+            display("new signal %s: %s%s\n", signal->name(),
                 signal->is & DISPLAYED ? "D":"",
-                signal->busOpt & DISP_BUS ? "B":"");
+                signal->info()->busOpt & DISP_BUS ? "B":"");
 
         if (signal->is & DISPLAYED)
         {
-            if (signal->busOpt & DISP_BUS)
+            if (signal->info()->busOpt & DISP_BUS)
             {
 #ifndef WRITE_EVENTS
                 // create a display-bus Signal with its file location.
                 newSignalPy(signal, newLevel, TRUE,
-                (signal+1)->busBitNo,
-                (signal+(signal->busWidth)-1)->busBitNo);
+                (signal+1)->info()->busBitNo,
+                (signal+(signal->info()->busWidth)-1)->info()->busBitNo);
 #endif
             }
             else
@@ -850,22 +1077,22 @@ void initSignals()
                 if (!(signal->is & REGISTERED))
                 {
 #ifdef WRITE_EVENTS
-                    Token* srcLoc = signal->srcLoc;
+                    Token* srcLoc = signal->info()->srcLoc;
                     if (srcLoc && srcLoc->tokCode == NAME_TOKEN)
                     {
                         // write signal with its file location
                         fprintf(gEvFile, "Signal %d=%c: %s %s %ld (%s)\n",
                           (int)(signal - gSignals), gLevelNames[newLevel],
-                          signal->name, srcLoc->src->fileName,
+                          signal->name(), srcLoc->src->fileName,
                           (long)(srcLoc->pos - srcLoc->src->base),
-                          signal->srcLocObjName);
+                          signal->info()->srcLocObjName);
                     }
                     else
                     {
                         // no known location
                         fprintf(gEvFile, "Signal %d=%c: %s - 0\n",
                           (int)(signal - gSignals), gLevelNames[newLevel],
-                          signal->name);
+                          signal->name());
                     }
 #else
                     // create a Signal with its file location.
@@ -884,7 +1111,7 @@ void initSignals()
 
     for (signal = gSignals; signal < gNextSignal; signal++)
     {
-        if (!(signal->is & C_MODEL || signal->busOpt & DISP_BUS) &&
+        if (!(signal->is & C_MODEL || signal->info()->busOpt & DISP_BUS) &&
             !((signal->is & TRI_STATE) && signal->floatLevel != LV_X))
         {
             Level newLevel = evalSignal(signal);
@@ -902,7 +1129,7 @@ void initSignals()
 #endif
             else
             {
-                signal->preLevel = newLevel;
+                signal->setPreLevel(newLevel);
                 char ambType;
                 if (funcTable.STABLEtable[newLevel] == LV_H)
                     ambType = CLEAN;
@@ -918,7 +1145,7 @@ void initSignals()
     Model::initVars();
     clock_t initRealTime = clock() - startRealTime;
     if (!gQuietMode)
-        display("      [%3.1f sec]\n", (float)initRealTime/CLOCKS_PER_SEC);
+        display("      [%5.3f sec]\n", (float)initRealTime/CLOCKS_PER_SEC);
 }
 
 //-----------------------------------------------------------------------------
@@ -929,8 +1156,22 @@ void newSimulation()
     Model::removeAll();
     SimObject::deleteAll();     // recover all memory allocated by 'new'
     freeBlocks();
-    freeTempSpace(&eventSpace);
-    freeSpace(&timeLineSpace);
+    freeEventPool();
+    histFree();
+    freeAllMemPages();
+    ckptClearRegions();
+}
+
+//-----------------------------------------------------------------------------
+// Save the time format once the design is compiled.
+
+void saveTimeFormat()
+{
+    designTimeFormat.scaleExp = gTimeScaleExp;
+    designTimeFormat.scale = gTimeScale;
+    designTimeFormat.dispPrec = gTimeDispPrec;
+    designTimeFormat.suffixStr = gTimeSuffixStr;
+    designTimeFormat.minFieldWid = gTimeMinFieldWid;
 }
 
 //-----------------------------------------------------------------------------
@@ -949,19 +1190,20 @@ void updateDependents(Signal* signal)
             gTEnd = newTEnd;
     }
     bool signalChangedVoltage =
-                    changedVoltage[signal->level][signal->lastLevel];
+                    changedVoltage[signal->level()][signal->lastLevel];
     const FuncTable* func = &funcTable;
 
-    // Go through signal's dependents list and possibly change each dependent
+    // Go through signal's dependents list and possibly change each dependent,
+    // using their equations' levels if already evaluated in parallel
 
-    for (SigNode* node = signal->dependList; node; node = node->next())
+    signed char* preEval = evalDependents(signal);
+    const unsigned* depBegin = signal->dependBegin();
+    const unsigned* depEnd = signal->dependEnd();
+    for (const unsigned* dep = depBegin; dep < depEnd; dep++)
     {
-        Signal* dependent = node->signal();
-        if (!dependent)
-            throw new VError(verr_bug, "BUG: missing dependent for %s",
-                             signal->name);
-        int minTime = dependent->minTime;
-        int maxTime = dependent->maxTime;
+        Signal* dependent = gSignals + *dep;
+        Tick minTime = dependent->minTime;
+        Tick maxTime = dependent->maxTime;
         bool goneMeta = FALSE;
         bool fuzzyClkSetupViolation = FALSE;
         Level newLevel;
@@ -977,9 +1219,14 @@ void updateDependents(Signal* signal)
         {
             if (signalChangedVoltage)
             {
+                if (dependent->is & LEVELIZED)
+                {
+                    markSweep(dependent);   // evaluate in this tick's sweep
+                    goto next;
+                }
                 Model* model = dependent->model;
                 if (!model)
-                    warnErr("Signal %s missing model!", dependent->name);
+                    warnErr("Signal %s missing model!", dependent->name());
                 else
                 {
                     Model::setLastName(model->designator());
@@ -998,24 +1245,25 @@ void updateDependents(Signal* signal)
             if (dependent->clock == signal)
             {                                // if dependent's clock changed
                 if (dependent->clockEn &&
-                    func->BSWALLOWtable[dependent->clockEn->level] != LV_H)
+                    func->BSWALLOWtable[dependent->clockEn->level()] != LV_H)
                     goto next;               // and clock enabled
-                if (func->BSWALLOWtable[signal->level] != dependent->clockPol)
+                if (func->BSWALLOWtable[signal->level()] !=
+                                                        dependent->clockPol)
                     goto next;              // if active edge of clock
                 if (dependent->reset &&
-                    func->BSWALLOWtable[dependent->reset->level] == LV_H)
+                    func->BSWALLOWtable[dependent->reset->level()] == LV_H)
                     goto next;               // and output isn't being reset
                 if (dependent->set &&
-                    func->BSWALLOWtable[dependent->set->level] == LV_H)
+                    func->BSWALLOWtable[dependent->set->level()] == LV_H)
                     goto next;               // and output isn't being set
                 dependent->lastClkTm = gTick;
-                if ((int)(gTick - dependent->lastInTime) <
-                    dependent->setupTime ||
+                if ((DLong)(gTick - dependent->lastInTime) <
+                    (DLong)dependent->setupTime ||
                     func->STABLEtable[dependent->inLevel] != LV_H)
                 {
                     goneMeta = TRUE;       // go metastable if setup not met
                     fuzzyClkSetupViolation =
-                            (signal->level != dependent->clockPol);
+                            (signal->level() != dependent->clockPol);
                     newLevel = LV_S;
                     maxTime += dependent->metaTime;
                 }
@@ -1023,41 +1271,50 @@ void updateDependents(Signal* signal)
                 {
                     newLevel = dependent->inLevel;
                     if (newLevel == dependent->clockPol)
-                        newLevel = signal->level;
+                        newLevel = signal->level();
                     else if (newLevel ==
                             func->INVERTtable[dependent->clockPol])
-                        newLevel = (Level)func->INVERTtable[signal->level];
-                    else if (signal->level == dependent->clockPol)
+                        newLevel = (Level)func->INVERTtable[signal->level()];
+                    else if (signal->level() == dependent->clockPol)
                         newLevel = LV_S;
                     else
                         newLevel = LV_X;
                 }
                 if (dependent->is & TRACED)
                     printfEvt("(clocked: %12s=%c by %s)\n",
-                      dependent->name, gLevelNames[newLevel], signal->name);
+                      dependent->name(), gLevelNames[newLevel],
+                      signal->name());
             }
             else                            // re-evaluate dependent's input
             {
-
-                newLevel = evalSignal(dependent);
+                if (preEval && preEval[dep - depBegin] >= 0)
+                {
+                    newLevel = (Level)preEval[dep - depBegin];
+                    if (gProfile)
+                        gSigProfile[dependent->index()].evals++;
+                }
+                else
+                    newLevel = evalSignal(dependent);
 
                 if (dependent->set == signal &&
-                    func->BSWALLOWtable[dependent->set->level] == LV_H)
+                    func->BSWALLOWtable[dependent->set->level()] == LV_H)
                 {
                                                // if dependent's set occured
                     dependent->inLevel = newLevel;
                     if (dependent->is & TRACED)
                         printfEvt("(set    : %12s=%c by %s)\n",
-                          dependent->name, gLevelNames[newLevel], signal->name);
+                          dependent->name(), gLevelNames[newLevel],
+                          signal->name());
                 }
                 else if (dependent->reset == signal &&
-                    func->BSWALLOWtable[dependent->reset->level] == LV_H)
+                    func->BSWALLOWtable[dependent->reset->level()] == LV_H)
                 {
                                              // if dependent's reset occured
                     dependent->inLevel = newLevel;
                     if (dependent->is & TRACED)
                         printfEvt("(reset  : %12s=%c by %s)\n",
-                          dependent->name, gLevelNames[newLevel], signal->name);
+                          dependent->name(), gLevelNames[newLevel],
+                          signal->name());
                 }
                 else
                 {                               // input to register changed
@@ -1065,10 +1322,12 @@ void updateDependents(Signal* signal)
                         goto next;
                     if (dependent->is & TRACED)
                         printfEvt("(inp chg: %12s=%c by %s)\n",
-                          dependent->name, gLevelNames[newLevel], signal->name);
+                          dependent->name(), gLevelNames[newLevel],
+                          signal->name());
                     dependent->lastInTime = gTick;
                     dependent->inLevel = newLevel;          // input changed
-                    if ((int)(gTick - dependent->lastClkTm) >= dependent->holdTime)
+                    if ((DLong)(gTick - dependent->lastClkTm) >=
+                        (DLong)dependent->holdTime)
                         goto next;
 
                     goneMeta = TRUE;        // go metastable if hold not met
@@ -1080,6 +1339,12 @@ void updateDependents(Signal* signal)
 
         // else (not reg'ed), it's a combinatorial input: determine new level
 
+        else if (preEval && preEval[dep - depBegin] >= 0)
+        {
+            newLevel = (Level)preEval[dep - depBegin];
+            if (gProfile)                   // evaluated on a worker thread
+                gSigProfile[dependent->index()].evals++;
+        }
         else
             newLevel = evalSignal(dependent);
 
@@ -1107,8 +1372,8 @@ void updateDependents(Signal* signal)
             {
                 if (dependent->floatLevel == LV_V)       // pulldowns ignore
                     goto next;
-                if (dependent->level != dependent->floatLevel &&
-                    dependent->level != LV_H)
+                if (dependent->level() != dependent->floatLevel &&
+                    dependent->level() != LV_H)
                 {
                                               // disabling after pullup time
                     if (dependent->floatLevel == LV_W)
@@ -1126,8 +1391,8 @@ void updateDependents(Signal* signal)
             {
                 if (dependent->floatLevel == LV_W)         // pullups ignore
                     goto next;
-                if (dependent->level != dependent->floatLevel &&
-                    dependent->level != LV_L)
+                if (dependent->level() != dependent->floatLevel &&
+                    dependent->level() != LV_L)
                 {
                                             // disabling after pulldown time
                     if (dependent->floatLevel == LV_V)
@@ -1151,13 +1416,13 @@ void updateDependents(Signal* signal)
         // If this new level is really new,
         // post an event of changing to the new level
 
-        if ((func->BSWALLOWtable[newLevel] != dependent->preLevel) &&
-                                (newLevel != dependent->preLevel))
+        if ((func->BSWALLOWtable[newLevel] != dependent->preLevel()) &&
+                                (newLevel != dependent->preLevel()))
         {                      // (BSWALLOW makes weak-high match high, etc.)
 
             // check if new level is going into or out of an ambiguous level
             char ambType;
-            if (func->STABLEtable[dependent->preLevel] == LV_H)
+            if (func->STABLEtable[dependent->preLevel()] == LV_H)
             {
                 if (func->STABLEtable[newLevel] == LV_H)
                     ambType = CLEAN;
@@ -1195,7 +1460,7 @@ void updateDependents(Signal* signal)
             else
             {
                 Level ambLevel =
-                       (Level)func->MINMAXtable[newLevel][dependent->preLevel];
+                    (Level)func->MINMAXtable[newLevel][dependent->preLevel()];
 
                 if (ambType != ENDING_AMBIG)            // start of ambiguity
                     addEvent(minTime, dependent, ambLevel,
@@ -1215,13 +1480,13 @@ void updateDependents(Signal* signal)
 
             if (goneMeta)
             {
-                dependent->preLevel = metaVal;
+                dependent->setPreLevel(metaVal);
                 if (fuzzyClkSetupViolation)
                     dependent->mode |= MODE_WENT_META;
             }
             // if setup or hold violated on prev edge, expect a late meta event
             else if (!(dependent->mode & MODE_WENT_META))
-                dependent->preLevel = newLevel;
+                dependent->setPreLevel(newLevel);
         }
 
     next:
@@ -1252,7 +1517,7 @@ void checkSignalEvents(Signal* signal)
 //-----------------------------------------------------------------------------
 // Remove an event from the event pool and clean up its signal's links.
 
-void removeEvent(Event** link, Event* event)
+void removeEvent(EventRef* link, Event* event)
 {
     if (event->is & FREE)
         return;
@@ -1268,43 +1533,73 @@ void removeEvent(Event** link, Event* event)
         event->removeFromSignal();
         if (signal->is & TRACED)
             printfEvt("rmEvent: %s E=%08x S=%08x S.F=%08x amb=%d\n",
-                signal->name, (size_t)event,
+                signal->name(), (size_t)event,
                 (size_t)signal, (size_t)signal->firstDispEvt, signal->ambDepth);
 #ifdef CHECK_SIGNAL_EVENTS
                 checkSignalEvents(signal);
 #endif
     }
     if (link)
+    {
         *link = event->next;
+        telemRemoves++;
+    }
     event->next = freeEventList;
     freeEventList = event;
     event->is |= FREE;
+    nFreeEvents++;
+}
+
+//-----------------------------------------------------------------------------
+// Evaluate each levelized assign marked this tick, once, in sweep order.
+//  Marking only sets later positions, so one pass over the bitmap does.
+
+void sweepAssigns()
+{
+    sweeping = TRUE;
+    for (size_t word = sweepLow; word < sweepHigh; word++)
+    {
+        while (sweepDirty[word])
+        {
+            size_t pos = word * occWordBits +
+                         __builtin_ctzll(sweepDirty[word]);
+            sweepDirty[word] &= sweepDirty[word] - 1;
+            Model* model = gSignals[gSweepOrder[pos]].model;
+            Model::setLastName(model->designator());
+            model->eval((Signal*)0);
+        }
+    }
+    sweepLow = ~(size_t)0;
+    sweepHigh = 0;
+    sweeping = FALSE;
 }
 
 //-----------------------------------------------------------------------------
 // Run the simulation for one tick.
 
-void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
+void sim1Tick(EventRef* tickEventLink, Event* lastTickEvent)
 {
     // update all changed-signal levels at current time
-    Event** link = tickEventLink;
+    EventRef* link = tickEventLink;
     Event* event;
     for (event = *link; event != lastTickEvent; event = *link)
     {
         Signal* signal = event->signal;
+        if (gProfile)
+            gSigProfile[signal->index()].processed++;
 #if 1
         if (signal->is & TRACED)
             printfEvt("Event 0x%08x: %12s=%c at %2.3f nx=0x%08x\n",
-                  (size_t)event, signal->name,
-                  gLevelNames[event->level], (float)event->tick/gTicksNS,
-                  (size_t)event->next);
+                  (size_t)event, signal->name(),
+                  gLevelNames[event->level], (double)event->tick/gTicksNS,
+                  (size_t)(Event*)event->next);
 #ifdef WRITE_EVENTS
         //if (!signal->model)   // (no: kills wire events)
         if (signal->is & DISPLAYED)
         {
             if (gPrevEvtTick != gTick)
             {
-                fprintf(gEvFile, "\n%ld:", gTick);
+                fprintf(gEvFile, "\n%llu:", gTick);
                 gPrevEvtTick = gTick;
             }
             fprintf(gEvFile, " %d=%c",
@@ -1312,7 +1607,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
         }
         if (event->is & ATTACHED_TEXT)
         {
-            fprintf(gEvFile, "\"%s\"", event->attText);
+            fprintf(gEvFile, "\"%s\"", event->attText());
         }
 #else
         // Python-extension version: add event to signal's list
@@ -1324,7 +1619,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
         if (event->is & ATTACHED_TEXT)
         {
             PyObject* val = Py_BuildValue("(cs)",
-                gLevelNames[event->level], event->attText);
+                gLevelNames[event->level], event->attText());
             addEventPy(signal, gTick, val);
         }
 #endif
@@ -1344,7 +1639,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
         }
         char ambiguity = event->is & SOME_AMBIG;
 #ifdef RANGE_CHECKING
-        if (event < events || event >= events+gMaxEvents)
+        if (!isPoolEvent(event))
             throw new VError(verr_bug,
                              "simulate: bad event pointer, updating %s",
                              signal->name);
@@ -1366,10 +1661,10 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
                     signal->floatList = 0;
                 else
                     for (event = signal->floatList; event;
-                                      event = event->nextFloat)
-                        if (event->nextFloat == currentEvent)
+                                      event = event->nextFloat())
+                        if (event->nextFloat() == currentEvent)
                         {
-                            event->nextFloat = event->nextFloat->nextFloat;
+                            event->setNextFloat(currentEvent->nextFloat());
                             break;
                         }
 #ifdef RANGE_CHECKING
@@ -1384,7 +1679,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
             else
             {
                 for (event = signal->floatList; event;
-                                        event = event->nextFloat)
+                                        event = event->nextFloat())
                 {
 #ifdef RANGE_CHECKING
                     if (event->signal != signal)
@@ -1399,8 +1694,8 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
                     {
                         if (signal->is & TRACED)
                             printfEvt("[***removed %12s=%c at %2.3f, amb=%d]\n",
-                              signal->name, gLevelNames[event->level],
-                              (float)event->tick/gTicksNS, signal->ambDepth);
+                              signal->name(), gLevelNames[event->level],
+                              (double)event->tick/gTicksNS, signal->ambDepth);
                         if ((event->is & SOME_AMBIG) ==
                                         STARTING_AMBIG)
                             event->signal->ambDepth++;
@@ -1412,7 +1707,8 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
                                 throw new VError(verr_bug, 
                                     "BUG: sim1TickBin: at %2.3fns %s ambDepth"
                                     " negative",
-                                    (float)gTick/gTicksNS, event->signal->name);
+                                    (double)gTick/gTicksNS,
+                                    event->signal->name);
 #endif
                             event->signal->ambDepth--;
                         }
@@ -1425,14 +1721,15 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
         }
         if (ambiguity == CLEAN)
         {
-            if (signal->level != event->level || (signal->busOpt & DISP_STATE))
+            if (signal->level() != event->level ||
+                (signal->info()->busOpt & DISP_STATE))
             {
                 if (signal->is & TRACED)
                     printfEvt("(changed: %12s=%c)\n",
-                      signal->name, gLevelNames[event->level]);
-                signal->lastLevel = signal->level;
-                signal->level = event->level;
-                signal->nlevel = funcTable.INVERTtable[event->level];
+                      signal->name(), gLevelNames[event->level]);
+                signal->lastLevel = signal->level();
+                signal->setLevel(event->level);
+                signal->setNLevel(funcTable.INVERTtable[event->level]);
                 eventCount++;
                 link = &event->next;
             }
@@ -1440,37 +1737,37 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
             {
                 if (signal->is & TRACED)
                     printfEvt("[***removed %12s=%c]\n",
-                      signal->name, gLevelNames[event->level]);
+                      signal->name(), gLevelNames[event->level]);
                 removeEvent(link, event);           // no change: remove
             }
         }
         else if (ambiguity == STARTING_AMBIG)       // min-time edge
         {
             signal->ambDepth++;
-            if (signal->level != LV_X &&
-                signal->level != event->level)
+            if (signal->level() != LV_X &&
+                signal->level() != event->level)
             {
                 if (signal->ambDepth > 1)
                 {
                     if (signal->is & TRACED)
                         printfEvt("(changed: %12s=%cb [X] {amb=%d})\n",
-                         signal->name, gLevelNames[event->level],
+                         signal->name(), gLevelNames[event->level],
                          signal->ambDepth);
-                    signal->lastLevel = signal->level;
-                    signal->level = LV_X;   // a mix: show changing
-                    event->level = signal->level;   // back-annotate event level
-                    signal->nlevel = LV_X;
+                    signal->lastLevel = signal->level();
+                    signal->setLevel(LV_X);   // a mix: show changing
+                    event->level = signal->level(); // back-annotate event
+                    signal->setNLevel(LV_X);
                 }
                 else                        // else show rise, etc.
                 {
                     if (signal->is & TRACED)
                         printfEvt("(changed: %12s=%cb {amb=%d})\n",
-                          signal->name, gLevelNames[event->level],
+                          signal->name(), gLevelNames[event->level],
                           signal->ambDepth);
-                    signal->lastLevel = signal->level;
-                    signal->level = event->level;
-                    event->level = signal->level;   // back-annotate event level
-                    signal->nlevel = funcTable.INVERTtable[event->level];
+                    signal->lastLevel = signal->level();
+                    signal->setLevel(event->level);
+                    event->level = signal->level(); // back-annotate event
+                    signal->setNLevel(funcTable.INVERTtable[event->level]);
                 }
                 eventCount++;
                 link = &event->next;
@@ -1479,7 +1776,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
             {
                 if (signal->is & TRACED)
                     printfEvt("[***removed %12s=%cb {amb=%d}]\n",
-                      signal->name, gLevelNames[event->level],
+                      signal->name(), gLevelNames[event->level],
                       signal->ambDepth);
                 removeEvent(link, event);           // no change: remove
             }
@@ -1490,32 +1787,32 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
             if (signal->ambDepth <= 0)
                 throw new VError(verr_bug,
                     "BUG: sim1TickBin: at %2.3fns %s ambDepth negative",
-                    (float)gTick/gTicksNS, signal->name);
+                    (double)gTick/gTicksNS, signal->name);
 #endif
             signal->ambDepth--;
-            if (signal->ambDepth == 1 && signal->level != event->level)
+            if (signal->ambDepth == 1 && signal->level() != event->level)
             {                         // near end: show rise, etc.
-                signal->lastLevel = signal->level;
-                signal->level = event->level;
-                event->level = signal->level;   // back-annotate event level
-                signal->nlevel = funcTable.INVERTtable[event->level];
+                signal->lastLevel = signal->level();
+                signal->setLevel(event->level);
+                event->level = signal->level(); // back-annotate event level
+                signal->setNLevel(funcTable.INVERTtable[event->level]);
                 if (signal->is & TRACED)
                     printfEvt("(changed: %12s=%ce {amb=%d})\n",
-                      signal->name, gLevelNames[event->level],
+                      signal->name(), gLevelNames[event->level],
                       signal->ambDepth);
                 eventCount++;
                 link = &event->next;
             }
             else if (signal->ambDepth == 0)
             {                                  // end: show stable
-                signal->lastLevel = signal->level;
-                signal->level = funcTable.BSWALLOWtable[event->level];
-                event->level = signal->level;   // back-annotate event level
-                signal->nlevel = funcTable.INVERTtable[signal->level];
+                signal->lastLevel = signal->level();
+                signal->setLevel(funcTable.BSWALLOWtable[event->level]);
+                event->level = signal->level(); // back-annotate event level
+                signal->setNLevel(funcTable.INVERTtable[signal->level()]);
                 if (signal->is & TRACED)
                     printfEvt("(changed: %12s=%ce [%c] {amb=%d})\n",
-                      signal->name, gLevelNames[event->level],
-                      gLevelNames[signal->level], signal->ambDepth);
+                      signal->name(), gLevelNames[event->level],
+                      gLevelNames[signal->level()], signal->ambDepth);
                 eventCount++;
                 link = &event->next;
             }
@@ -1523,7 +1820,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
             {
                 if (signal->is & TRACED)
                     printfEvt("[***removed %12s=%c {amb=%d}]\n",
-                      signal->name, gLevelNames[event->level],
+                      signal->name(), gLevelNames[event->level],
                       signal->ambDepth);
                 removeEvent(link, event);           // no change: remove
             }
@@ -1531,11 +1828,11 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
 #ifdef EVENT_HISTORY
         if (signal->is & TRACED)
         {
-            Event* cause = event->cause;
+            Event* cause = event->cause();
             if (cause)
                 printfEvt("           cause: at %2.3f, %12s=%c\n",
-                  (float)cause->tick/gTicksNS,
-                  cause->signal->name, gLevelNames[cause->level]);
+                  (double)cause->tick/gTicksNS,
+                  cause->signal->name(), gLevelNames[cause->level]);
         }
 #endif
     }
@@ -1545,7 +1842,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
         if (event->is & ATTACHED_TEXT || event->tick != gTick)
             continue;
 #ifdef RANGE_CHECKING
-        if (event < events || event >= events+gMaxEvents)
+        if (!isPoolEvent(event))
             throw new VError(verr_bug, "simulate: bad event pointer");
 #endif
 #ifdef EVENT_HISTORY
@@ -1554,7 +1851,7 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
         Signal* signal = event->signal;
         if (!signal)
             display("// *** BUG: sim1TickBin: event's signal is zero at %2.3f\n",
-                (float)gTick/gTicksNS);
+                (double)gTick/gTicksNS);
         else
         {
             if (event->is & WAKEUP)   // C-model dummy signal: do its task
@@ -1572,122 +1869,468 @@ void sim1Tick(Event** tickEventLink, Event* lastTickEvent)
             }
             else
                 updateDependents(signal);
-            if (changedVoltage[signal->level][signal->lastLevel])
-                signal->lastTime = gTick;
+            if (changedVoltage[signal->level()][signal->lastLevel])
+                signal->setLastTime(gTick);
+        }
+    }
+    if (sweepHigh)
+        sweepAssigns();
+}
+
+//-----------------------------------------------------------------------------
+// Free the history events that have fallen gEventHistLen or more bins behind
+// tick bin 'bin', first moving them to the history store if it's in use.
+
+void freeOldHistory(Tick bin)
+{
+    Event* event = histFirst;
+    Event* nextEvent = NULL;
+    for ( ; event && event->tick / gTickBinSize + gEventHistLen <= bin;
+            event = nextEvent)
+    {
+        nextEvent = event->next;
+        // (if not a model's dummy signal)
+        Signal* signal = event->signal;
+        if (signal && !((signal->is & C_MODEL) &&
+            (signal->is & REGISTERED)))
+        {
+            if (gKeepHistory)
+                histAddEvent(event);
+            // If removing first displayed event, adjust initial disp level
+            else if (signal->firstDispEvt == event)
+                signal->initDspLevel = event->level;
         }
+        removeEvent(0, event);
     }
+    histFirst = event;
+    if (!event)
+        histLast = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Return the distance from slot 'from' to the next occupied slot in a wheel
+// level's occupancy bitmap, wrapping around, or -1 if the level is empty.
+
+int wheelSlotDist(const OccWord* occ, int from)
+{
+    int w = from / occWordBits;
+    int bit = from % occWordBits;
+    OccWord word = occ[w] >> bit;
+    if (word)
+        return __builtin_ctzll(word);
+    int dist = occWordBits - bit;
+    for (int n = 1; n <= occWords; n++, dist += occWordBits)
+    {
+        word = occ[(w + n) % occWords];
+        if (word)
+            return dist + __builtin_ctzll(word);
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+// Empty a wheel slot, returning its event list.
+
+inline Event* wheelTake(int level, int i)
+{
+    WheelSlot* slot = &wheel[level][i];
+    Event* list = slot->first;
+    slot->first = 0;
+    slot->last = 0;
+    wheelOcc[level][i / occWordBits] &= ~((OccWord)1 << (i % occWordBits));
+    return list;
+}
+
+//-----------------------------------------------------------------------------
+// Re-place the events of a higher wheel level's slot into the lower levels,
+// now that wheelTick has reached the start of its block.
+
+void wheelCascade(int level, int i)
+{
+    Event* nextEvent;
+    for (Event* event = wheelTake(level, i); event; event = nextEvent)
+    {
+        nextEvent = event->next;
+        wheelPlace(event, TRUE);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Move the overflow events that are now within reach of the top wheel level
+// into the wheel.
+
+void wheelPullOverflow()
+{
+    const Tick reach = (Tick)1 << (wheelLevels * wheelBits);
+    Event* event = overflowList;
+    EventRef* keepLink = &overflowList;
+    Event* nextEvent;
+    overflowList = 0;
+    for ( ; event; event = nextEvent)
+    {
+        nextEvent = event->next;
+        if (event->tick - wheelTick < reach)
+            wheelPlace(event, TRUE);
+        else
+        {
+            if (!overflowList || event->tick < overflowMinTick)
+                overflowMinTick = event->tick;
+            *keepLink = event;
+            keepLink = &event->next;
+            *keepLink = 0;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Advance wheelTick to the next tick that has pending events, cascading any
+// higher-level slots and overflow events that come due on the way. Empty
+// stretches are skipped using the slot occupancy bitmaps. Returns FALSE if
+// there are no more events before tick tEnd.
+
+bool wheelAdvance(Tick tEnd)
+{
+    const Tick reach = (Tick)1 << (wheelLevels * wheelBits);
+    while (1)
+    {
+        // nearest level 0 tick, and nearest higher-level block start or
+        // overflow arrival that needs to be cascaded first
+        Tick stop = tEnd;
+        bool cascade = FALSE;
+        int d = wheelSlotDist(wheelOcc[0], wheelTick & (wheelSlots - 1));
+        if (d >= 0 && wheelTick + d < stop)
+            stop = wheelTick + d;
+        for (int level = 1; level < wheelLevels; level++)
+        {
+            int shift = level * wheelBits;
+            Tick block = wheelTick >> shift;
+            d = wheelSlotDist(wheelOcc[level], (block + 1) & (wheelSlots - 1));
+            if (d >= 0 && ((block + d + 1) << shift) <= stop)
+            {
+                stop = (block + d + 1) << shift;
+                cascade = TRUE;
+            }
+        }
+        if (overflowList && overflowMinTick - (reach - 1) <= stop)
+        {
+            stop = overflowMinTick - (reach - 1);
+            cascade = TRUE;
+        }
+        if (stop >= tEnd)
+            return FALSE;
+        wheelTick = stop;
+        if (!cascade)
+            return TRUE;
+
+        // lower levels first: their events were posted after those of the
+        // levels above, so they must come first in any shared slot
+        for (int level = 1; level < wheelLevels; level++)
+        {
+            int shift = level * wheelBits;
+            if (stop & (((Tick)1 << shift) - 1))
+                break;
+            int i = (stop >> shift) & (wheelSlots - 1);
+            if (wheel[level][i].first)
+                wheelCascade(level, i);
+        }
+        if (overflowList && overflowMinTick - wheelTick < reach)
+            wheelPullOverflow();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Compare two pending events by tick, then by their order in the wheel.
+
+struct PendingEvent
+{
+    Tick        tick;
+    size_t      seq;            // order found in wheel levels and overflow
+    Event*      event;
+};
+
+int comparePending(const void* a, const void* b)
+{
+    const PendingEvent* pa = (const PendingEvent*)a;
+    const PendingEvent* pb = (const PendingEvent*)b;
+    if (pa->tick != pb->tick)
+        return (pa->tick < pb->tick ? -1 : 1);
+    return (pa->seq < pb->seq ? -1 : (pa->seq > pb->seq));
+}
+
+//-----------------------------------------------------------------------------
+// Return a malloc'd array of all pending events, in the order they will be
+//  simulated, and set *nEvents to its length. A tick's events in a lower
+//  wheel level come before those still to be cascaded from a higher one.
+
+Event** listPendingEvents(size_t* nEvents)
+{
+    size_t n = 0;
+    for (int level = 0; level < wheelLevels; level++)
+        for (int i = 0; i < wheelSlots; i++)
+            for (Event* event = wheel[level][i].first; event;
+                 event = event->next)
+                n++;
+    for (Event* event = overflowList; event; event = event->next)
+        n++;
+
+    PendingEvent* pending = (PendingEvent*)malloc((n+1) *
+                                                  sizeof(PendingEvent));
+    Event** events = (Event**)malloc((n+1) * sizeof(Event*));
+    if (!pending || !events)
+        throwWithTime(verr_memOverflow, "no memory to list pending events");
+    size_t seq = 0;
+    for (int level = 0; level < wheelLevels; level++)
+        for (int i = 0; i < wheelSlots; i++)
+            for (Event* event = wheel[level][i].first; event;
+                 event = event->next, seq++)
+            {
+                pending[seq].tick = event->tick;
+                pending[seq].seq = seq;
+                pending[seq].event = event;
+            }
+    for (Event* event = overflowList; event; event = event->next, seq++)
+    {
+        pending[seq].tick = event->tick;
+        pending[seq].seq = seq;
+        pending[seq].event = event;
+    }
+    qsort(pending, n, sizeof(PendingEvent), comparePending);
+    for (size_t i = 0; i < n; i++)
+        events[i] = pending[i].event;
+    free(pending);
+    *nEvents = n;
+    return events;
+}
+
+//-----------------------------------------------------------------------------
+// Discard all events and restart the timing wheel at tick 'tick', for
+//  restoring a checkpoint.
+
+void resetTimeline(Tick tick)
+{
+    freeEventPool();
+    memset(wheel, 0, sizeof(wheel));
+    memset(wheelOcc, 0, sizeof(wheelOcc));
+    wheelTick = tick;
+    overflowList = 0;
+    overflowMinTick = 0;
+    histFirst = 0;
+    histLast = 0;
+    gTick = tick;
+    for (Signal* signal = gSignals; signal < gNextSignal; signal++)
+    {
+        signal->floatList = 0;
+        signal->firstDispEvt = 0;
+        signal->lastEvtPosted = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Re-post a pending event from a checkpoint. Events must be restored in
+//  reverse of their simulation order, so that each tick's slot and each
+//  signal's event list come out in their original order.
+
+Event* restoreEvent(Tick tick, Signal* signal, Level level, char eventType)
+{
+    if (freeEventList == 0)
+        growEventPool();
+    Event* event = freeEventList;
+    freeEventList = event->next;
+    nFreeEvents--;
+    event->signal = signal;
+    event->nextInSignal = 0;
+    event->prevInSignal = 0;
+    event->level = level;
+    event->is = eventType;
+    event->clearNextFloat();
+    event->tick = tick;
+    wheelPlace(event, FALSE);
+
+    if (!((signal->is & C_MODEL) && (signal->is & REGISTERED)))
+    {
+        Event* earlierEv = signal->lastEvtPosted;
+        while (earlierEv && earlierEv->tick > tick)
+            earlierEv = earlierEv->prevInSignal;
+        event->insertS(signal, earlierEv);
+    }
+    return event;
+}
+
+//-----------------------------------------------------------------------------
+// Open <project>.telemetry and write its header, if sampling.
+
+void telemetryStart(Tick tStart)
+{
+    if (telemFile)              // (left open by a failed run)
+        closeFile(telemFile);
+    telemFile = 0;
+    telemPosts = 0;
+    telemRemoves = 0;
+    telemMaxWalk = 0;
+    telemEventCount = 0;
+    if (gTelemetryNS <= 0)
+        return;
+    char fileName[max_nameLen];
+    snprintf(fileName, sizeof(fileName), "%s.telemetry", gProjName);
+    telemFile = openFile(fileName, "w");
+    telemNextTick = tStart;
+    fprintf(telemFile, "# PVSim %s scheduler telemetry, every %lld ns\n",
+            gPSVersion, gTelemetryNS);
+    fprintf(telemFile, "# ns pool free pending history slots max_bin"
+            " overflow posted removed simulated max_walk\n");
+}
+
+//-----------------------------------------------------------------------------
+// Write one telemetry sample of the event pool and timing wheel. Pending
+//  events are counted by walking the wheel, so its hot paths only keep
+//  running counts. A slot holds one tick's events at level 0, or a block of
+//  ticks' above it; max_bin is the most events in any one slot.
+
+void telemetrySample()
+{
+    size_t pending = 0, nSlots = 0, maxBin = 0, nOverflow = 0;
+    for (int level = 0; level < wheelLevels; level++)
+        for (int i = 0; i < wheelSlots; i++)
+        {
+            size_t n = 0;
+            for (Event* event = wheel[level][i].first; event;
+                 event = event->next)
+                n++;
+            if (n)
+                nSlots++;
+            if (n > maxBin)
+                maxBin = n;
+            pending += n;
+        }
+    for (Event* event = overflowList; event; event = event->next)
+        nOverflow++;
+    pending += nOverflow;
+
+    // all pool events but index 0 are free, pending or history
+    size_t pool = (gMaxEvents ? gMaxEvents - 1 : 0);
+    size_t history = pool - nFreeEvents - pending;
+    fprintf(telemFile, "%.3f %ld %ld %ld %ld %ld %ld %ld %ld %ld %d %ld\n",
+            (double)gTick/gTicksNS, (long)pool, (long)nFreeEvents,
+            (long)pending, (long)history, (long)nSlots, (long)maxBin,
+            (long)nOverflow, (long)telemPosts, (long)telemRemoves,
+            eventCount - telemEventCount, (long)telemMaxWalk);
+    telemPosts = 0;
+    telemRemoves = 0;
+    telemMaxWalk = 0;
+    telemEventCount = eventCount;
+    fflush(telemFile);          // keep samples if the run fails
+    while (telemNextTick <= gTick)
+        telemNextTick += (Tick)gTelemetryNS * gTicksNS;
 }
 
 //-----------------------------------------------------------------------------
 // Run the simulation for the given duration and leave the resulting events
-//  in the time line array, corresponding to ticks gDispTStart to gTEnd.
+//  in each signal's event list and the history store, corresponding to ticks
+//  gDispTStart to gTEnd.
 
 void simulate()
 {
-    int nsEnd;
+    DLong nsEnd;
     if (gNSDuration == 0)
     {
-        nsEnd = 200000000;
-        gNSDuration =  200000000;
+        nsEnd = ns_maxRunTime;
+        gNSDuration = ns_maxRunTime;
     }
     else
         nsEnd = gNSStart + gNSDuration;
 
-    Tick tStart = gNSStart * gTicksNS;
-    gTEnd = nsEnd * gTicksNS;
+    Tick tStart = (Tick)gNSStart * gTicksNS;
+    gTEnd = (Tick)nsEnd * gTicksNS;
 
+    gTimeScaleExp = designTimeFormat.scaleExp;
+    gTimeScale = designTimeFormat.scale;
+    gTimeDispPrec = designTimeFormat.dispPrec;
+    gTimeSuffixStr = designTimeFormat.suffixStr;
+    gTimeMinFieldWid = designTimeFormat.minFieldWid;
     initSignals();
     gOpenFiles = 0;
+    if (gRestoreFileName[0])
+    {
+        readCheckpoint(gRestoreFileName);
+        tStart = gTick;
+    }
+    Tick ckptTick = (Tick)gCheckpointNS * gTicksNS;
+    bool ckptPending = (gCheckpointNS > 0 && ckptTick > tStart);
 
     if (!gQuietMode)
         display("    simulating from %2.3f ns to %2.3f ns ...\n\n",
-            (float)gNSStart, (float)nsEnd);
+            (double)tStart/gTicksNS, (double)nsEnd);
 
     clock_t startRealTime = clock();
     eventCount = 0;
-    Event** timeLineTail = timeLineHead + gEventHistLen;
+    skippedTickCount = 0;
+    telemetryStart(tStart);
 
-    // Main loop: loop for each tick bin
+    // Main loop: loop for each tick that has events, up to the last whole bin
 
-    Tick startBin = tStart / gTickBinSize;
-    Tick endBin =   gTEnd  / gTickBinSize;
-    for (Tick tickBin = startBin; tickBin < endBin; tickBin++)
+    Tick tEndBins = gTEnd / gTickBinSize * gTickBinSize;
+    Tick nextTick = tStart;
+    while (wheelAdvance(tEndBins))
     {
-        Event* tailEventList = *timeLineTail;   // free up tail slot in time
-                                                // line FIFO
-        if (tailEventList)
-        {
-#ifdef EXTENSION
-            throw new VError(verr_memOverflow,
-                            "too many events: increase spaceForEvents");
-#endif
-            Event* nextEvent = NULL;
-            for (Event* event = tailEventList; event; event = nextEvent)
-            {
-                nextEvent = event->next;
-                // If removing first displayed event, adjust initial disp level
-                // (if not a model's dummy signal)
-                Signal* signal = event->signal;
-                if (signal && !((signal->is & C_MODEL) &&
-                    (signal->is & REGISTERED)) &&
-                    signal->firstDispEvt == event)
-                    signal->initDspLevel = event->level;
-
-                removeEvent(0, event);
-            }
-            *timeLineTail = 0;
-        }
-        if (debugLevel(4))
-            display("%2.3f bin\n", (float)tickBin*gTickBinSize/gTicksNS);
-
-        // loop for each different tick time in this bin
-        for (Event** link = timeLineHead; *link; )
+        gTick = wheelTick;
+        if (ckptPending && gTick >= ckptTick)
         {
-            Event* e = *link;
-            gTick = e->tick;
-            // find all events in tick bin at current tick
-            if (debugLevel(2))
-                display("link=0x%p tick %d e=0x%p", link, (int)gTick, e);
-            for ( ; e && e->tick == gTick; e = e->next)
-            {
-                //display(" e=0x%p %d sig=%p ", e, e->tick, e->signal);
-                //if (e->signal)
-                //    display("%s\n", e->signal->name);
-                //else
-                //    display("?\n");
-            }
-
-            if (debugLevel(2))
-                display(" sim1Tick(link=0x%p, e=0x%p)\n", link, e);
-            sim1Tick(link, e);      // simulate events at one tick
-
-            // sim1Tick may have removed some events in the list starting at
-            // link, so we have to restart our search for the next tick value
-            // from there.
-            if (debugLevel(2))
-                display(" find next tick\n");
-            for (e = *link; e && e->tick == gTick; e = *link)
-                link = &e->next;
+            writeCheckpoint();
+            ckptPending = FALSE;
         }
+        if (telemFile && gTick >= telemNextTick)
+            telemetrySample();
+        skippedTickCount += gTick - nextTick;
+        nextTick = gTick + 1;
+        freeOldHistory(gTick / gTickBinSize);  // free up old history events
 
-        timeLineHead++;                 // advance time line pointers
-        if (timeLineHead >= timeLineEnd)
+        if (debugLevel(4))
+            display("%2.3f tick\n", (double)gTick/gTicksNS);
+        int i = gTick & (wheelSlots - 1);
+        EventRef* link = &wheel[0][i].first;
+        if (debugLevel(2))
+            display("link=0x%p tick %d e=0x%p", link, (int)gTick, *link);
+        sim1Tick(link, 0);      // simulate events at one tick
+
+        // sim1Tick may have removed some of the tick's events, so find the
+        // new end of its list before moving it onto the history
+        Event* e = wheelTake(0, i);
+        if (e)
         {
-            timeLineBaseTick += gTickBinSize;
-            timeLineHead -= timeLineLen;
+            if (histLast)
+                histLast->next = e;
+            else
+                histFirst = e;
+            while (e->next)
+                e = e->next;
+            histLast = e;
         }
-        timeLineTail++;
-        if (timeLineTail >= timeLineEnd)
-            timeLineTail -= timeLineLen;
+    }
+    if (nextTick < tEndBins)
+        skippedTickCount += tEndBins - nextTick;
+    if (ckptPending && ckptTick < tEndBins)
+    {
+        // simulation went idle before the checkpoint time
+        Tick lastTick = gTick;
+        gTick = ckptTick;
+        writeCheckpoint();
+        gTick = lastTick;
+    }
+    if (telemFile)
+    {
+        telemetrySample();
+        closeFile(telemFile);
+        telemFile = 0;
     }
 
     clock_t simRealTime = clock() - startRealTime;
     if (!gFlaggedErrCount)
     {
         if (!gQuietMode)
-            display("    [%3.1f sec, %3.1f Kevents/sec]\n",
+            display("    [%5.3f sec, %3.1f Kevents/sec, %ld idle ticks skipped]\n",
                 (float)simRealTime/CLOCKS_PER_SEC,
-                ((float)eventCount/1000)/((float)simRealTime/CLOCKS_PER_SEC));
+                ((float)eventCount/1000)/((float)simRealTime/CLOCKS_PER_SEC),
+                (long)skippedTickCount);
         if (gWarningCount)
             display("\n*** %d WARNING%s ***\n", gWarningCount,
                 (gWarningCount == 1 ? "" : "S"));
@@ -1697,27 +2340,9 @@ void simulate()
             fclose(f->file);
     }
 
-    // unwrap time line FIFO so it starts at tick gDispTStart
+    profReport();
 
-    gDispTStart = (int)gTEnd - gEventHistLen;
-    if (gDispTStart < tStart)
+    gDispTStart = (gTEnd > gEventHistLen ? gTEnd - gEventHistLen : 0);
+    if (gDispTStart < tStart || gKeepHistory)
         gDispTStart = tStart;
-    size_t timeLineLen = (timeLineEnd - timeLine);
-    allocTempSpace(&tempTLSpace, timeLineLen);
-    Event** p1 = timeLineHead - (int)(gTEnd - gDispTStart);
-    if (p1 < timeLine)
-        p1 += timeLineLen;
-    Event** p2;
-    for (p2 = tempTL; p2 < tempTL + timeLineLen; )
-    {
-        *p2++ = *p1++;
-        if (p1 >= timeLineEnd)
-            p1 = timeLine;
-    }
-    p2 = tempTL;
-    for (p1 = timeLine; p1 < timeLineEnd; )
-        *p1++ = *p2++;
-    freeTempSpace(&tempTLSpace);
-    timeLineBaseTick = 0;
-    timeLineHead = timeLine;
 }
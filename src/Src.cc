@@ -34,6 +34,7 @@
 #include "Utils.h"
 #include "PSignal.h"
 #include "SimPalSrc.h"
+#include "TestChoices.h"
 
 // ------------ Global Global Variables -------------
 
@@ -62,6 +63,33 @@ Macro* gMacros;         // list of defined text macros
 Src*    VL::baseSrc;    // base Verilog file source
 int VL::debugLevel;     // debugging display detail level
 
+// ------------ Local Global Variables -------------
+
+// The size and contents hash of each source file read while compiling, used
+// to tell if a compiled design is still current.
+
+struct SrcStamp
+{
+    char            fileName[max_nameLen];
+    long            size;
+    unsigned long   hash;       // FNV-1a hash of file's contents
+};
+
+SrcStamp* srcStamps;        // stamps of files read, in load order
+SrcStamp* srcStampsEnd;
+SrcStamp* srcStampsLimit;
+Space   srcStampSpace =     // srcStamps space
+{
+    "source stamps",
+    0,
+    &srcStamps,
+    sizeof(SrcStamp),
+    &srcStampsEnd,
+    &srcStampsLimit
+};
+bool    srcStamping;        // TRUE while compiling a design
+bool    srcStampsValid;     // FALSE if design depends on more than sources
+
 //-----------------------------------------------------------------------------
 // Create a Token from last tokenized source.
 
@@ -100,6 +128,112 @@ Token::~Token()
         this->next->prev = prev;
 }
 
+//-----------------------------------------------------------------------------
+// Return the FNV-1a hash of a block of text, continuing from a given hash.
+
+static unsigned long hashText(const char* text, size_t size,
+                              unsigned long hash = 14695981039346656037ul)
+{
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ (unsigned char)text[i]) * 1099511628211ul;
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+// Forget the stamps of the last compile, and stamp each source file read
+//  until endSrcStamps().
+
+void startSrcStamps()
+{
+    freeSpace(&srcStampSpace);
+    srcStamping = TRUE;
+    srcStampsValid = TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Stop stamping source files, as the design has been compiled. Files read
+//  while simulating, such as by $readmemmif, are read again each run.
+
+void endSrcStamps()
+{
+    srcStamping = FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// Note that the compiled design depends on more than its source files, as
+//  when the project ran a shell command.
+
+void invalidateSrcStamps()
+{
+    srcStampsValid = FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if a stamped source file still has the same contents.
+
+static bool stampCurrent(const SrcStamp* stamp)
+{
+    FILE* ifp = openFile(stamp->fileName, "r");
+    if (ifp == 0)
+        return FALSE;
+    unsigned long hash = hashText(0, 0);
+    long size = 0;
+    char buf[32000];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), ifp)) > 0)
+    {
+        hash = hashText(buf, n, hash);
+        size += n;
+    }
+    closeFile(ifp);
+    return (size == stamp->size && hash == stamp->hash);
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if every source file read by the last compile still has the
+//  same contents, so that its compiled design may be reused.
+
+bool srcStampsCurrent()
+{
+    if (!srcStampsValid || srcStamps == srcStampsEnd)
+        return FALSE;
+    for (SrcStamp* stamp = srcStamps; stamp < srcStampsEnd; stamp++)
+        if (!stampCurrent(stamp))
+            return FALSE;
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Write the last compile's source stamps to a design cache file.
+
+void writeSrcStamps(FILE* fp)
+{
+    size_t n = srcStampsEnd - srcStamps;
+    fwrite(&n, sizeof(n), 1, fp);
+    fwrite(srcStamps, sizeof(SrcStamp), n, fp);
+}
+
+//-----------------------------------------------------------------------------
+// Read the source stamps written by writeSrcStamps(), returning TRUE if each
+//  of those source files is unchanged.
+
+bool readSrcStamps(FILE* fp)
+{
+    size_t n;
+    if (fread(&n, sizeof(n), 1, fp) != 1 || n == 0)
+        return FALSE;
+    for (; n; n--)
+    {
+        SrcStamp stamp;
+        if (fread(&stamp, sizeof(stamp), 1, fp) != 1)
+            return FALSE;
+        stamp.fileName[max_nameLen-1] = 0;
+        if (!stampCurrent(&stamp))
+            return FALSE;
+    }
+    return TRUE;
+}
+
 //-----------------------------------------------------------------------------
 // Construct a source by reading a source file into the source array.
 
@@ -132,6 +266,17 @@ Src::Src(const char* fileName, SrcMode mode, Src* parent)
     }
     closeFile(ifp);
 
+    if (srcStamping)
+    {
+        if (srcStampsEnd >= srcStampsLimit)
+            reAllocSpace(&srcStampSpace, 2 * (srcStampsEnd - srcStamps) + 16);
+        SrcStamp* stamp = srcStampsEnd++;
+        strncpy(stamp->fileName, fileName, max_nameLen-1);
+        stamp->fileName[max_nameLen-1] = 0;
+        stamp->size = this->size;
+        stamp->hash = hashText(this->base, this->size);
+    }
+
     if (*(p-1) == '\377')
         p--;
     *p = 0;
@@ -236,7 +381,7 @@ void Src::tzCheckForNumber()
             this->tokCode = FLOAT_TOKEN;
         }
         else
-            this->tokNumber = atoi(this->tokName);
+            this->tokNumber = atoll(this->tokName);
     }
 }
 
@@ -470,7 +615,7 @@ void Src::tzScan()
     if (debugLevel(4))
     {
         if (this->tokCode == NUMBER_TOKEN)
-            display("%d=#%d}\n", rip - this->base, this->tokNumber);
+            display("%d=#%lld}\n", rip - this->base, this->tokNumber);
         else if (this->tokCode == STRING_TOKEN)
             display("%d=\"%s\"}\n", rip - this->base, this->tokName);
         else if (this->tokCode == NAME_TOKEN)
@@ -604,9 +749,13 @@ Macro::Macro(const char* name, const char* text, Src* parent)
 
 //-----------------------------------------------------------------------------
 // Look up src->tokName in the current macro list and return it if found.
+//  If running all test choices, the first lookup of a choice's macro starts
+//  their workers, and continues in each worker.
 
 Macro* Macro::find(Src* src, bool noErrors)
 {
+    if (isTestChoiceMacro(src->tokName))
+        forkTestWorkersIfNeeded();
     for (Macro* m = gMacros; m; m = m->next)
         if (strcmp(m->name, src->tokName) == 0)
             return m;
@@ -934,9 +1083,9 @@ TokCode scan()
                 else if (tc == STRING_TOKEN)
                     display("tks=\"%s\"\n", gScToken->name);
                 else if (tc == NUMBER_TOKEN)
-                    display("tk#=%d\n",gScToken->number);
+                    display("tk#=%lld\n",gScToken->number);
                 else if (tc == FLOAT_TOKEN)
-                    display("tkf=%g\n",gScToken->number);
+                    display("tkf=%g\n",gScToken->fNumber);
                 else
                     display("tk=%c\n", (char)tc);
             }
@@ -84,7 +84,7 @@ public:
     union
     {
         const char* name;   // NAME_TOKEN string
-        int     number;     // NUMBER_TOKEN value
+        DLong   number;     // NUMBER_TOKEN value
         float   fNumber;    // FLOAT_TOKEN value
     };
 
@@ -106,7 +106,7 @@ private:
     union
     {
         const char* tokName; // tzScanned NAME_TOKEN string
-        int     tokNumber;  // tzScanned NUMBER_TOKEN value
+        DLong   tokNumber;  // tzScanned NUMBER_TOKEN value
         float   tokFNumber; // tzScanned FLOAT_TOKEN value
     };
     size_t  exVal;          // preprocessor expression parsing current value
@@ -190,6 +190,13 @@ void throwExpected(const char* name);
 void throwExpected(Token* srcLoc, const char* name);
 void throwExpectedConst();
 
+void startSrcStamps();
+void endSrcStamps();
+void invalidateSrcStamps();
+bool srcStampsCurrent();
+void writeSrcStamps(FILE* fp);
+bool readSrcStamps(FILE* fp);
+
 int hextol(const char* s);
 char *newString (const char *s);
 
@@ -0,0 +1,254 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Test Choice Workers
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+#include "Src.h"
+#include "VLCoder.h"
+#include "VLCompiler.h"
+#include "TestChoices.h"
+
+// A test choice only changes a design through its preprocessor macros: the
+// choice's name is defined, and TEST_CHOICE is defined as its name in quotes.
+// So when running all choices, the design is compiled with neither defined
+// until one of those names is first looked up, or until the design is
+// complete. That compiled prefix is the same for every choice. There the
+// process forks a worker per choice, which defines its choice's macros and
+// finishes compiling and simulating on its own, sharing the memory already
+// built copy-on-write. Each worker's output goes to <project>_<choice>.log
+// and .events, and the parent waits for them, running gTestWorkers at once.
+// Windows has no fork(), so running all choices isn't supported there.
+
+// -------- global variables --------
+
+int     gTestWorkers;           // test choices run at once, or 0 for just one
+int     gNTestChoices;
+int     gNTestsFailed;          // number of workers with nonzero status
+TestResult gTestResults[max_testChoices];
+
+// -------- local global variables --------
+
+int     testWorkerNum = -1;     // this worker's test choice, or -1 if none
+bool    testWorkersForked;      // TRUE once workers have been started
+
+//-----------------------------------------------------------------------------
+// Read the test choices declared in a project file.
+
+void gatherTestChoices(const char* projFileName)
+{
+    FILE* fp = fopen(projFileName, "r");
+    if (!fp)
+        throw new VError(verr_io, "can't read project file '%s'",
+                         projFileName);
+    gNTestChoices = 0;
+    char line[max_messageLen];
+    while (fgets(line, sizeof(line), fp))
+    {
+        char word[max_nameLen];
+        char name[max_nameLen];
+        if (sscanf(line, "%99s %99s", word, name) == 2 &&
+            strcmp(word, "test_choice") == 0)
+        {
+            if (gNTestChoices >= max_testChoices)
+            {
+                fclose(fp);
+                throw new VError(verr_memOverflow,
+                                 "more than %d test choices", max_testChoices);
+            }
+            TestResult* test = &gTestResults[gNTestChoices++];
+            strcpy(test->choice, name);
+            test->status = 0;
+            test->seconds = 0.;
+        }
+    }
+    fclose(fp);
+    if (gNTestChoices == 0)
+        throw new VError(verr_notFound, "no test_choice lines in '%s'",
+                         projFileName);
+#ifdef _WIN32
+    throw new VError(verr_notYet, "running all test choices isn't supported"
+                     " on Windows");
+#endif
+    testWorkersForked = FALSE;
+}
+
+//-----------------------------------------------------------------------------
+// Return the default number of test choices to run at once: one per
+//  processor.
+
+int defaultTestWorkers()
+{
+#ifdef _WIN32
+    return 1;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0 ? n : 1);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if looking up the given macro name would make the compile
+//  depend on the test choice, and workers haven't yet been started.
+
+bool isTestChoiceMacro(const char* name)
+{
+    if (!gTestWorkers || testWorkersForked)
+        return FALSE;
+    if (strcmp(name, "TEST_CHOICE") == 0)
+        return TRUE;
+    for (int i = 0; i < gNTestChoices; i++)
+        if (strcmp(name, gTestResults[i].choice) == 0)
+            return TRUE;
+    return FALSE;
+}
+
+#ifndef _WIN32
+//-----------------------------------------------------------------------------
+// Return the current time in seconds, for timing workers.
+
+static double wallSeconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//-----------------------------------------------------------------------------
+// Wait for a worker to finish and record its result.
+
+static void waitForTestWorker(pid_t* pids, double* startTimes)
+{
+    int status;
+    pid_t pid = wait(&status);
+    if (pid < 0)
+        throw new VError(verr_bug, "waiting for test worker");
+    for (int i = 0; i < gNTestChoices; i++)
+        if (pids[i] == pid)
+        {
+            TestResult* test = &gTestResults[i];
+            test->seconds = wallSeconds() - startTimes[i];
+            test->status = WIFEXITED(status) ? WEXITSTATUS(status) : 255;
+            pids[i] = 0;
+            TmpName note("%d errors", test->status);
+            if (test->status == 0)
+                note = "passed";
+            else if (test->status == 255)
+                note = "failed";
+            display("    test %-24s %-10s %6.3f sec\n", test->choice,
+                    (char*)note, test->seconds);
+        }
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// If running all test choices and they haven't been started, fork a worker
+//  for each and wait for them, running up to gTestWorkers at once. Returns
+//  only in a worker, which is set up to continue compiling its test choice.
+//  The parent throws merr_testsDone when all have finished.
+
+void forkTestWorkersIfNeeded()
+{
+    if (!gTestWorkers || testWorkersForked)
+        return;
+    testWorkersForked = TRUE;
+
+#ifndef _WIN32
+    if (!gQuietMode)
+        display("    [shared compile: %5.3f sec]\n"
+                "    running %d test choices, %d at a time...\n",
+                (float)(clock() - vc.startRealTime)/CLOCKS_PER_SEC,
+                gNTestChoices, gTestWorkers);
+    pid_t pids[max_testChoices];
+    double startTimes[max_testChoices];
+    double startTime = wallSeconds();
+    int nRunning = 0;
+    for (int i = 0; i < gNTestChoices; i++)
+    {
+        if (nRunning == gTestWorkers)
+        {
+            waitForTestWorker(pids, startTimes);
+            nRunning--;
+        }
+        fflush(0);              // don't let workers repeat buffered output
+        startTimes[i] = wallSeconds();
+        pid_t pid = fork();
+        if (pid < 0)
+            throw new VError(verr_io, "can't fork test worker");
+        if (pid == 0)
+        {
+            testWorkerNum = i;
+            const char* choice = gTestResults[i].choice;
+            char projName[max_nameLen];
+            snprintf(projName, sizeof(projName), "%s_%s", gProjName, choice);
+            strcpy(gProjName, projName);
+            vc.startRealTime = clock();     // (CPU time restarts in worker)
+            startTestWorker();
+            defineTestChoice(choice);
+            return;
+        }
+        pids[i] = pid;
+        nRunning++;
+    }
+    for ( ; nRunning > 0; nRunning--)
+        waitForTestWorker(pids, startTimes);
+
+    gNTestsFailed = 0;
+    for (int i = 0; i < gNTestChoices; i++)
+        if (gTestResults[i].status)
+            gNTestsFailed++;
+    display("    [%d tests, %d failed, %5.3f sec]\n", gNTestChoices,
+            gNTestsFailed, wallSeconds() - startTime);
+    throw merr_testsDone;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if this process is a test choice worker.
+
+bool isTestWorker()
+{
+    return testWorkerNum >= 0;
+}
+
+//-----------------------------------------------------------------------------
+// End a test choice worker. Its exit status is 0 if it passed, the number of
+//  errors flagged (up to 254), or 255 if it failed to compile or simulate.
+
+void exitTestWorker(bool failed)
+{
+    int status = gFlaggedErrCount < 254 ? gFlaggedErrCount : 254;
+    if (failed)
+        status = 255;
+    fflush(0);
+    _exit(status);
+}
@@ -0,0 +1,54 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator Test Choice Workers
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#pragma once
+
+#include "Utils.h"
+
+// A project's test choices are declared by "test_choice <name>" lines in its
+// .psim file. All of them may be run at once, each in a worker process forked
+// from a compile of the parts of the design they share.
+
+const int max_testChoices = 100;
+
+struct TestResult
+{
+    char        choice[max_nameLen];
+    int         status;         // worker's exit status: see exitTestWorker()
+    double      seconds;        // worker's elapsed time
+};
+
+extern int      gTestWorkers;   // test choices run at once, or 0 for just one
+extern int      gNTestChoices;
+extern int      gNTestsFailed;
+extern TestResult gTestResults[max_testChoices];
+
+void gatherTestChoices(const char* projFileName);
+int  defaultTestWorkers();
+bool isTestChoiceMacro(const char* name);
+void forkTestWorkersIfNeeded();
+bool isTestWorker();
+void exitTestWorker(bool failed);
+
+// defined by each front end
+void startTestWorker();
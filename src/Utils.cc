@@ -271,7 +271,8 @@ void reAllocSpace(Space* space, long newNumElems)
     {
         if (newNumElems > maxElems)
         {
-            char* mallocBase = (char* )realloc(space->mallocBase, size + 4);
+            char* mallocBase = (char* )heapRealloc(space->mallocBase,
+                                                    size + 4);
             if (mallocBase == 0)
                 reportMemErr("reAllocSpace", space->name, size);
             char* base = (char* )((unsigned long)mallocBase +
@@ -290,7 +291,7 @@ void reAllocSpace(Space* space, long newNumElems)
         display("malloc(%4ldK) for %5s, total=%5ldK\n",
                 size/1024, space->name, gSpacesTotal/1024);
 #endif
-        char* mallocBase = (char* )malloc(size + 4);
+        char* mallocBase = (char* )heapAlloc(size + 4);
         if (mallocBase == 0)
             reportMemErr("reAllocSpace", space->name, size);
         space->mallocBase = mallocBase;
@@ -347,7 +348,7 @@ void needBlock(const char* procName, const char* itemName, long neededBytes,
         display("malloc(%4ldK) for dict , total=%5ldK\n",
                 size/1024, gDPTotal/1024);
 #endif
-        gDP = (char*)malloc(size);
+        gDP = (char*)heapAlloc(size);
         if (gDP == 0)
             reportMemErr(procName, itemName, neededBytes);
         *(char** )gDP = gBlockList;
@@ -372,7 +373,7 @@ void freeBlocks()
     for (gDP = gBlockList; gDP; gDP = nextDP)
     {
         nextDP = *(char** )gDP;
-        free(gDP);
+        heapFree(gDP);
     }
     gBlockList = 0;
     gDP = gDPEnd = 0;
@@ -501,6 +502,10 @@ void operator delete(void*) throw()
 {
 }
 
+void operator delete(void*, size_t) throw()
+{
+}
+
 //-----------------------------------------------------------------------------
 // Reset the random-sequence seed for this simulation run to the value set
 //  by _srand_.
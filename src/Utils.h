@@ -44,6 +44,8 @@ const unsigned int max_messageLen = 1000;
 const bool TRUE =  1;
 const bool FALSE = 0;
 
+typedef long long   DLong;
+
 extern inline int min(int a, int b) { return a < b ? a : b; }
 extern inline int max(int a, int b) { return a > b ? a : b; }
 
@@ -94,7 +96,6 @@ public:
                 SpaceList(SpaceList* prev, char* name, short elemSize,
                           long numElems);
     SpaceList*  free();
-    friend class SigNode;
 };
 
 struct SrcFile: SimObject
@@ -109,6 +110,7 @@ typedef int AEErrorCode;
 enum MainErrorCode
 {
     merr_retry = 1,
+    merr_testsDone = 2,         // all test choice workers have finished
     merr_reportError = -2
 };
 
@@ -215,6 +217,10 @@ void showMsgInEditor(const char* msg, const char* fileName, int line);
 void breakInEditor(Token* srcLoc);
 
 // Memory allocation
+void* heapAlloc(size_t size);       // design heap (see DesignCache.h)
+void* heapCalloc(size_t n, size_t size);
+void* heapRealloc(void* p, size_t size);
+void heapFree(void* p);
 void reAllocSpace(Space* space, long newNumElems);
 void allocSpace(Space* space, long numElems);
 void freeSpace(Space* space);
@@ -166,8 +166,8 @@ public:
     bool        isDisp;         // TRUE selects disp
     union
     {
-        short       bit;        // if a constant: bit number or memory address
-        short       disp;       // if an integer or param: local var displacement
+        int         bit;        // if a constant: bit number or memory address
+        int         disp;       // if an integer or param: local var displacement
     };
     Expr*       expr;           // general expression
     void        compile();
@@ -186,7 +186,7 @@ public:
     RangeIndex  left;
     RangeIndex  right;
                 Range();
-    void        compile();
+    void        compile(bool isMemRange = FALSE);
                 Range(Range* x)     // copy a Range
                             { *this = *x; }
                 Range(int nBits)    // construct an n-bit Range
@@ -269,18 +269,67 @@ public:
 
 // A memory array.  !!! size_t integer width only for now
 // Embedded Scalar is for triggering readers when memory is changed
+// A Memory's local var holds a MemHead, followed by its elements as size_t
+// integers or, if it has more than max_denseMemElems elements, a pointer to
+// its paged store (see MemPages.h).
+
+const size_t max_denseMemElems = 1024;
+
+class MemReader;
+
 class Memory : public TrigNet
 {
 public:
     Range*      memRange;       // declared address range (may be variable)
     Range*      elemRange;      // declared element bit range (may be variable)
+    MemReader*  readers;        // list of continuous assigns' element reads
 
                 Memory(const char* name, NetAttr attr, short disp, short maxSize,
                        Range* memRange, Range* elemRange) :
                     TrigNet(name, ty_memory, attr, disp)
                             { this->exType.size = maxSize;
                               this->memRange = memRange;
-                              this->elemRange = elemRange; }
+                              this->elemRange = elemRange;
+                              this->readers = 0; }
+    bool        isPaged()   { return this->memRange->size > max_denseMemElems; }
+    int         elemBits()  { return (this->elemRange ? this->elemRange->size :
+                                      sizeof(size_t)*8); }
+};
+
+// An element read of a Memory by a continuous assign. Rather than the
+// memory's trigger signal, which is posted by a write to any element, the
+// assign depends on the reader's own signal, which is only posted by a write
+// to the element it last read. Its local var is a MemWatch.
+
+class MemReader : public Scalar
+{
+public:
+    MemReader*  next;           // next reader of the same memory
+
+                MemReader(const char* name, Memory* mem, short disp) :
+                    Scalar(name, att_reg, disp)
+                            { this->isVisible = FALSE;
+                              this->assigned = TRUE;    // by memory writes
+                              this->next = mem->readers;
+                              mem->readers = this; }
+};
+
+// An instance's MemReader, linked into its memory's list of watches when the
+// instance's variables are initialized.
+
+struct MemWatch
+{
+    Signal*     signal;         // reader's signal
+    size_t      index;          // element index last read, or ~0 if none yet
+    MemWatch*   next;           // next watch on the same memory
+};
+
+// The start of an instance's Memory local var.
+
+struct MemHead
+{
+    Signal*     signal;         // trigger signal, for readers of any element
+    MemWatch*   watchers;       // watches of this memory's readers
 };
 
 // A node in a linked-list of nets
@@ -341,6 +390,7 @@ struct Expr
     static Expr*    next;       // next available expr node in pool
     static bool     gatherTriggers; // enables compileExpr to make triggers list
     static bool     conditionedTriggers; // TRUE if triggers are conditioned by any '@'s
+    static bool     watchMemReads;  // gives memory element reads MemReaders
     static NetList* curTriggers;    // list of trigger nets to current expr
     static bool     parmOnly;   // restricts compileExpr to a parameter expr
     static const char kPrecedence[];
@@ -372,6 +422,7 @@ struct Expr
 //          {
                 Range       range;      // vector's bit range
                 Expr*       index;      // memory's index
+                MemReader*  reader;     // memory read's reader, if any
 //          };
         } data;
         struct
@@ -460,6 +511,7 @@ public:
 
     void        initVariables(char* instModule, char* fullDesig);
     void        linkVariables(char* instModule, char* fullDesig);
+    void        addCkptPointers(char* instModule);
     virtual void addRetJmp(size_t* jmpAdr) { }
 
     static Scope* global;       // top-level scope
@@ -511,6 +563,7 @@ public:
     Net*        net;            // output signal (if k_assign)
     short       vecBaseBit;     // output bit range (if k_assign to a Vector)
     short       vecSize;
+    bool        sweepable;      // zero-delay assign that may be levelized
     Variable*   parm;           // output parameter (if k_parameter)
     NetList*    triggers;       // list of trigger signals
     EvHand*     modNext;        // next handler in module's list
@@ -561,6 +614,8 @@ public:
                                     vec->range->incr * (vecRange->left.bit -
                                             vec->range->left.bit);
                               eh->vecSize = vecRange->size; }
+    void        setSweepable(bool sweepable) // last handler may be levelized
+                            { this->evHandsE->sweepable = sweepable; }
     Net*        newInternNet(char idLet, VExType exType, Net* output,
                               const char* gateName, Range** range);
     void        codeNetDeclaration(NetAttr attr);
@@ -59,6 +59,31 @@ typedef size_t (Model::*ModelFuncPtr)(...);
 // Vector Signal:   An array of signal pointers. Register is a pointer
 //                  to this array.
 // Integer Memory:  An array of size_t integers. Register a pointer.
+// Word Vector:     A temp vector held as an LWord followed by its LVector
+//                  in local space.
+
+// A temp vector may be kept in word form, so that loads, logic and
+// arithmetic ops, and conversions to integers work on whole words when, as
+// nearly always, every bit is LV_L or LV_H. Its value words hold the LV_H
+// bits, least significant word first, each word MSB first as in
+// convLVecToInt(), so a vector of up to size_t bits takes one word. If known
+// is set, every bit is LV_L or LV_H and the LVector following the words may
+// be stale; otherwise the LVector holds the levels. convWordToLVec() brings
+// the LVector up to date.
+
+struct LWord
+{
+    size_t      known;      // TRUE if all bits are LV_L or LV_H
+    size_t      value[1];   // LV_H bits, nWords(nBits) words, LSW first
+
+    static size_t nWords(size_t nBits)
+                            { return (nBits + sizeof(size_t)*8 - 1) /
+                                     (sizeof(size_t)*8); }
+    static size_t size(size_t nBits)
+                            { return (1 + nWords(nBits)) * sizeof(size_t); }
+    Level*      levels(size_t nBits)
+                            { return (Level*)(value + nWords(nBits)); }
+};
 
 // a Parameter is only a constant at the time of instantiation, and
 // a variable may use a parameter for the width, which means that
@@ -79,6 +104,7 @@ public:
     VExType     type;       // data type
     int         scale;      // scaled-integer scale
     const char* name;       // name for debug dump
+    bool        isWord;     // vector is in word form, after an LWord
 
     void        display();
     bool        isType(VExTyCode t) { return this->type.code == t; }
@@ -96,7 +122,14 @@ public:
                                       this->type.size = size;
                                       this->scale = 1;
                                       this->vDisp = disp;
-                                      this->vValue = vec; }
+                                      this->vValue = vec;
+                                      this->isWord = FALSE; }
+    void        setWord(short size, size_t wordDisp)
+                                    { setVector(0, size, wordDisp +
+                                                LWord::size(size));
+                                      this->isWord = TRUE; }
+    size_t      wordDisp()          { return this->vDisp -
+                                             LWord::size(this->type.size); }
 
     friend void codeIntExpr(Expr* ex);
     friend void codeScalarExpr(Expr* ex);
@@ -120,11 +153,15 @@ struct VComp
     VError* tooComplexError;
     VError* stackEmpty;
     Instance* mainInstance;         // top instance: 'main'
+    Src*    projSrc;                // project file source
 
     Expr*   parms[max_parms];       // array of current compiled parameters
     clock_t startRealTime;          // start time of compilation
 
     Token*  srcLoc;     // the Verilog line being executed
+
+    int     nOpsCoded;      // module's P-code ops as coded
+    int     nOpsOptimized;  //   and after optimizePCode()
 };
 
 // ------------ Global Variables -------------
@@ -172,7 +209,8 @@ void codePostVector(Vector* vec, Range* select, Variable* extScopeRef,
 void codePost(Net* net, Range* range, Variable* extScopeRef,
               NetAttr attr, int nParms);
 
-void codeLoadMem(Memory* mem, Variable* extScopeRef = 0);
+void codeLoadMem(Memory* mem, Variable* extScopeRef = 0,
+                 MemReader* reader = 0);
 void codeStoMem(Memory* mem, Variable* extScopeRef = 0);
 
 void pushEmpData(int n = 1, const char* name = 0);
@@ -189,6 +227,7 @@ void codeExpr(Expr* ex);
 void codeIntExpr(Expr* ex);
 void codeScalarExpr(Expr* ex);
 void codeVectorExpr(Expr* ex, int bitWidth = -1);
+void codeLVecForm();
 void codeSplit(short nBits);
 void codeCall(Subr* subr, int nArgs, const char* name = 0, int nVariPreArgs = 0);
 void codeWait();
@@ -24,6 +24,7 @@
 #ifdef EXTENSION
 #include <Python.h>
 #endif
+#include <stddef.h>
 #include "PSignal.h"
 #include "Model.h"
 
@@ -33,6 +34,10 @@
 #include "VLCoder.h"
 #include "VLSysLib.h"
 #include "PCode.h"
+#include "Checkpoint.h"
+#include "NativeCode.h"
+#include "LVecOps.h"
+#include "MemPages.h"
 #include "PSignal.h"
 
 // P-code is much slower than native code, but has the big advantage of being
@@ -44,12 +49,16 @@ const int max_codeLen = 10000;
 PCode*  pc;             // current PCode being compiled
 PCode*  pcStart;        // compiled code area
 PCode*  pcEnd;          // end of compiled code area
+PCode*  pcSubr;         // start of subroutine being compiled
 int*    sp;             // run-time data stack
 VComp   vc;             // other Verilog compiler state
 
 const char* kExTypeName[ty_none+1]; // expression type code names
 const char* kPCodeName[p_last];     // P-code names
 
+static void codeWordExpr(Expr* ex);
+static void codeWordVectorExpr(Expr* ex, int bitWidth = -1);
+
 //-----------------------------------------------------------------------------
 // Initialize the compiler back end.
 
@@ -58,6 +67,7 @@ void initBackEnd()
     pcStart = 0;            // code space will be allocated as needed
     pc = 0;
     pcEnd = 0;
+    nativeClearSubrs();
     if (!vc.tooComplexError)        // create these only once:
     {
         vc.dataStk = new Data[max_dataStack];
@@ -96,6 +106,7 @@ void initBackEnd()
         kPCodeName[p_com] =         "com";
         kPCodeName[p_neg] =         "neg";
         kPCodeName[p_cvis] =        "cvis";
+        kPCodeName[p_ldl] =         "ldl";
         kPCodeName[p_end] =         "end";
 
         kPCodeName[p_liw] =         "liw";
@@ -137,6 +148,23 @@ void initBackEnd()
         kPCodeName[p_addi] =        "addi";
         kPCodeName[p_andi] =        "andi";
         kPCodeName[p_sbop] =        "sbop";
+        kPCodeName[p_ldsn] =        "ldsn";
+        kPCodeName[p_delw] =        "delw";
+        kPCodeName[p_leaw] =        "leaw";
+        kPCodeName[p_liw2] =        "liw2";
+        kPCodeName[p_bsr2w] =       "bsr2w";
+        kPCodeName[p_bsr3w] =       "bsr3w";
+        kPCodeName[p_bsr5w] =       "bsr5w";
+        kPCodeName[p_bsr2f] =       "bsr2f";
+        kPCodeName[p_stw] =         "stw";
+        kPCodeName[p_stk] =         "stk";
+        kPCodeName[p_addv] =        "addv";
+        kPCodeName[p_bfeq] =        "bfeq";
+        kPCodeName[p_bfne] =        "bfne";
+        kPCodeName[p_bfgt] =        "bfgt";
+        kPCodeName[p_bfle] =        "bfle";
+        kPCodeName[p_bflt] =        "bflt";
+        kPCodeName[p_bfge] =        "bfge";
     }
 }
 
@@ -167,7 +195,7 @@ void Data::display()
             ::display("s@%d", itemNo);
             break;
         case ty_vector:
-            ::display("v@%d(%d)", vDisp, type.size);
+            ::display("%c@%d(%d)", isWord ? 'w' : 'v', vDisp, type.size);
             break;
         case ty_memory:
             ::display("m@%d[%d]", vDisp, type.size);
@@ -198,7 +226,7 @@ void dumpCoderDataStack()
                 s = "sc";
                 break;
             case ty_vector:
-                s = "v";
+                s = (p->isWord ? "w" : "v");
                 //s = TmpName("v@%d(%d)", p->vDisp, p->type.size);
                 break;
             case ty_memory:
@@ -260,6 +288,7 @@ void initCodeArea()
     if (!pc || pc > pcEnd - max_codeLen)
     {
         CodeSpace* space = new CodeSpace;
+        ckptAddRegion(space->code, sizeof(space->code), FALSE);
         pcStart = (PCode*)space->code;
         pc = pcStart;
         pcEnd = pc + len_codeSpace;
@@ -282,6 +311,7 @@ void codeSubrHead(bool isTask)
     if (debugLevel(3))
         display("            #%2d subrHead\n", vc.dataStkEnd-vc.dsp);
     vc.dsp = vc.dataStkEnd;                     // reset data stack pointer
+    pcSubr = pc;
 }
 
 //-----------------------------------------------------------------------------
@@ -292,6 +322,9 @@ void codeSubrTail()
     if (debugLevel(3))
         display("            #%2d subrTail\n", vc.dataStkEnd-vc.dsp);
     codeOp(p_rts);
+    if (gOptimizePCode)
+        pc = optimizePCode(pcSubr, pc);
+    nativeAddSubr(pcSubr, pc);
 }
 
 //-----------------------------------------------------------------------------
@@ -302,6 +335,9 @@ void codeEndModule()
     if (debugLevel(3))
         display("            #%2d endModule\n", vc.dataStkEnd-vc.dsp);
     codeOp(p_end);
+    if (gOptimizePCode)
+        pc = optimizePCode(pcSubr, pc);
+    nativeAddSubr(pcSubr, pc);
 }
 
 //-----------------------------------------------------------------------------
@@ -690,7 +726,7 @@ size_t* codeCopyLVec(size_t srcDisp, size_t destDisp, size_t size)
     codeLoadAdr(destDisp);
     codeLoadAdr(srcDisp);
     codeLitInt(size);
-    codeCall((Subr*)memcpy, 3, "memcpy");
+    codeCall((Subr*)copyLVec, 3, "copyLVec");
     return destDispInstr;
 }
 
@@ -733,12 +769,12 @@ void codeLoadScalar(int disp, Variable* extScopeRef)
     {
         codeOpI(p_ld, extScopeRef->disp);
         codeOpI(p_ldx, disp);
-        codeOpI(p_ldbx, 0);
+        codeOp(p_ldl);
     }
     else if (disp >= 0x8000)
     {
         codeOpI(p_ld, disp);
-        codeOpI(p_ldbx, 0);
+        codeOp(p_ldl);
     }
     else
         codeOpW(p_lds, disp);
@@ -849,18 +885,105 @@ void codePostScalar(Scalar* lVal, Variable* extScopeRef,
     }
 }
 
+//-----------------------------------------------------------------------------
+// Return TRUE if a vector of nBits bits fits in one word. Loads and
+// constants of up to a word go straight to word form; wider ones are left
+// as LVectors until an op needs their words.
+
+static inline bool isWordSize(int nBits)
+{
+    return nBits <= (int)sizeof(size_t)*8;
+}
+
+// Allocate a word-form temp vector in local space, returning its LWord's
+// displacement. Its LVector follows the LWord.
+
+static size_t newLocalWord(int nBits)
+{
+    size_t wordDisp = Scope::local->newLocal(
+                            LWord::size(nBits) / sizeof(size_t),
+                            sizeof(size_t));
+    Scope::local->newLocal(nBits, sizeof(Level));
+    return wordDisp;
+}
+
+// Convert a stacked vector to word form, if it's in LVector form.
+
+static void codeWordForm(Data* dVec)
+{
+    if (dVec->isWord)
+        return;
+    int nBits = dVec->type.size;
+    size_t wordDisp = newLocalWord(nBits);
+    codeLoadAdr(dVec->vDisp);
+    codeLoadAdr(wordDisp);
+    codeLitInt(nBits);
+    codeCall((Subr*)convLVecToWord, 3, "convLVecToWord");
+    dVec->setWord(nBits, wordDisp);
+}
+
+// Convert the top stacked data to LVector form, if it's a word-form vector.
+// A void system call leaves nothing stacked.
+
+void codeLVecForm()
+{
+    if (vc.dsp >= vc.dataStkEnd)
+        return;
+    Data* dVec = vc.dsp;
+    if (!dVec->isType(ty_vector) || !dVec->isWord)
+        return;
+    codeLoadAdr(dVec->wordDisp());
+    codeLitInt(dVec->type.size);
+    codeCall((Subr*)convWordToLVec, 2, "convWordToLVec");
+    dVec->isWord = FALSE;
+}
+
+// Change the width of the top stacked word-form vector.
+
+static void codeResizeWord(int nBits)
+{
+    Data* dVec = vc.dsp;
+    int srcBits = dVec->type.size;
+    if (srcBits == nBits)
+        return;
+    size_t wordDisp = newLocalWord(nBits);
+    // void resizeWord(LWord* src, int srcBits, LWord* dest, int destBits)
+    codeLoadAdr(dVec->wordDisp());
+    codeLitInt(srcBits);
+    codeLoadAdr(wordDisp);
+    codeLitInt(nBits);
+    codeCall((Subr*)resizeWord, 4, "resizeWord");
+    vc.dsp->setWord(nBits, wordDisp);
+}
+
 //-----------------------------------------------------------------------------
 // Code a load of an LVector.
 
 void codeLitLVec(Variable* levVec, Variable* extScopeRef)
 {
-    // Copy an LVector from variable to a temp local var space.
+    // A known constant of up to size_t bits is set up in word form.
+    int nBits = levVec->exType.size;
+    size_t nHigh;
+    if (isWordSize(nBits) &&
+        gLVecOps->countHigh(levVec->levelVec, nBits, &nHigh))
+    {
+        size_t wordDisp = newLocalWord(nBits);
+        codeLitInt(convLVecToInt(levVec->levelVec, nBits));
+        codeLoadAdr(wordDisp);
+        codeLitInt(nBits);
+        codeCall((Subr*)convIntToWord, 3, "convIntToWord");
+        pushEmpData();
+        vc.dsp->setWord(nBits, wordDisp);
+        return;
+    }
+
+    // Otherwise copy an LVector from variable to a temp local var space.
     size_t levVecDisp = Scope::local->newLocal(levVec->exType.size,
                                                sizeof(Level));
     codeLoadAdr(levVecDisp);                // destination
     codeLoadAdr(levVec->disp, extScopeRef); // source
     codeLitInt(levVec->exType.size);        // length
-    codeCall((Subr*)memcpy, 3, "memcpy");
+    codeCall((Subr*)copyLVec, 3, "copyLVec");
 
     pushEmpData();
     vc.dsp->setVector(0, levVec->exType.size, levVecDisp);
@@ -975,6 +1098,18 @@ void codeLoadVector(Vector* vec, Range* select, Variable* extScopeRef)
         codeCallFn((Func*)loadIndScalar, 3);
         vc.dsp->setScalarReg();
     }
+    else if (isWordSize(select->size)) // or load a word-form temp
+    {
+        int nBits = select->size;
+        size_t wordDisp = newLocalWord(nBits);
+        codeLoadAdr(wordDisp);
+        codeLitInt(nBits);
+        // code call: void loadIndWord(SignalVec* sigVec, int i, int iMax,
+        //                             LWord* word, int nBits)
+        codeCall((Subr*)loadIndWord, 5, "loadIndWord");
+        pushEmpData();
+        vc.dsp->setWord(nBits, wordDisp);
+    }
     else // or code a part select and load vector into temp area
     {
         int nBits = select->size;
@@ -1139,11 +1274,28 @@ void codePost(Net* net, Range* range, Variable* extScopeRef,
 
 //-----------------------------------------------------------------------------
 // Code a load of a memory element as an integer to the stack.
-// Index is expected on the stack.
+// Index is expected on the stack. A paged memory's element is looked up
+// through its page table. If the read has a reader, the index is first
+// noted in its watch.
 
-void codeLoadMem(Memory* mem, Variable* extScopeRef)
+void codeLoadMem(Memory* mem, Variable* extScopeRef, MemReader* reader)
 {
-    // *4 for int index, +4 to skip over trigger signal pointer
+    if (reader)
+    {
+        codeDup();
+        codeStoInt(reader->disp + offsetof(MemWatch, index), 0);
+    }
+
+    if (mem->isPaged())
+    {
+        // code call: size_t loadMemPage(int i, MemPages* mem)
+        codeLoadInt(mem->disp + sizeof(MemHead), extScopeRef);
+        codeCallFn((Func*)loadMemPage, 2);
+        vc.dsp->setIntReg(mem->elemBits());
+        return;
+    }
+
+    // *4 for int index, then skip over memory's head
     codeLitInt(sizeof(size_t) == 8 ? 3 : 2);
     codeOp2(p_sla);
     if (extScopeRef)
@@ -1151,33 +1303,52 @@ void codeLoadMem(Memory* mem, Variable* extScopeRef)
     else
         codeOp(p_leai);
     codeOp(p_add);
-    codeOpI(p_ldx, mem->disp + sizeof(size_t));
-    vc.dsp->setIntReg(mem->elemRange ? mem->elemRange->size : sizeof(size_t)*8);
+    codeOpI(p_ldx, mem->disp + sizeof(MemHead));
+    vc.dsp->setIntReg(mem->elemBits());
 }
 
 //-----------------------------------------------------------------------------
 // Compile a write of an integer value to a memory.
 // The memory address was pushed first on the dsp stack;
 //
-// !!! size_t integer width only for now
+// A memory in instance storage holds size_t integers; a paged memory
+// truncates the value to its element width.
 
 void codeStoMem(Memory* mem, Variable* extScopeRef)
 {
-    // *4 for int index, +4 to skip over trigger signal pointer
+    // keep a copy of the index under the store's operands
+    codePick(1);
     codeOp(p_swap);
-    codeLitInt(sizeof(size_t) == 8 ? 3 : 2);
-    codeOp2(p_sla);
-    if (extScopeRef)
-        codeOpI(p_ld, extScopeRef->disp);
+
+    if (mem->isPaged())
+    {
+        // code call: void stoMemPage(int i, size_t value, MemPages* mem)
+        codeLoadInt(mem->disp + sizeof(MemHead), extScopeRef);
+        codeCall((Subr*)stoMemPage, 3, "stoMemPage");
+    }
     else
-        codeOp(p_leai);
-    codeOp(p_add);
-    codeOpI(p_stx, mem->disp + sizeof(size_t));
-    dropData(2);
+    {
+        // *4 for int index, then skip over memory's head
+        codeOp(p_swap);
+        codeLitInt(sizeof(size_t) == 8 ? 3 : 2);
+        codeOp2(p_sla);
+        if (extScopeRef)
+            codeOpI(p_ld, extScopeRef->disp);
+        else
+            codeOp(p_leai);
+        codeOp(p_add);
+        codeOpI(p_stx, mem->disp + sizeof(MemHead));
+        dropData(2);
+    }
 
-    // now post an event to the memory's model signal to notify readers
-    // of a possible data change.
-    codePostNamedEvent(mem, extScopeRef);
+    // now notify the readers of that element, and any readers of the whole
+    // memory, of a possible data change.
+    // code call: void postMemWrite(Model* model, size_t i, MemHead* head)
+    codeModelCallPrefix();
+    codeOp(p_swap);
+    codeLoadAdr(mem->disp, extScopeRef);
+    codeCall((Subr*)postMemWrite, 3, "postMemWrite");
+    mem->assigned = TRUE;
 }
 
 //-----------------------------------------------------------------------------
@@ -1187,6 +1358,17 @@ void codeVectorUnaryOp(const Level* table)
 {
     Data* arg = vc.dsp;
     int nBits = arg->type.size;
+    if (table == funcTable.INVERTtable)
+    {
+        codeWordForm(arg);
+        size_t wordDisp = newLocalWord(nBits);
+        codeLoadAdr(arg->wordDisp());   // src word
+        codeLoadAdr(wordDisp);          // dest word
+        codeLitInt(nBits);              // size
+        codeCall((Subr*)comWord, 3, "comWord");
+        vc.dsp->setWord(nBits, wordDisp);
+        return;
+    }
     size_t levVecDisp = Scope::local->newLocal(nBits, sizeof(Level));
     codeLoadAdr(arg->vDisp);        // src vector
     codeLoadAdr(levVecDisp);        // dest vector
@@ -1205,11 +1387,42 @@ void codeScalarBinaryOp(const Level* table)
     dropData();
 }
 
-void codeVectorBinaryOp(const Level* table)
+//-----------------------------------------------------------------------------
+// Code a binary operation on the top two stacked vectors, of equal width, in
+// word form. The top vector is the second operand.
+
+static void codeWordBinaryOp(Subr* wordOp, const char* name)
+{
+    Data* arg1 = vc.dsp;
+    Data* arg0 = vc.dsp + 1;
+    int nBits = arg0->type.size;
+    codeWordForm(arg0);
+    codeWordForm(arg1);
+    size_t wordDisp = newLocalWord(nBits);
+    // void ..Word(LWord* src0, LWord* src1, LWord* dest, int nBits)
+    codeLoadAdr(arg0->wordDisp());  // src 0 word
+    codeLoadAdr(arg1->wordDisp());  // src 1 word
+    codeLoadAdr(wordDisp);          // dest word
+    codeLitInt(nBits);              // size
+    codeCall(wordOp, 4, name);
+    dropData();
+    vc.dsp->setWord(nBits, wordDisp);
+}
+
+//-----------------------------------------------------------------------------
+// Code a binary logical operation on two vectors, in word form if wordOp is
+// given, or else as LVectors. Op uses table.
+
+void codeVectorBinaryOp(const Level* table, Subr* wordOp, const char* name)
 {
     Data* arg0 = vc.dsp;
     Data* arg1 = vc.dsp + 1;
     int nBits = arg0->type.size;
+    if (wordOp)
+    {
+        codeWordBinaryOp(wordOp, name);
+        return;
+    }
     size_t levVecDisp = Scope::local->newLocal(nBits, sizeof(Level));
     // void binaryOpLVec(Level* src0, Level* src1, Level* dest, int nBits,
     //                  Level table[12][16])
@@ -1223,6 +1436,119 @@ void codeVectorBinaryOp(const Level* table)
     vc.dsp->setVector(0, nBits, levVecDisp);
 }
 
+//-----------------------------------------------------------------------------
+// Return the width of the widest vector operand of a binary expression if
+// it's too wide for an integer, else 0.
+
+static int wideOperandBits(Expr* arg0, Expr* arg1)
+{
+    int nBits = 0;
+    if (arg0->tyCode == ty_vector)
+        nBits = arg0->nBits;
+    if (arg1->tyCode == ty_vector && arg1->nBits > nBits)
+        nBits = arg1->nBits;
+    return (isWordSize(nBits) ? 0 : nBits);
+}
+
+// Code an operand of a wide arithmetic operation as a word-form vector of
+// nBits bits.
+
+static void codeWideOperand(Expr* ex, int nBits)
+{
+    if (ex->tyCode == ty_vector)
+    {
+        codeWordVectorExpr(ex);
+        codeWordForm(vc.dsp);
+        codeResizeWord(nBits);
+    }
+    else
+        codeWordVectorExpr(ex, nBits);
+}
+
+//-----------------------------------------------------------------------------
+// Code an arithmetic, shift, or compare operation on vectors too wide for
+// integers, as word-form vectors nBits wide. Adds, subtracts, multiplies,
+// and shifts leave a word-form vector; compares leave an integer.
+
+static void codeWideOp(PCodeOp op, Expr* arg0, Expr* arg1, int nBits)
+{
+    switch (op)
+    {
+        case p_add:
+            codeWideOperand(arg0, nBits);
+            codeWideOperand(arg1, nBits);
+            codeWordBinaryOp((Subr*)addWord, "addWord");
+            break;
+        case p_sub:
+            codeWideOperand(arg0, nBits);
+            codeWideOperand(arg1, nBits);
+            codeWordBinaryOp((Subr*)subWord, "subWord");
+            break;
+        case p_mul:
+            codeWideOperand(arg0, nBits);
+            codeWideOperand(arg1, nBits);
+            codeWordBinaryOp((Subr*)mulWord, "mulWord");
+            break;
+
+        case p_sla:
+        case p_sra:
+        {
+            codeWideOperand(arg0, nBits);
+            Data* src = vc.dsp;
+            // an integer shift count was converted up to arg0's type
+            if (arg1->opcode == op_conv && arg1->arg[0]->tyCode == ty_int)
+                arg1 = arg1->arg[0];
+            codeIntExpr(arg1);
+            size_t srcDisp = src->wordDisp();
+            size_t wordDisp = newLocalWord(nBits);
+            // void s..Word(int count, LWord* src, LWord* dest, int nBits)
+                                            // count
+            codeLoadAdr(srcDisp);           // src word
+            codeLoadAdr(wordDisp);          // dest word
+            codeLitInt(nBits);              // size
+            if (op == p_sla)
+                codeCall((Subr*)slaWord, 4, "slaWord");
+            else
+                codeCall((Subr*)sraWord, 4, "sraWord");
+            vc.dsp->setWord(nBits, wordDisp);
+            break;
+        }
+
+        case p_eq:
+        case p_ne:
+        case p_gt:
+        case p_le:
+        case p_lt:
+        case p_ge:
+        {
+            codeWideOperand(arg0, nBits);
+            codeWideOperand(arg1, nBits);
+            size_t disp0 = vc.dsp[1].wordDisp();
+            size_t disp1 = vc.dsp[0].wordDisp();
+            // int cmpWord(LWord* src0, LWord* src1, int nBits)
+            codeLoadAdr(disp0);
+            codeLoadAdr(disp1);
+            codeLitInt(nBits);
+            codeCallFn((Func*)cmpWord, 3);
+            // drop the operands, which aren't in registers, from under the
+            // result, then turn the 0, 1, or 2 result into the relation
+            Data result = *vc.dsp;
+            dropData(3);
+            pushEmpData();
+            *vc.dsp = result;
+            codeLitInt(1);
+            codeOp2(op);
+            break;
+        }
+
+        default:
+            throw new VError(verr_notYet,
+                        "can't do that operation on >%d bits yet",
+                        sizeof(size_t)*8);
+            break;
+    }
+}
+
 //-----------------------------------------------------------------------------
 // Code a vector-concatenation function. Expression is in the form of a 
 // system function call, with an argument list of expressions to be
@@ -1230,12 +1556,71 @@ void codeVectorBinaryOp(const Level* table)
 
 void codeConcat(Expr* ex)
 {
-    // code each of the source expressions, keeping track of the current
-    // result vector bit total and locations of each result store instr
     if (debugLevel(3))
         display("            #%2d concat(\n", vc.dataStkEnd-vc.dsp);
-    int bit = 0;
     Expr* ap;
+
+    // if all the parts are scalars or vectors, their widths give the result
+    // width up front, so the parts can be packed into a word-form result
+    int nBits = 0;
+    for (ap = ex; ap; ap = ap->func.nextArgNode)
+    {
+        Expr* argEx = ap->func.arg;
+        if (argEx->tyCode == ty_scalar)
+            nBits++;
+        else if (argEx->tyCode == ty_vector)
+            nBits += argEx->nBits;
+        else
+            break;
+    }
+    if (!ap)
+    {
+        size_t destDisp = newLocalWord(nBits);
+        codeLitInt(0);
+        codeLoadAdr(destDisp);
+        codeLitInt(nBits);
+        codeCall((Subr*)convIntToWord, 3, "convIntToWord");
+        int lsb = nBits;
+        for (ap = ex; ap; ap = ap->func.nextArgNode)
+        {
+            Expr* argEx = ap->func.arg;
+            if (argEx->tyCode == ty_scalar)
+            {
+                codeScalarExpr(argEx);
+                lsb--;
+                // void catLevelWord(Level level, LWord* dest, int destBits,
+                //                   int lsb)
+                codeLoadAdr(destDisp);
+                codeLitInt(nBits);
+                codeLitInt(lsb);
+                codeCall((Subr*)catLevelWord, 4, "catLevelWord");
+            }
+            else
+            {
+                int argSize = argEx->nBits;
+                codeWordVectorExpr(argEx, argSize);
+                codeWordForm(vc.dsp);
+                lsb -= argSize;
+                // void catWord(LWord* part, int nBits, LWord* dest,
+                //              int destBits, int lsb)
+                codeLoadAdr(vc.dsp->wordDisp());
+                codeLitInt(argSize);
+                codeLoadAdr(destDisp);
+                codeLitInt(nBits);
+                codeLitInt(lsb);
+                codeCall((Subr*)catWord, 5, "catWord");
+                dropData();
+            }
+        }
+        pushEmpData();
+        vc.dsp->setWord(nBits, destDisp);
+        return;
+    }
+
+    // otherwise code each of the source expressions, keeping track of the
+    // current result vector bit total and locations of each result store
+    // instr
+    int bit = 0;
     for (ap = ex; ap; ap = ap->func.nextArgNode)
     {
         Expr* argEx = ap->func.arg;
@@ -1312,9 +1697,20 @@ void codeIntExpr(Expr* ex)
         }
         codeLitInt(value, scale);
     }
+    else if (ex->opcode == op_load && ex->tyCode == ty_vector &&
+             !ex->data.range.isScalar && isWordSize(ex->data.range.size))
+    {
+        // load a vector's bits straight into an integer
+        codeVecRange((Vector*)ex->data.var, &ex->data.range,
+                     ex->data.extScopeRef);
+        codeLitInt(ex->data.range.size);
+        // code call: size_t loadIndInt(SignalVec* sigVec, int i, int iMax,
+        //                              int nBits)
+        codeCallFn((Func*)loadIndInt, 4);
+    }
     else
     {
-        codeExpr(ex);
+        codeWordExpr(ex);
         if (!vc.dsp->isType(ty_int))
         {
             size_t disp, size;
@@ -1327,6 +1723,13 @@ void codeIntExpr(Expr* ex)
                 case ty_vector:
                     if (vc.dsp->type.size > sizeof(size_t)*8)
                         goto tooLarge;
+                    if (vc.dsp->isWord)
+                    {                   // a word's value is the integer
+                        disp = vc.dsp->wordDisp() + offsetof(LWord, value);
+                        dropData();
+                        codeLoadInt(disp);
+                        break;
+                    }
                     disp = vc.dsp->vDisp;
                     size = vc.dsp->type.size;
                     dropData();
@@ -1414,6 +1817,25 @@ void codeScalarExpr(Expr* ex)
 // A bitWidth of -1 means unknown width.
 
 void codeVectorExpr(Expr* ex, int bitWidth)
+{
+    codeWordVectorExpr(ex, bitWidth);
+    codeLVecForm();
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if an expression opcode is an arithmetic or shift op.
+
+static inline bool isArithOp(ExOpCode opcode)
+{
+    return (opcode == op_add || opcode == op_sub || opcode == op_mul ||
+            opcode == op_sla || opcode == op_sra);
+}
+
+//-----------------------------------------------------------------------------
+// Code an expression returning a vector of given size as stacked data, where
+// the vector may be left in word form.
+
+static void codeWordVectorExpr(Expr* ex, int bitWidth)
 {
     if (debugLevel(3))
         display("            #%2d vectorExpr(\n", vc.dataStkEnd-vc.dsp);
@@ -1457,9 +1879,14 @@ void codeVectorExpr(Expr* ex, int bitWidth)
     }
     else
     {
-        codeExpr(ex);
+        codeWordExpr(ex);
         if (vc.dsp->isType(ty_vector))
         {
+            // a wide arithmetic result is sized to its widest operand, so
+            // it's truncated or extended to fit, as an integer would be
+            if (bitWidth != -1 && (int)vc.dsp->type.size != bitWidth &&
+                vc.dsp->isWord && isArithOp(ex->opcode))
+                codeResizeWord(bitWidth);
             if (bitWidth != -1 && (int)vc.dsp->type.size != bitWidth)
                 throw new VError(ex->srcLoc, verr_illegal,
                             "%d-bit data size doesn't match %d-bit"
@@ -1473,14 +1900,13 @@ void codeVectorExpr(Expr* ex, int bitWidth)
                 {
                     if (bitWidth == -1)
                         bitWidth = vc.dsp->type.size;
-                    size_t levVecDisp = Scope::local->newLocal(bitWidth,
-                                                               sizeof(Level));
-                                                    // src integer
-                    codeLoadAdr(levVecDisp);        // dest vector
-                    codeLitInt(bitWidth);           // size
-                    codeCall((Subr*)convIntToLVec, 3, "convIntToLVec");
+                    size_t wordDisp = newLocalWord(bitWidth);
+                                                // src integer
+                    codeLoadAdr(wordDisp);      // dest word
+                    codeLitInt(bitWidth);       // size
+                    codeCall((Subr*)convIntToWord, 3, "convIntToWord");
                     pushEmpData();
-                    vc.dsp->setVector(0, bitWidth, levVecDisp);
+                    vc.dsp->setWord(bitWidth, wordDisp);
                     break;
                 }
                 default:
@@ -1509,14 +1935,23 @@ void codeReducedIntExpr(Expr* ex)
 
 void codeReducedVectExpr(Expr* ex)
 {
-    codeVectorExpr(ex);
+    codeWordVectorExpr(ex);
     Data dVec = *vc.dsp;
     dropData();
 
-    // code a call to "Level u..LVec(Level* levVec, int nBits)"
-    codeLoadAdr(dVec.vDisp);
-    codeLitInt(dVec.type.size);
-    codeCallFn((Func*)uorLVec, 2);
+    // code a call to "Level uor..(Level* levVec or LWord* word, int nBits)"
+    if (dVec.isWord)
+    {
+        codeLoadAdr(dVec.wordDisp());
+        codeLitInt(dVec.type.size);
+        codeCallFn((Func*)uorWord, 2);
+    }
+    else
+    {
+        codeLoadAdr(dVec.vDisp);
+        codeLitInt(dVec.type.size);
+        codeCallFn((Func*)uorLVec, 2);
+    }
     vc.dsp->setScalarReg();
 }
 
@@ -1524,9 +1959,20 @@ void codeReducedVectExpr(Expr* ex)
 // Code an expression returning stacked data.
 
 void codeExpr(Expr* ex)
+{
+    codeWordExpr(ex);
+    codeLVecForm();
+}
+
+//-----------------------------------------------------------------------------
+// Code an expression returning stacked data, where a vector may be left in
+// word form.
+
+static void codeWordExpr(Expr* ex)
 {
     const Level* table;
     size_t (*unaryFn)(Level*, size_t);
+    size_t (*unaryWordFn)(LWord*, size_t);
     ExOpCode opcode = ex->opcode;
     if (debugLevel(3))
         display("            #%2d expr(op=%d\n",
@@ -1578,7 +2024,8 @@ void codeExpr(Expr* ex)
                 {
                     codeIntExpr(ex->data.index);
                     Memory* mem = (Memory*)ex->data.var;
-                    codeLoadMem(mem, ex->data.extScopeRef);
+                    codeLoadMem(mem, ex->data.extScopeRef,
+                                ex->data.reader);
                     break;
                 }
                 default:
@@ -1600,7 +2047,7 @@ void codeExpr(Expr* ex)
                     codeScalarExpr(ex->arg[0]);
                     break;
                 case ty_vector:
-                    codeVectorExpr(ex->arg[0], ex->nBits);
+                    codeWordVectorExpr(ex->arg[0], ex->nBits);
                     break;
 
                 default:
@@ -1661,7 +2108,7 @@ void codeExpr(Expr* ex)
                     // bitwise unary compliment -- examples:
                     // ~0 -> 1, ~1234 -> 813, ~16'h1234 -> 16'hEDCB
                     table = funcTable.INVERTtable;
-                    codeExpr(arg0);
+                    codeWordExpr(arg0);
                     switch (arg0->tyCode)
                     {
                         case ty_int:
@@ -1691,31 +2138,46 @@ void codeExpr(Expr* ex)
 
                 case op_uand:
                     unaryFn = uandLVec;
+                    unaryWordFn = uandWord;
                     goto unaryLogical;
 
                 case op_unand:
                     unaryFn = unandLVec;
+                    unaryWordFn = unandWord;
                     goto unaryLogical;
 
                 case op_uor:
                     unaryFn = uorLVec;
+                    unaryWordFn = uorWord;
                     goto unaryLogical;
 
                 case op_unor:
                     unaryFn = unorLVec;
+                    unaryWordFn = unorWord;
                     goto unaryLogical;
 
                 case op_uxor:
                     unaryFn = uxorLVec;
+                    unaryWordFn = uxorWord;
                 unaryLogical:
                 {
-                    codeVectorExpr(ex->arg[0]);
+                    codeWordVectorExpr(ex->arg[0]);
                     Data dVec = *vc.dsp;
                     dropData();
                     // code a call to "Level u..LVec(Level* levVec, int nBits)"
-                    codeLoadAdr(dVec.vDisp);
-                    codeLitInt(dVec.type.size);
-                    codeCallFn((Func*)unaryFn, 2);
+                    // or "Level u..Word(LWord* word, int nBits)"
+                    if (dVec.isWord)
+                    {
+                        codeLoadAdr(dVec.wordDisp());
+                        codeLitInt(dVec.type.size);
+                        codeCallFn((Func*)unaryWordFn, 2);
+                    }
+                    else
+                    {
+                        codeLoadAdr(dVec.vDisp);
+                        codeLitInt(dVec.type.size);
+                        codeCallFn((Func*)unaryFn, 2);
+                    }
                     vc.dsp->setScalarReg();
                     break;
                 }
@@ -1731,6 +2193,9 @@ void codeExpr(Expr* ex)
         Expr* arg0 = ex->arg[0];
         Expr* arg1 = ex->arg[1];
         PCodeOp op;
+        Subr* wordOp;
+        const char* wordOpName;
+        int nWideBits;
         switch (opcode)
         {
             case op_add:
@@ -1769,6 +2234,12 @@ void codeExpr(Expr* ex)
             case op_ge:
                 op = p_ge;
             binaryInts:
+                nWideBits = wideOperandBits(arg0, arg1);
+                if (nWideBits)
+                {
+                    codeWideOp(op, arg0, arg1, nWideBits);
+                    break;
+                }
                 codeIntExpr(arg0);
                 codeIntExpr(arg1);
                 codeOp2(op);
@@ -1777,14 +2248,20 @@ void codeExpr(Expr* ex)
             case op_band:
                 op = p_and;
                 table = &funcTable.ANDtable[0][0];
+                wordOp = (Subr*)andWord;
+                wordOpName = "andWord";
                 goto binary;
             case op_bor:
                 op = p_or;
                 table = &funcTable.ORtable[0][0];
+                wordOp = (Subr*)orWord;
+                wordOpName = "orWord";
                 goto binary;
             case op_bxor:
                 op = p_xor;
                 table = &funcTable.XORtable[0][0];
+                wordOp = (Subr*)xorWord;
+                wordOpName = "xorWord";
                 goto binary;
 
             binary:
@@ -1807,9 +2284,10 @@ void codeExpr(Expr* ex)
 
                             case ty_vector:
                             case ty_memory:
-                                codeVectorExpr(arg0, arg1->nBits);
-                                codeVectorExpr(arg1, arg1->nBits);
-                                codeVectorBinaryOp(table); // (i->v) op (v,m->v)
+                                codeWordVectorExpr(arg0, arg1->nBits);
+                                codeWordVectorExpr(arg1, arg1->nBits);
+                                codeVectorBinaryOp(table, wordOp, wordOpName);
+                                                    // (i->v) op (v,m->v)
                                 break;
 
                             default:
@@ -1831,9 +2309,10 @@ void codeExpr(Expr* ex)
 
                             case ty_vector:
                             case ty_memory:
-                                codeVectorExpr(arg0, arg1->nBits);
-                                codeVectorExpr(arg1, arg1->nBits);
-                                codeVectorBinaryOp(table); // (s->v) op (v,m->v)
+                                codeWordVectorExpr(arg0, arg1->nBits);
+                                codeWordVectorExpr(arg1, arg1->nBits);
+                                codeVectorBinaryOp(table, wordOp, wordOpName);
+                                                    // (s->v) op (v,m->v)
                                 break;
 
                             default:
@@ -1845,9 +2324,10 @@ void codeExpr(Expr* ex)
 
                     case ty_vector:
                     case ty_memory:
-                            codeVectorExpr(arg0, arg1->nBits);
-                            codeVectorExpr(arg1, arg1->nBits);
-                            codeVectorBinaryOp(table); // (v,m->v) op (i,s,m->v)
+                            codeWordVectorExpr(arg0, arg1->nBits);
+                            codeWordVectorExpr(arg1, arg1->nBits);
+                            codeVectorBinaryOp(table, wordOp, wordOpName);
+                                                // (v,m->v) op (i,s,m->v)
                         break;
 
                     default:
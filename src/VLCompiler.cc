@@ -32,6 +32,12 @@
 #include "VLSysLib.h"
 #include "VLCoder.h"
 #include "VLCompiler.h"
+#include "Checkpoint.h"
+#include "TestChoices.h"
+#include "Profile.h"
+#include "NativeCode.h"
+#include "LVecOps.h"
+#include "DesignCache.h"
 
 bool gVerilogInstantiated;
 
@@ -42,6 +48,7 @@ void initVerilog()
 {
     vc.tooComplexError = 0;
     vc.startRealTime = clock();
+    selectLVecOps();
     initBackEnd();
     initExprPool();
     gWarningCount = 0;
@@ -122,28 +129,40 @@ Signal* expectSignalFor(const char* use)
 }
 
 //-----------------------------------------------------------------------------
-// Parse a PVSim project file: set duration, compile Verilog files, and go
-// simulate.
+// Define the macros for a test choice, or for none if testChoice is 0.
 
-void loadProjectFile(const char *fileName, const char* testChoice)
+void defineTestChoice(const char* testChoice)
+{
+    if (testChoice)
+    {
+        new Macro(newString(testChoice), "", vc.projSrc);
+        new Macro("TEST_CHOICE", TmpName("\"%s\"", testChoice), vc.projSrc);
+    }
+    else
+        new Macro("TEST_CHOICE", "", vc.projSrc);
+}
+
+//-----------------------------------------------------------------------------
+// Parse a PVSim project file: set duration and compile Verilog files.
+
+static void compileProjectFile(const char *fileName, const char* testChoice)
 {
     initVerilog();
     gScToken = 0;
+    startSrcStamps();
 
     Src* projSrc = new Src(newString(fileName), sm_forth + sm_stripComments, 0);
+    vc.projSrc = projSrc;
 
     new Macro("SIMULATOR", "1", projSrc);
-    if (testChoice)
-    {
-        new Macro(testChoice, "", projSrc);
-        new Macro("TEST_CHOICE", TmpName("\"%s\"", testChoice), projSrc);
-    }
-    else
-        new Macro("TEST_CHOICE", "", projSrc);
+    if (!gTestWorkers)              // (else each test worker defines its own)
+        defineTestChoice(testChoice);
 
     projSrc->tokenize();
+    ckptMarkStrings();
     VL::baseSrc = projSrc;
     gVerilogInstantiated = FALSE;
+    gEventMemLimit = gCmdEventMemLimit; // a prior project's cap doesn't carry
 
     do                  // main parsing loop
     {
@@ -154,6 +173,66 @@ void loadProjectFile(const char *fileName, const char* testChoice)
             expect(NUMBER_TOKEN);
             gNSDuration = gScToken->number;
         }
+        else if (isName("eventMemLimit"))
+        {
+            // set event pool memory limit, in MB
+            scan();
+            expect(NUMBER_TOKEN);
+            gEventMemLimit = (size_t)gScToken->number << 20;
+        }
+        else if (isName("levelize"))
+        {
+            // evaluate zero-delay assigns in one sweep per tick
+            gLevelize = TRUE;
+        }
+        else if (isName("nooptimize"))
+        {
+            // run P-code as coded, without the optimizer passes
+            gOptimizePCode = FALSE;
+        }
+        else if (isName("native"))
+        {
+            // run P-code compiled to a native library, in an optional "dir"
+            gNativeCode = TRUE;
+            if (gScToken->next && gScToken->next->tokCode == STRING_TOKEN)
+            {
+                scan();
+                strncpy(gNativeDir, gScToken->name, max_nameLen-1);
+            }
+        }
+        else if (isName("profile"))
+        {
+            // count activity per signal and model, and list the top N
+            gProfile = TRUE;
+            if (gScToken->next && gScToken->next->tokCode == NUMBER_TOKEN)
+            {
+                scan();
+                if (gScToken->number > 0)
+                    gProfileTopN = (int)gScToken->number;
+            }
+        }
+        else if (isName("telemetry"))
+        {
+            // sample the event scheduler's state every given ns
+            scan();
+            expect(NUMBER_TOKEN);
+            gTelemetryNS = gScToken->number;
+        }
+        else if (isName("checkpoint"))
+        {
+            // write simulation state to <project>.ckpt at a given time
+            scan();
+            expect(NUMBER_TOKEN);
+            gCheckpointNS = gScToken->number;
+        }
+        else if (isName("restore"))
+        {
+            // resume simulation from a checkpoint file
+            scan();
+            if (!(isToken(NAME_TOKEN) || isToken(STRING_TOKEN)))
+                expectNameOf("checkpoint file");
+            strncpy(gRestoreFileName, gScToken->name, max_nameLen-1);
+        }
         else if (isName("debug"))
         {
             // set debug level
@@ -176,6 +255,7 @@ void loadProjectFile(const char *fileName, const char* testChoice)
             if (!(isToken(NAME_TOKEN) || isToken(STRING_TOKEN)))
                 expectNameOf("shell command");
             display("executing \"%s\"\n", gScToken->name);
+            invalidateSrcStamps();
 #if 0
             int result = system(gScToken->name);
 #else
@@ -202,7 +282,7 @@ void loadProjectFile(const char *fileName, const char* testChoice)
             instantiateVerilogIfNeeded();
             Signal* signal = expectSignalFor("signal to trace");
             signal->is |= TRACED + DISPLAYED;
-            display("// *** tracing signal '%s'\n", signal->name);
+            display("// *** tracing signal '%s'\n", signal->name());
         }
         else if (isName("hide"))
         {
@@ -211,11 +291,11 @@ void loadProjectFile(const char *fileName, const char* testChoice)
             Signal* signal = expectSignalFor("signal to hide");
             signal->is &= ~DISPLAYED;
             // if it's a bus signal ("Foo[7:0]"), hide its sub-signals
-            const char* p = signal->name + strlen(signal->name) - 1;
+            const char* p = signal->name() + strlen(signal->name()) - 1;
             if (*p == ']')
             {
                 const char* pR = 0;
-                for (; p > signal->name && *p != '['; p--)
+                for (; p > signal->name() && *p != '['; p--)
                 {
                     if (*p == ':')
                     {
@@ -232,8 +312,8 @@ void loadProjectFile(const char *fileName, const char* testChoice)
                         iR = iL;
                         iL = i;
                     }
-                    char* name = newString(signal->name);
-                    char* pSub = name + (p + 1 - signal->name);
+                    char* name = newString(signal->name());
+                    char* pSub = name + (p + 1 - signal->name());
                     for (int i = iR; i <= iL; i++)
                     {
                         snprintf(pSub, sizeof(pSub), "%d]", i);
@@ -262,11 +342,23 @@ void loadProjectFile(const char *fileName, const char* testChoice)
             instantiateVerilogIfNeeded();
             gBreakSignal = expectSignalFor("break signal");
         }
+        else if (isName("cache"))
+        {
+            // cache the compiled design, in an optional "dir" (read before
+            // compiling, by readDesignCache())
+            if (gScToken->next && gScToken->next->tokCode == STRING_TOKEN)
+                scan();
+        }
         else if (isName("testChoice"))
         {
             // choice from Simulation menu has been passed to Simulate()
             scan();
         }
+        else if (isName("test_choice"))
+        {
+            // declares a choice for the Simulation menu and for -a
+            scan();
+        }
         else if (!gScToken)
             throw new VError(verr_notFound, "empty psim file");
         else
@@ -280,6 +372,26 @@ void loadProjectFile(const char *fileName, const char* testChoice)
     } while (gScToken && scan());
 
     instantiateVerilogIfNeeded();
+    endSrcStamps();
+    saveTimeFormat();
+}
+
+//-----------------------------------------------------------------------------
+// Load a PVSim project, from the design cache if there, or else by compiling
+//  it, and get it ready to simulate.
+
+void loadProjectFile(const char *fileName, const char* testChoice)
+{
+    clock_t startRealTime = clock();
+    if (readDesignCache(fileName, testChoice))
+        vc.startRealTime = startRealTime;
+    else
+    {
+        compileProjectFile(fileName, testChoice);
+        writeDesignCache();
+    }
+    loadNativeCode();
+    forkTestWorkersIfNeeded();
 
     clock_t compileRealTime = clock() - vc.startRealTime;
     if (!gQuietMode)
@@ -23,5 +23,8 @@
 
 #pragma once
 
+extern bool     gOptimizePCode; // optimize P-code, unless -n or 'nooptimize'
+
 void loadVerilogFile(const char* filename);
+void defineTestChoice(const char* testChoice);
 void loadProjectFile(const char* filename, const char* testChoice=0);
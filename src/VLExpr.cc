@@ -41,6 +41,7 @@ Expr*   Expr::poolEnd;
 Expr*   Expr::next;             // next available expr node in pool
 bool    Expr::gatherTriggers;   // enables compileExpr to make triggers list
 bool    Expr::conditionedTriggers; // TRUE if triggers are cond'ed by any '@'s
+bool    Expr::watchMemReads;    // gives memory element reads MemReaders
 NetList* Expr::curTriggers;     // list of trigger nets to current expr
 bool    Expr::parmOnly;         // restricts compileExpr to a parameter expr
 
@@ -502,7 +503,7 @@ Expr* compileConstant(int width)
     int base, bitsDig;
     int value;
     Expr* ex;
-    const unsigned int max_bits = 64;
+    const unsigned int max_bits = 1024;
     Level vec[max_bits+4];
     Level* vp;
 
@@ -716,9 +717,9 @@ Range::Range()
 //
 // For vectors: a bit-range selector, which may be one or two expressions,
 //              or be ommitted altogether to specify the full range.
-// For memory: an address.
+// For memory: an address, or with isMemRange, a declaration's address range.
 
-void Range::compile()
+void Range::compile(bool isMemRange)
 {
     if (isToken('['))
     {
@@ -778,7 +779,7 @@ void Range::compile()
                 incr = -incr;
             }
             size = diff + 1;
-            if (size > 4095)
+            if (size > 4095 && !isMemRange)
                 throw new VError(verr_illegal, "vector size too large");
 
             isScalar = (size == 1);
@@ -866,6 +867,8 @@ Expr* newLoadVector(Vector* vector, Range* range, Variable* extScopeRef)
 
 //-----------------------------------------------------------------------------
 // Create a new load-memory-variable expression.
+// While compiling a continuous assign, a local memory read is given a
+// MemReader to trigger the assign instead of the memory's trigger.
 
 Expr* newLoadMem(Memory* mem, Expr* index, Variable* extScopeRef)
 {
@@ -878,8 +881,26 @@ Expr* newLoadMem(Memory* mem, Expr* index, Variable* extScopeRef)
         ex->nBits = mem->elemRange->size;
     else
         ex->nBits = sizeof(size_t);
+    ex->data.reader = 0;
     if (Expr::gatherTriggers)
-        addTrigger(mem);
+    {
+        // a local read by a continuous assign only triggers on writes to
+        // the element it reads
+        if (Expr::watchMemReads && !extScopeRef)
+        {
+            int n = 0;
+            for (MemReader* r = mem->readers; r; r = r->next)
+                n++;
+            MemReader* reader = new MemReader(
+                        newString(TmpName("%s[r%d]", mem->name, n)), mem,
+                        Scope::local->newLocal(sizeof(MemWatch) /
+                                               sizeof(size_t), sizeof(size_t)));
+            ex->data.reader = reader;
+            addTrigger(reader);
+        }
+        else
+            addTrigger(mem);
+    }
     if (debugLevel(4))
         display("%s M@ ", mem->name);
     ex->triggers = Expr::curTriggers;
@@ -1169,11 +1190,11 @@ Expr* compileExpr()
             {
                 if (haveValue)
                     goto endOfExpr;
-                int n = gScToken->number;
+                DLong n = gScToken->number;
                 if (nxTok == '\'')
                 {
                     scan();                     // a constant like 3'b101
-                    *--exSP = compileConstant(n);
+                    *--exSP = compileConstant((int)n);
                 }
                 else
                     *--exSP = newConstInt(n); // a number push
@@ -29,6 +29,8 @@
 #include "VLSysLib.h"
 #include "VLCoder.h"
 #include "Model.h"
+#include "Checkpoint.h"
+#include "MemPages.h"
 
 //-----------------------------------------------------------------------------
 // Interface to simulator's existing C-Model event handlers.
@@ -55,19 +57,19 @@ Assign::Assign(Net* net, EvHandCodePtr evHandCode, char* instModule):
 // Add an event to cause the signal to evaluate initial value at t=0
 void Assign::reset()
 {
-    if (modelSignal->inputsList)
+    if (modelSignal->inputBegin() < modelSignal->inputEnd())
     {
         // for 'res' global reset signal
         // A trick to force sim1step() to evaluate event:
         // set its pre-zero level to be the inverse of the initial level
         // also insure that we don't init a tri signal more than once
-        Signal* signal = modelSignal->inputsList->signal();
+        Signal* signal = gSignals + *modelSignal->inputBegin();
         Event* lastEvt = signal->lastEvtPosted;
         Tick t2 = gTick + 1;
-        if (signal->level == signal->initLevel &&
+        if (signal->level() == signal->initLevel &&
             (!lastEvt || lastEvt->tick != t2))
         {
-            signal->level = inv(signal);
+            signal->setLevel(inv(signal));
             addEvent(1, signal, signal->initLevel, CLEAN);
         }
     }
@@ -102,7 +104,7 @@ VTask::VTask(char* name, EvHandCodePtr evHandCode, Instance* instance):
     // flag this signal as non-event-saving
     this->modelSignal->is = C_MODEL + REGISTERED;
     this->modelSignal->model = this;
-    this->modelSignal->srcLoc = 0;
+    this->modelSignal->info()->srcLoc = 0;
     setEntry(startVTask, (void*)this);
     this->isTask = TRUE;
     this->instance = instance;
@@ -151,6 +153,7 @@ EvHand::EvHand(VKeyword type, EvHandCodePtr code)
     this->type = type;
     this->code = code;
     this->net = 0;
+    this->sweepable = FALSE;
     this->triggers = 0;
     this->modNext = 0;
     this->model = 0;
@@ -246,7 +249,7 @@ void EvHand::setDependencies(Instance* instance)
                         dependName);
     if (debugLevel(2))
         display("setDependencies for EvHand %s, dependent %s\n",
-                    dependName, dependent->name);
+                    dependName, dependent->name());
 
 #if 1
     // every signal depends on gAssignsReset, to force initialization at t=0
@@ -319,6 +322,20 @@ void EvHand::setDependencies(Instance* instance)
                                  trigger->name);
         }
     }
+    // record a zero-delay assign's output signals, for levelizeAssigns()
+    if (this->type == k_assign && this->sweepable)
+    {
+        if (this->net->isExType(ty_vector))
+        {
+            SignalVec* out = ((Vector*)this->net)->signalVec +
+                                this->vecBaseBit;
+            for (int n = this->vecSize; n > 0; n--, out++)
+                if (*out)
+                    setSweepOutput(dependent, *out);
+        }
+        else if (((Scalar*)this->net)->signal)
+            setSweepOutput(dependent, ((Scalar*)this->net)->signal);
+    }
 }
 
 
@@ -703,8 +720,8 @@ void Scope::initVariables(char* instModule, char* fullDesig)
                                                   (char*)sigFD, scalar->name);
                         Signal* signal = addSignal(newString(sigName), LV_L);
                         signal->model = 0;   // model filled in later for wires
-                        signal->srcLoc = scalar->srcLoc;
-                        signal->srcLocObjName = scalar->srcLocObjName;
+                        signal->info()->srcLoc = scalar->srcLoc;
+                        signal->info()->srcLocObjName = scalar->srcLocObjName;
                         if ((sigName[0] == '_' && sigName[1] == '_') ||
                             !scalar->isVisible)
                             signal->is &= ~DISPLAYED;
@@ -743,9 +760,9 @@ void Scope::initVariables(char* instModule, char* fullDesig)
                         TmpName sigName = TmpName("%s%s[%d:%d]", (char*)sigFD,
                                                     vec->name, bit, endBit);
                         Signal* signal = addSignal(newString(sigName), LV_S);
-                        signal->srcLoc = vec->srcLoc;
-                        signal->srcLocObjName = vec->srcLocObjName;
-                        signal->busOpt = DISP_BUS;
+                        signal->info()->srcLoc = vec->srcLoc;
+                        signal->info()->srcLocObjName = vec->srcLocObjName;
+                        signal->info()->busOpt = DISP_BUS;
 //                      if (inverted)
 //                          signal->busOpt |= DISP_INVERTED;
                         gDispBusWidth = vec->range->size;
@@ -770,8 +787,8 @@ void Scope::initVariables(char* instModule, char* fullDesig)
                                                        LV_L);
                             // model filled in later for wires
                             signal->model = 0;
-                            signal->srcLoc = vec->srcLoc;
-                            signal->srcLocObjName = vec->srcLocObjName;
+                            signal->info()->srcLoc = vec->srcLoc;
+                            signal->info()->srcLocObjName = vec->srcLocObjName;
                             if (!vec->isVisible && !debugLevel(1))
                                 signal->is &= ~DISPLAYED;
                             if (attr & att_tri)
@@ -798,14 +815,33 @@ void Scope::initVariables(char* instModule, char* fullDesig)
                     TmpName sigName = TmpName("%s%s", (char*)sigFD, mem->name);
                     Signal* signal = addSignal(newString(sigName), LV_L);
                     signal->model = 0;      // model filled in later
-                    signal->srcLoc = mem->srcLoc;
-                    signal->srcLocObjName = mem->srcLocObjName;
+                    signal->info()->srcLoc = mem->srcLoc;
+                    signal->info()->srcLocObjName = mem->srcLocObjName;
                     signal->is = C_MODEL;
                     if (mem->isVisible || debugLevel(1))
                         signal->is |= DISPLAYED;
                     mem->signal = signal;
-                    // first 4 bytes of local var is pointer to trigger signal
-                    *((Signal**)(instModule + mem->disp)) = signal;
+                    // local var starts with the trigger signal and the
+                    // list of its readers' watches, none read yet
+                    MemHead* head = (MemHead*)(instModule + mem->disp);
+                    head->signal = signal;
+                    head->watchers = 0;
+                    for (MemReader* r = mem->readers; r; r = r->next)
+                    {
+                        MemWatch* w = (MemWatch*)(instModule + r->disp);
+                        w->index = ~(size_t)0;
+                        w->next = head->watchers;
+                        head->watchers = w;
+                    }
+                    // followed by a large memory's paged store pointer,
+                    // or its elements, which start out as 0 like the pages
+                    if (mem->isPaged())
+                        *((MemPages**)(instModule + mem->disp +
+                                       sizeof(MemHead))) =
+                            newMemPages(mem->memRange->size, mem->elemBits());
+                    else
+                        memset(instModule + mem->disp + sizeof(MemHead), 0,
+                               mem->memRange->size * sizeof(size_t));
                     break;
                 }
                 case ty_vecConst:   // vector constant: copy into local vars
@@ -873,7 +909,7 @@ void Scope::linkVariables(char* instModule, char* fullDesig)
                         if (debugLevel(3))
                             display("Link Scalar %s.%s @0x%x: Sig %s @%p,"
                                     " t=%p msig=%p\n", fullDesig, scalar->name,
-                                    scalar, signal->name, signal,
+                                    scalar, signal->name(), signal,
                                 model, model->modelSig());
                         model->setModelSignal(signal);
                     }
@@ -913,7 +949,7 @@ void Scope::linkVariables(char* instModule, char* fullDesig)
                         if (!(triSig->is & TRI_STATE))
                             throw new VError(tri->srcLoc, verr_illegal,
                                     "wire '%s' should be a tri (nonstandard!)",
-                                    triSig->name);
+                                    triSig->name());
                         setDependency(triSig, signal);
 
                         if (scalar->enable) // and an enable: tell signal
@@ -968,7 +1004,7 @@ void Scope::linkVariables(char* instModule, char* fullDesig)
                                 display("Link Vector %s.%s @%p: SigV %s @%p,"
                                         " size=%d t=%p msig=%p\n",
                                         fullDesig, vec->name, vec,
-                                        (*sigPtr)->name, sigPtr,
+                                        (*sigPtr)->name(), sigPtr,
                                         vec->range->size, model,
                                         model->modelSig());
                             if (!model->modelSig())
@@ -977,7 +1013,7 @@ void Scope::linkVariables(char* instModule, char* fullDesig)
                                 if (debugLevel(3))
                                     display(
                                         "Link Vector %s set modelSignal %s\n",
-                                        vec->name, model->modelSig()->name);
+                                        vec->name, model->modelSig()->name());
                             }
                         }
                     }
@@ -1031,6 +1067,45 @@ void Scope::linkVariables(char* instModule, char* fullDesig)
         }
 }
 
+//-----------------------------------------------------------------------------
+// Register the local vars that hold pointers, for checkpoints: the Signal
+// pointers of scalars and vectors, each memory's head and paged store, the
+// links between its readers' watches, and external scope references.
+
+void Scope::addCkptPointers(char* instModule)
+{
+    for (NamedObj* sym = this->names; sym; sym = sym->namesNext)
+        if (sym->isType(ty_var))
+        {
+            Variable* var = (Variable*)sym;
+            char* local = instModule + var->disp;
+            switch (var->exType.code)
+            {
+                case ty_scalar:
+                case ty_scopeRef:
+                    ckptAddPointers(local, 1);
+                    break;
+
+                case ty_vector:
+                    ckptAddPointers(local, ((Vector*)var)->range->size);
+                    break;
+
+                case ty_memory:
+                {
+                    Memory* mem = (Memory*)var;
+                    ckptAddPointers(local, sizeof(MemHead) / sizeof(size_t) +
+                                           mem->isPaged());
+                    for (MemReader* r = mem->readers; r; r = r->next)
+                        ckptAddPointers(&((MemWatch*)(instModule +
+                                                      r->disp))->next, 1);
+                    break;
+                }
+                default:            // ints and constants are just data
+                    break;
+            }
+        }
+}
+
 //-----------------------------------------------------------------------------
 // Instantiate a VLModule with actual signals and local variable space.
 
@@ -1076,6 +1151,7 @@ void Instance::instantiate(const char* parentName, Instance* parent)
         // allocate module's local storage
         this->instModule = new char[mod->localSize];
         imod = this->instModule;
+        ckptAddRegion(imod, mod->localSize, TRUE);
 
         // bind parameter values to parameters
         Variable* parm = mod->parms;
@@ -1139,6 +1215,10 @@ void Instance::instantiate(const char* parentName, Instance* parent)
         for (Scope* scope = mod->scopes; scope; scope = scope->scopesNext)
             scope->linkVariables(imod, fullDesig);
 
+        mod->addCkptPointers(imod);
+        for (Scope* scope = mod->scopes; scope; scope = scope->scopesNext)
+            scope->addCkptPointers(imod);
+
         // add dependencies for event handlers to their input signals
         for (EvHand* eh = mod->evHands; eh; eh = eh->modNext)
             eh->setDependencies(this);
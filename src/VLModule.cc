@@ -123,15 +123,13 @@ bool compileMemRange(Range** rangePtr)
     if (hasRange)
     {
         Range* range = new Range();
-        range->compile();
+        range->compile(TRUE);
         if (range->isScalar)
             throwExpected("memory address range, in the form [a:b]");
         if (!(range->left.isConst && range->right.isConst))
             throwExpected("constant memory size, for now");
         range->isFull = TRUE;
         *rangePtr = range;
-        if (range->size > 1024)
-            throwExpected("memory size <= 1024, for now");
     }
     return hasRange;
 }
@@ -145,13 +143,13 @@ Expr* compileTime()
     Expr::parmOnly = TRUE;
     Expr* ex = compileExpr();
     if (ex->opcode == op_lit && ex->tyCode == ty_float)
-        ex = newConstInt((int)round((ex->data.fValue * gTimeScale)));
+        ex = newConstInt(llround(ex->data.fValue * gTimeScale));
     else
     {
         // rescale an integer expression as ticks, if not already
         if (ex->tyCode == ty_int && ex->data.scale != gTimeScale)
             ex = newOp2(op_mul, ex,
-                        newConstInt((int)round(gTimeScale/ex->data.scale)));
+                        newConstInt(llround(gTimeScale/ex->data.scale)));
     }
     return ex;
 }
@@ -506,6 +504,9 @@ void codeAssignment(NetAttr lValueAttr, bool continuous = FALSE)
                                     module->endHandler(lnet, vecRange);
                                 else
                                     module->endHandler(lnet);
+                                module->setSweepable(!nParms &&
+                                    !extScopeRef &&
+                                    !Expr::conditionedTriggers);
                             }
                         }
                         break;
@@ -1039,11 +1040,15 @@ void VLModule::codeNetDeclaration(NetAttr attr)
             bool isMemory = compileMemRange(&memRange);
             if (isMemory)
             {
-                size_t maxSize = sizeof(Signal*) +
-                                memRange->size * sizeof(size_t);
+                // a large memory's local var just points to its pages
+                size_t nWords = memRange->size;
+                if (nWords > max_denseMemElems)
+                    nWords = 1;
+                size_t maxSize = sizeof(MemHead) + nWords * sizeof(size_t);
                 new Memory(netName, attr,
-                            Scope::local->newLocal(memRange->size + 1,
-                                                   sizeof(Signal*)),
+                            Scope::local->newLocal(nWords + sizeof(MemHead) /
+                                                   sizeof(size_t),
+                                                   sizeof(size_t)),
                             maxSize, memRange, vecRange);
             }
             else
@@ -1273,6 +1278,7 @@ void VLModule::startHandler(VKeyword type, const char* desig,
     this->addEvHand(new EvHand(type, (EvHandCodePtr)here()));
     Expr::curTriggers = curTriggers;
     Expr::gatherTriggers = TRUE;
+    Expr::watchMemReads = (type == k_assign);
     Expr::conditionedTriggers = FALSE;
     Expr::parmOnly = FALSE;
     codeSubrHead(FALSE);
@@ -1283,6 +1289,7 @@ void VLModule::endHandler()
     codeEndModule();
     this->evHandsE->triggers = Expr::curTriggers;
     Expr::gatherTriggers = FALSE;
+    Expr::watchMemReads = FALSE;
     Expr::parmOnly = FALSE;
 }
 
@@ -1886,6 +1893,8 @@ VLModule::VLModule(char* name) : Scope(name, ty_module, this)
     this->evHands = 0;
     this->evHandsE = 0;
     this->instTmpls = 0;
+    vc.nOpsCoded = 0;
+    vc.nOpsOptimized = 0;
     initCodeArea();
     resetExprPool();
     // reserve space for first var: task pointer
@@ -1928,6 +1937,10 @@ VLModule::VLModule(char* name) : Scope(name, ty_module, this)
         codeModuleItem();               // code each module item
 
     scan();
+    if (vc.nOpsCoded && !gQuietMode)
+        display("    module '%s': %d P-code ops, %d optimized (%d%% fewer)\n",
+                this->name, vc.nOpsCoded, vc.nOpsOptimized,
+                100 - (100 * vc.nOpsOptimized) / vc.nOpsCoded);
     
     Scope::local = enclScope;   // restore scope
 }
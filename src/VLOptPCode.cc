@@ -0,0 +1,617 @@
+// ****************************************************************************
+//
+//          PVSim Verilog Simulator P-Code Optimizer
+//
+// Copyright (C) 2012 Scott Forbes
+//
+// This file is part of PVSim.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PVSim; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+// ****************************************************************************
+
+#ifdef EXTENSION
+#include <Python.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+
+#include "PSignal.h"
+#include "Model.h"
+
+#include "VLCompiler.h"
+#include "VL.h"
+#include "VLCoder.h"
+#include "PCode.h"
+
+// Each event handler and task subroutine is optimized in place once it has
+// been coded, when all of its branches have been resolved. The subroutine is
+// decoded into a list of ops, which is rewritten by these passes:
+//
+//   jump threading     a branch to a br goes to its destination instead, and
+//                      a br to an rts or end becomes that op
+//   constant folding   arithmetic on literals is done now, and a conditional
+//                      branch on a literal becomes a br or nothing
+//   dead code          ops that can't be reached, and br's to the next op,
+//                      are removed
+//   dead stores        an st overwritten by a later st to the same variable,
+//                      with only stack ops between, becomes a drop
+//   fusion             common pairs and triples become one superinstruction
+//
+// and the surviving ops are then packed down from the subroutine's start, with
+// branches relocated. An op may only be removed or fused into the op before it
+// if no branch lands on it, and no thread resumes at it after a wait, del or
+// btsk. The subroutine's start never moves, so handler and task addresses
+// taken before it was coded stay valid.
+
+const int max_jumpThreadHops = 16;  // longest chain of br's followed
+
+bool    gOptimizePCode = TRUE;  // optimize P-code, unless -n or 'nooptimize'
+
+// A decoded P-code op.
+struct OptOp
+{
+    PCodeOp     op;         // op-code
+    char        nArgs;      // number of subroutine args for p_bsr
+    short       w;          // short-word arg
+    size_t      n;          // dual op's operand
+    PCode*      adr;        // original address
+    int         dest;       // index of branch destination op, or -1
+    bool        isTarget;   // a branch lands here, or a thread resumes here
+    bool        isLive;     // not removed
+};
+
+static OptOp*   ops;        // subroutine's ops, followed by an end marker
+static int      nOps;       // number of ops, not including end marker
+
+//-----------------------------------------------------------------------------
+// Return TRUE if op is a dual op.
+
+static inline bool isDual(PCodeOp op)
+{
+    return (op >= first_dualOp);
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if op branches to n within the subroutine.
+
+static bool isBranch(PCodeOp op)
+{
+    switch (op)
+    {
+        case p_br:
+        case p_beq:
+        case p_bne:
+        case p_bfeq:
+        case p_bfne:
+        case p_bfgt:
+        case p_bfle:
+        case p_bflt:
+        case p_bfge:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if op only works on the stack, without touching memory or
+// calling anything.
+
+static bool isStackOp(PCodeOp op)
+{
+    switch (op)
+    {
+        case p_dup:   case p_swap:  case p_rot:   case p_pick:  case p_drop:
+        case p_liw:   case p_li:    case p_add:   case p_sub:   case p_mul:
+        case p_and:   case p_or:    case p_xor:   case p_sla:   case p_sra:
+        case p_eq:    case p_ne:    case p_gt:    case p_le:    case p_lt:
+        case p_ge:    case p_not:   case p_nots:  case p_com:   case p_neg:
+        case p_cvis:  case p_addi:  case p_andi:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Return the index of the first live op after op i, or nOps if none.
+
+static int nextLive(int i)
+{
+    for (i++; i < nOps && !ops[i].isLive; i++)
+        ;
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+// Return the index of the op at address p, or -1 if none.
+
+static int opAt(PCode* p)
+{
+    int lo = 0;
+    int hi = nOps;
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (ops[mid].adr == p)
+            return mid;
+        if (ops[mid].adr < p)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
+
+//-----------------------------------------------------------------------------
+// Decode the subroutine from start to end into ops[]. Returns FALSE if a
+// branch lands inside the subroutine but not on an op, so it can't be
+// safely rearranged.
+
+static bool decodeOps(PCode* start, PCode* end)
+{
+    nOps = 0;
+    for (PCode* p = start; p < end; p += (isDual(p->p.op) ? 2 : 1))
+    {
+        OptOp* o = ops + nOps++;
+        o->op = p->p.op;
+        o->nArgs = p->p.nArgs;
+        o->w = p->p.w;
+        o->n = (isDual(o->op) ? (p+1)->n : 0);
+        o->adr = p;
+        o->dest = -1;
+        o->isLive = TRUE;
+    }
+    OptOp* o = ops + nOps;      // end marker: a branch may land at end
+    o->op = p_nop;
+    o->adr = end;
+    o->dest = -1;
+    o->isLive = FALSE;
+
+    for (int i = 0; i < nOps; i++)
+    {
+        o = ops + i;
+        PCode* dest = (PCode*)o->n;
+        if (isBranch(o->op) && dest >= start && dest <= end)
+        {
+            o->dest = opAt(dest);
+            if (o->dest < 0)
+                return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Mark each live op that is a branch destination or a resume point.
+
+static void markTargets()
+{
+    for (int i = 0; i <= nOps; i++)
+        ops[i].isTarget = FALSE;
+    ops[0].isTarget = TRUE;
+    for (int i = 0; i < nOps; i++)
+    {
+        OptOp* o = ops + i;
+        if (!o->isLive)
+            continue;
+        if (o->dest >= 0)
+            ops[o->dest].isTarget = TRUE;
+        switch (o->op)
+        {
+            case p_wait:
+            case p_del:
+            case p_delw:
+            case p_btsk:
+                ops[nextLive(i)].isTarget = TRUE;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Make op o a literal load of value v.
+
+static void setLiteral(OptOp* o, size_t v)
+{
+    if (v == (size_t)(short)v)
+    {
+        o->op = p_liw;
+        o->w = (short)v;
+    }
+    else
+    {
+        o->op = p_li;
+        o->n = v;
+    }
+    o->dest = -1;
+}
+
+//-----------------------------------------------------------------------------
+// Return TRUE if op o is a literal load, setting *v to its value.
+
+static bool isLiteral(OptOp* o, size_t* v)
+{
+    if (o->op == p_liw)
+        *v = (size_t)o->w;
+    else if (o->op == p_li)
+        *v = o->n;
+    else
+        return FALSE;
+    return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// Follow branches to br's on to their final destinations, and turn a br to a
+// return into the return itself.
+
+static void threadJumps()
+{
+    for (int i = 0; i < nOps; i++)
+    {
+        OptOp* o = ops + i;
+        if (!o->isLive || o->dest < 0)
+            continue;
+        int dest = o->dest;
+        for (int hops = 0; hops < max_jumpThreadHops; hops++)
+        {
+            while (dest < nOps && !ops[dest].isLive)
+                dest++;
+            if (dest >= nOps || ops[dest].op != p_br || ops[dest].dest < 0 ||
+                ops[dest].dest == dest)
+                break;
+            dest = ops[dest].dest;
+        }
+        o->dest = dest;
+        if (o->op == p_br && dest < nOps &&
+            (ops[dest].op == p_rts || ops[dest].op == p_end))
+        {
+            o->op = ops[dest].op;
+            o->dest = -1;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Fold operations on literals. Returns TRUE if any were folded.
+
+static bool foldConstants()
+{
+    bool folded = FALSE;
+    for (int i = 0; i < nOps; i = nextLive(i))
+    {
+        OptOp* a = ops + i;
+        int ib = nextLive(i);
+        OptOp* b = ops + ib;
+        size_t va, vb;
+        if (!a->isLive || !isLiteral(a, &va) || ib >= nOps || b->isTarget)
+            continue;
+
+        if (isLiteral(b, &vb))
+        {
+            int ic = nextLive(ib);
+            OptOp* c = ops + ic;
+            if (ic >= nOps || c->isTarget)
+                continue;
+            size_t v;
+            switch (c->op)
+            {
+                case p_add: v = va + vb;                    break;
+                case p_sub: v = va - vb;                    break;
+                case p_mul: v = va * vb;                    break;
+                case p_and: v = va & vb;                    break;
+                case p_or:  v = va | vb;                    break;
+                case p_xor: v = va ^ vb;                    break;
+                case p_eq:  v = va == vb;                   break;
+                case p_ne:  v = va != vb;                   break;
+                case p_gt:  v = va > vb;                    break;
+                case p_le:  v = va <= vb;                   break;
+                case p_lt:  v = va < vb;                    break;
+                case p_ge:  v = va >= vb;                   break;
+                case p_div:
+                    if (vb == 0)            // leave it for a run-time error
+                        continue;
+                    v = va / vb;
+                    break;
+                case p_sla:
+                case p_sra:
+                    if (vb >= 8 * sizeof(size_t))
+                        continue;
+                    v = (c->op == p_sla ? va << vb : va >> vb);
+                    break;
+                default:
+                    continue;
+            }
+            setLiteral(a, v);
+            b->isLive = FALSE;
+            c->isLive = FALSE;
+            folded = TRUE;
+            continue;
+        }
+
+        switch (b->op)
+        {
+            case p_not:  setLiteral(a, !va);                break;
+            case p_neg:  setLiteral(a, -va);                break;
+            case p_addi: setLiteral(a, va + b->n);          break;
+            case p_andi: setLiteral(a, va & b->n);          break;
+            case p_beq:
+            case p_bne:
+                // a branch on a literal either always or never branches
+                if ((va == 0) == (b->op == p_beq))
+                {
+                    a->op = p_br;
+                    a->n = b->n;
+                    a->dest = b->dest;
+                }
+                else
+                    a->isLive = FALSE;
+                break;
+            default:
+                continue;
+        }
+        b->isLive = FALSE;
+        folded = TRUE;
+    }
+    return folded;
+}
+
+//-----------------------------------------------------------------------------
+// Remove ops that can't be reached from the subroutine's start, and br's to
+// the next op. Returns TRUE if any were removed.
+
+static bool removeDeadCode()
+{
+    bool removed = FALSE;
+    bool* reached = (bool*)calloc(nOps + 1, sizeof(bool));
+    int* work = (int*)malloc((2 * nOps + 1) * sizeof(int));
+    if (!reached || !work)
+        throw new VError(verr_memOverflow, "no memory for P-code optimizer");
+    int nWork = 0;
+    work[nWork++] = 0;
+    while (nWork)
+    {
+        int i = work[--nWork];
+        while (i < nOps && !ops[i].isLive)
+            i++;
+        if (i >= nOps || reached[i])
+            continue;
+        reached[i] = TRUE;
+        OptOp* o = ops + i;
+        if (o->dest >= 0)
+            work[nWork++] = o->dest;
+        if (o->op != p_br && o->op != p_rts && o->op != p_end)
+            work[nWork++] = i + 1;
+    }
+    for (int i = 0; i < nOps; i++)
+    {
+        if (ops[i].isLive && !reached[i])
+        {
+            ops[i].isLive = FALSE;
+            removed = TRUE;
+        }
+    }
+    free(work);
+    free(reached);
+
+    for (int i = 0; i < nOps; i++)
+    {
+        OptOp* o = ops + i;
+        if (o->isLive && o->op == p_br && o->dest >= 0 &&
+            nextLive(i) == nextLive(o->dest - 1))
+        {
+            o->isLive = FALSE;
+            removed = TRUE;
+        }
+    }
+    return removed;
+}
+
+//-----------------------------------------------------------------------------
+// Turn a store into a drop where the same variable is stored again before
+// anything else can see it.
+
+static void removeDeadStores()
+{
+    for (int i = 0; i < nOps; i = nextLive(i))
+    {
+        OptOp* o = ops + i;
+        if (!o->isLive || o->op != p_st)
+            continue;
+        int j;
+        for (j = nextLive(i); j < nOps && !ops[j].isTarget &&
+                              isStackOp(ops[j].op); j = nextLive(j))
+            ;
+        if (j < nOps && !ops[j].isTarget && ops[j].op == p_st &&
+            ops[j].n == o->n)
+        {
+            o->op = p_drop;
+            o->w = 1;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Fuse common op sequences into superinstructions.
+
+static void fuseOps()
+{
+    for (int i = 0; i < nOps; i = nextLive(i))
+    {
+        OptOp* a = ops + i;
+        int ib = nextLive(i);
+        OptOp* b = ops + ib;
+        if (!a->isLive || ib >= nOps || b->isTarget)
+            continue;
+        int ic = nextLive(ib);
+        OptOp* c = ops + ic;
+
+        // ld n, addi w, st n: add a short immediate to a variable
+        if (a->op == p_ld && b->op == p_addi && ic < nOps && !c->isTarget &&
+            c->op == p_st && c->n == a->n && b->n == (size_t)(short)b->n)
+        {
+            a->op = p_addv;
+            a->w = (short)b->n;
+            b->isLive = FALSE;
+            c->isLive = FALSE;
+            continue;
+        }
+
+        PCodeOp fused = p_nop;
+        switch (a->op)
+        {
+            case p_lea:
+                if (b->op == p_liw)
+                {
+                    fused = p_leaw;
+                    a->w = b->w;
+                }
+                break;
+
+            case p_liw:
+                switch (b->op)
+                {
+                    case p_liw:  fused = p_liw2;    break;
+                    case p_bsr2: fused = p_bsr2w;   break;
+                    case p_bsr3: fused = p_bsr3w;   break;
+                    case p_bsr5: fused = p_bsr5w;   break;
+                    case p_st:   fused = p_stw;     break;
+                    case p_del:  fused = p_delw;    break;
+                    default:                        break;
+                }
+                if (fused == p_liw2)
+                    a->n = (size_t)b->w;
+                else if (fused != p_nop && fused != p_delw)
+                    a->n = b->n;
+                break;
+
+            case p_lds:
+                if (b->op == p_nots)
+                    fused = p_ldsn;
+                break;
+
+            case p_bsr2:
+                if (b->op == p_func)
+                    fused = p_bsr2f;
+                break;
+
+            case p_st:
+                if (b->op == p_ld && b->n == a->n)
+                    fused = p_stk;
+                break;
+
+            case p_eq:
+            case p_ne:
+            case p_gt:
+            case p_le:
+            case p_lt:
+            case p_ge:
+                if (b->op == p_beq)
+                {
+                    fused = (PCodeOp)(p_bfeq + (a->op - p_eq));
+                    a->n = b->n;
+                    a->dest = b->dest;
+                }
+                break;
+
+            default:
+                break;
+        }
+        if (fused != p_nop)
+        {
+            a->op = fused;
+            b->isLive = FALSE;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Write the live ops back, packed down from the subroutine's start, with
+// branches relocated. Returns the new end of the subroutine.
+
+static PCode* packOps(PCode* start, PCode* end)
+{
+    PCode** newAdr = (PCode**)malloc((nOps + 1) * sizeof(PCode*));
+    if (!newAdr)
+        throw new VError(verr_memOverflow, "no memory for P-code optimizer");
+    PCode* p = start;
+    for (int i = 0; i <= nOps; i++)
+    {
+        newAdr[i] = p;
+        if (i < nOps && ops[i].isLive)
+            p += (isDual(ops[i].op) ? 2 : 1);
+    }
+    for (int i = 0; i < nOps; i++)
+    {
+        OptOp* o = ops + i;
+        if (!o->isLive)
+            continue;
+        p = newAdr[i];
+        p->n = 0;
+        p->p.op = o->op;
+        p->p.nArgs = o->nArgs;
+        p->p.w = o->w;
+        if (isDual(o->op))
+            (p+1)->n = (o->dest >= 0 ? (size_t)newAdr[o->dest] : o->n);
+    }
+    PCode* newEnd = newAdr[nOps];
+    memset(newEnd, 0, (end - newEnd) * sizeof(PCode));
+    free(newAdr);
+    return newEnd;
+}
+
+//-----------------------------------------------------------------------------
+// Optimize the subroutine coded from start to end, adding its op counts to
+// vc.nOpsCoded and vc.nOpsOptimized. Returns the subroutine's new end.
+
+PCode* optimizePCode(PCode* start, PCode* end)
+{
+    ops = (OptOp*)malloc((end - start + 1) * sizeof(OptOp));
+    if (!ops)
+        throw new VError(verr_memOverflow, "no memory for P-code optimizer");
+    if (!decodeOps(start, end))
+    {
+        vc.nOpsCoded += nOps;
+        vc.nOpsOptimized += nOps;
+        free(ops);
+        return end;
+    }
+    int nCoded = nOps;
+
+    do
+    {
+        markTargets();
+        threadJumps();
+        markTargets();
+    } while (foldConstants() | removeDeadCode());
+    markTargets();
+    removeDeadStores();
+    fuseOps();
+
+    int nLive = 0;
+    for (int i = 0; i < nOps; i++)
+        if (ops[i].isLive)
+            nLive++;
+    PCode* newEnd = packOps(start, end);
+    free(ops);
+    vc.nOpsCoded += nCoded;
+    vc.nOpsOptimized += nLive;
+    if (debugLevel(3))
+        display("            optimized %p: %d ops to %d, ends at %p\n",
+                start, nCoded, nLive, newEnd);
+    return newEnd;
+}
@@ -39,6 +39,8 @@
 #include "Src.h"
 #include "VLCoder.h"
 #include "VLSysLib.h"
+#include "LVecOps.h"
+#include "MemPages.h"
 
 class ModelSysLib: public Model
 {
@@ -61,7 +63,7 @@ size_t loadIndScalar(SignalVec* sigVec, size_t i, size_t iMax)
 {
     if (i > iMax)
         return LV_X;
-    return sigVec[i]->level;
+    return sigVec[i]->level();
 }
 
 // Load bits starting at i from Vector signal sigVec into a temp LVector,
@@ -80,7 +82,7 @@ void loadIndVector(SignalVec* sigVec, size_t i, size_t iMax,
     sigVec += i;
     for ( ; nBits > 0; nBits--)
     {
-        *levVec++ = (*sigVec)->level;
+        *levVec++ = (*sigVec)->level();
         sigVec++;
     }
 }
@@ -97,33 +99,40 @@ void sampleVector(Level* levVec, size_t nBits)
     }
 }
 
+// Copy an LVector, for P-code, which calls only simulator functions so that
+// a cached design can find them again.
+
+void copyLVec(Level* dest, const Level* src, size_t nBytes)
+{
+    memcpy(dest, src, nBytes);
+}
+
+// The LVector operations below hand buses to the gLVecOps kernels, which
+// work 16 or 32 bits at a time where the CPU can. The unary reductions take
+// the kernels' fast path when every bit is L or H, on which the AND, OR and
+// XOR tables act as plain logic, and fold the tables bit by bit otherwise.
+
 // convert an integer to an LVector (assumes LVector space allocated)
 
 void convIntToLVec(size_t value, Level* levVec, size_t nBits)
 {
-    levVec += nBits;
-    for ( ; nBits > 0; nBits--)
-    {
-        levVec--;
-        *levVec = ((value & 1) ? LV_H : LV_L);
-        value >>= 1;
-    }
+    gLVecOps->fromInt(value, levVec, nBits);
 }
 
 // convert an LVector to an integer
 
 size_t convLVecToInt(Level* levVec, size_t nBits)
 {
-    size_t value = 0;
-    for ( ; nBits > 0; nBits--)
-        value = (value << 1) + (*levVec++ == LV_H);
-    return value;
+    return gLVecOps->toInt(levVec, nBits);
 }
 
 // Do a unary AND on an LVector, returning a single Level.
 
 size_t uandLVec(Level* levVec, size_t nBits)
 {
+    size_t nHigh;
+    if (gLVecOps->countHigh(levVec, nBits, &nHigh))
+        return (nHigh == nBits ? LV_H : LV_L);
     Level product = LV_H;
     for ( ; nBits > 0; nBits--)
         product = funcTable.ANDtable[*levVec++][product];
@@ -134,16 +143,16 @@ size_t uandLVec(Level* levVec, size_t nBits)
 
 size_t unandLVec(Level* levVec, size_t nBits)
 {
-    Level product = LV_H;
-    for ( ; nBits > 0; nBits--)
-        product = funcTable.ANDtable[*levVec++][product];
-    return funcTable.INVERTtable[product];
+    return funcTable.INVERTtable[uandLVec(levVec, nBits)];
 }
 
 // Do a unary OR on an LVector, returning a single Level.
 
 size_t uorLVec(Level* levVec, size_t nBits)
 {
+    size_t nHigh;
+    if (gLVecOps->countHigh(levVec, nBits, &nHigh))
+        return (nHigh > 0 ? LV_H : LV_L);
     Level sum = LV_L;
     for ( ; nBits > 0; nBits--)
         sum = funcTable.ORtable[*levVec++][sum];
@@ -154,16 +163,16 @@ size_t uorLVec(Level* levVec, size_t nBits)
 
 size_t unorLVec(Level* levVec, size_t nBits)
 {
-    Level sum = LV_L;
-    for ( ; nBits > 0; nBits--)
-        sum = funcTable.ORtable[*levVec++][sum];
-    return funcTable.INVERTtable[sum];
+    return funcTable.INVERTtable[uorLVec(levVec, nBits)];
 }
 
 // Do a unary XOR on an LVector to get the resulting even parity as a Level.
 
 size_t uxorLVec(Level* levVec, size_t nBits)
 {
+    size_t nHigh;
+    if (gLVecOps->countHigh(levVec, nBits, &nHigh))
+        return ((nHigh & 1) ? LV_H : LV_L);
     Level parity = LV_L;
     for ( ; nBits > 0; nBits--)
         parity = funcTable.XORtable[*levVec++][parity];
@@ -172,19 +181,505 @@ size_t uxorLVec(Level* levVec, size_t nBits)
 
 // Do a unary operation on an LVector into a 2nd LVector. Op uses table.
 
-void unaryOpLVec(Level* src, Level* dest, size_t nBits, Level table[12])
+void unaryOpLVec(Level* src, Level* dest, size_t nBits,
+                 const Level table[12])
 {
-    for ( ; nBits > 0; nBits--)
-        *dest++ = table[*src++];
+    Level table16[16] = { LV_L };   // padded for a 16-entry byte shuffle
+    memcpy(table16, table, 12 * sizeof(Level));
+    gLVecOps->unaryOp(src, dest, nBits, table16);
 }
 
 // Do a binary operation on 2 LVectors into a 3rd LVector. Op uses table.
 
 void binaryOpLVec(Level* src0, Level* src1, Level* dest, size_t nBits,
-                  Level table[12][16])
+                  const Level table[12][16])
 {
-    for ( ; nBits > 0; nBits--)
-        *dest++ = table[*src0++][*src1++];
+    gLVecOps->binaryOp(src0, src1, dest, nBits, table);
+}
+
+//-----------------------------------------------------------------------------
+//                          Word-Form Vector Routines
+//-----------------------------------------------------------------------------
+
+// These work on temp vectors in word form (see LWord in VLCoder.h), using
+// word logic when every bit is LV_L or LV_H and the LVector routines above
+// when any bit is unknown. A value's bits above nBits are always zero.
+
+const size_t bitsPerWord = sizeof(size_t)*8;
+
+// Return a mask of the low nBits bits of a word.
+
+static inline size_t wordMask(size_t nBits)
+{
+    return (nBits < bitsPerWord ? ((size_t)1 << nBits) - 1 : ~(size_t)0);
+}
+
+// Return a mask of the bits used in the most significant word of an
+// nBits-bit value.
+
+static inline size_t topWordMask(size_t nBits)
+{
+    return wordMask((nBits - 1) % bitsPerWord + 1);
+}
+
+// Pack an LVector's LV_H bits into words, LSW first. Each word takes the
+// last bitsPerWord levels left, so the MS word takes what remains.
+
+static void packLVec(Level* levVec, size_t* value, size_t nBits)
+{
+    size_t end = nBits;
+    for ( ; end > bitsPerWord; end -= bitsPerWord)
+        *value++ = convLVecToInt(levVec + end - bitsPerWord, bitsPerWord);
+    *value = convLVecToInt(levVec, end);
+}
+
+// Unpack words, LSW first, into an LVector of LV_L and LV_H levels.
+
+static void unpackLVec(size_t* value, Level* levVec, size_t nBits)
+{
+    size_t end = nBits;
+    for ( ; end > bitsPerWord; end -= bitsPerWord)
+        convIntToLVec(*value++, levVec + end - bitsPerWord, bitsPerWord);
+    convIntToLVec(*value, levVec, end);
+}
+
+// Set a word-form temp's value and known flag from its LVector.
+
+static void setWordFromLVec(LWord* word, size_t nBits)
+{
+    size_t nHigh;
+    Level* levVec = word->levels(nBits);
+    packLVec(levVec, word->value, nBits);
+    word->known = gLVecOps->countHigh(levVec, nBits, &nHigh);
+}
+
+// Load bits starting at i from Vector signal sigVec as an integer, width n,
+// after checking bits are in range [0,iMax]. Same as loadIndVector()
+// followed by convLVecToInt(), but without a temp LVector in the frame.
+
+size_t loadIndInt(SignalVec* sigVec, size_t i, size_t iMax, size_t nBits)
+{
+    Level levVec[bitsPerWord];
+    loadIndVector(sigVec, i, iMax, levVec, nBits);
+    return convLVecToInt(levVec, nBits);
+}
+
+// Load bits starting at i from Vector signal sigVec into a word-form temp,
+// width n, after checking bits are in range [0,iMax]. The levels are copied
+// first, as a level-by-level word build is held up by mispredicted branches
+// or its serial shifts, and then checked and packed by the gLVecOps kernels.
+
+void loadIndWord(SignalVec* sigVec, size_t i, size_t iMax,
+                 LWord* word, size_t nBits)
+{
+    loadIndVector(sigVec, i, iMax, word->levels(nBits), nBits);
+    setWordFromLVec(word, nBits);
+}
+
+// Convert an integer to a word-form temp, zero-extended.
+
+void convIntToWord(size_t value, LWord* word, size_t nBits)
+{
+    size_t nWords = LWord::nWords(nBits);
+    word->value[0] = value;
+    for (size_t k = 1; k < nWords; k++)
+        word->value[k] = 0;
+    word->value[nWords-1] &= topWordMask(nBits);
+    word->known = TRUE;
+}
+
+// Convert an LVector to a word-form temp, copying the levels only if a bit
+// is unknown.
+
+void convLVecToWord(Level* levVec, LWord* word, size_t nBits)
+{
+    size_t nHigh;
+    packLVec(levVec, word->value, nBits);
+    word->known = gLVecOps->countHigh(levVec, nBits, &nHigh);
+    if (!word->known)
+        memcpy(word->levels(nBits), levVec, nBits);
+}
+
+// Bring a word-form temp's LVector up to date.
+
+void convWordToLVec(LWord* word, size_t nBits)
+{
+    if (word->known)
+        unpackLVec(word->value, word->levels(nBits), nBits);
+}
+
+// Change the width of a word-form temp into a 2nd one, truncating its high
+// bits or zero-extending it.
+
+void resizeWord(LWord* src, size_t srcBits, LWord* dest, size_t destBits)
+{
+    if (src->known)
+    {
+        size_t nSrc = LWord::nWords(srcBits);
+        size_t nDest = LWord::nWords(destBits);
+        for (size_t k = 0; k < nDest; k++)
+            dest->value[k] = (k < nSrc ? src->value[k] : 0);
+        dest->value[nDest-1] &= topWordMask(destBits);
+        dest->known = TRUE;
+        return;
+    }
+    Level* srcVec = src->levels(srcBits);
+    Level* destVec = dest->levels(destBits);
+    if (destBits > srcBits)
+    {
+        memset(destVec, LV_L, destBits - srcBits);
+        memcpy(destVec + destBits - srcBits, srcVec, srcBits);
+    }
+    else
+        memcpy(destVec, srcVec + srcBits - destBits, destBits);
+    setWordFromLVec(dest, destBits);
+}
+
+// Do a unary AND on a word-form temp, returning a single Level.
+
+size_t uandWord(LWord* word, size_t nBits)
+{
+    if (word->known)
+    {
+        size_t nWords = LWord::nWords(nBits);
+        for (size_t k = 0; k < nWords-1; k++)
+            if (word->value[k] != ~(size_t)0)
+                return LV_L;
+        return (word->value[nWords-1] == topWordMask(nBits) ? LV_H : LV_L);
+    }
+    return uandLVec(word->levels(nBits), nBits);
+}
+
+// Do a unary NAND on a word-form temp, returning a single Level.
+
+size_t unandWord(LWord* word, size_t nBits)
+{
+    return funcTable.INVERTtable[uandWord(word, nBits)];
+}
+
+// Do a unary OR on a word-form temp, returning a single Level.
+
+size_t uorWord(LWord* word, size_t nBits)
+{
+    if (word->known)
+    {
+        size_t nWords = LWord::nWords(nBits);
+        for (size_t k = 0; k < nWords; k++)
+            if (word->value[k])
+                return LV_H;
+        return LV_L;
+    }
+    return uorLVec(word->levels(nBits), nBits);
+}
+
+// Do a unary NOR on a word-form temp, returning a single Level.
+
+size_t unorWord(LWord* word, size_t nBits)
+{
+    return funcTable.INVERTtable[uorWord(word, nBits)];
+}
+
+// Do a unary XOR on a word-form temp to get the resulting even parity as a
+// Level.
+
+size_t uxorWord(LWord* word, size_t nBits)
+{
+    if (word->known)
+    {
+        size_t nWords = LWord::nWords(nBits);
+        size_t value = 0;
+        for (size_t k = 0; k < nWords; k++)
+            value ^= word->value[k];
+        for (size_t shift = bitsPerWord/2; shift > 0; shift >>= 1)
+            value ^= value >> shift;
+        return ((value & 1) ? LV_H : LV_L);
+    }
+    return uxorLVec(word->levels(nBits), nBits);
+}
+
+// Do a bitwise complement of a word-form temp into a 2nd one.
+
+void comWord(LWord* src, LWord* dest, size_t nBits)
+{
+    if (src->known)
+    {
+        size_t nWords = LWord::nWords(nBits);
+        for (size_t k = 0; k < nWords; k++)
+            dest->value[k] = ~src->value[k];
+        dest->value[nWords-1] &= topWordMask(nBits);
+        dest->known = TRUE;
+        return;
+    }
+    unaryOpLVec(src->levels(nBits), dest->levels(nBits), nBits,
+                funcTable.INVERTtable);
+    setWordFromLVec(dest, nBits);
+}
+
+// Do a binary operation on 2 word-form temps with an unknown bit into a 3rd,
+// using the LVector routines. Op uses table.
+
+static void binaryOpWordLVec(LWord* src0, LWord* src1, LWord* dest,
+                             size_t nBits, const Level table[12][16])
+{
+    convWordToLVec(src0, nBits);
+    convWordToLVec(src1, nBits);
+    binaryOpLVec(src0->levels(nBits), src1->levels(nBits),
+                 dest->levels(nBits), nBits, table);
+    setWordFromLVec(dest, nBits);
+}
+
+// Do a bitwise AND of 2 word-form temps into a 3rd.
+
+void andWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits)
+{
+    if (src0->known && src1->known)
+    {
+        size_t nWords = LWord::nWords(nBits);
+        for (size_t k = 0; k < nWords; k++)
+            dest->value[k] = src0->value[k] & src1->value[k];
+        dest->known = TRUE;
+    }
+    else
+        binaryOpWordLVec(src0, src1, dest, nBits, funcTable.ANDtable);
+}
+
+// Do a bitwise OR of 2 word-form temps into a 3rd.
+
+void orWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits)
+{
+    if (src0->known && src1->known)
+    {
+        size_t nWords = LWord::nWords(nBits);
+        for (size_t k = 0; k < nWords; k++)
+            dest->value[k] = src0->value[k] | src1->value[k];
+        dest->known = TRUE;
+    }
+    else
+        binaryOpWordLVec(src0, src1, dest, nBits, funcTable.ORtable);
+}
+
+// Do a bitwise XOR of 2 word-form temps into a 3rd.
+
+void xorWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits)
+{
+    if (src0->known && src1->known)
+    {
+        size_t nWords = LWord::nWords(nBits);
+        for (size_t k = 0; k < nWords; k++)
+            dest->value[k] = src0->value[k] ^ src1->value[k];
+        dest->known = TRUE;
+    }
+    else
+        binaryOpWordLVec(src0, src1, dest, nBits, funcTable.XORtable);
+}
+
+// The arithmetic, shift and compare routines below are used on vectors too
+// wide for an integer. As with integers, they take each unknown bit as a 0,
+// using just the value words, so their results are known.
+
+// Add 2 word-form temps into a 3rd, modulo 2^nBits.
+
+void addWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits)
+{
+    size_t nWords = LWord::nWords(nBits);
+    size_t carry = 0;
+    for (size_t k = 0; k < nWords; k++)
+    {
+        size_t a = src0->value[k];
+        size_t sum = a + src1->value[k];
+        size_t carryOut = (sum < a);
+        sum += carry;
+        dest->value[k] = sum;
+        carry = carryOut | (sum < carry);
+    }
+    dest->value[nWords-1] &= topWordMask(nBits);
+    dest->known = TRUE;
+}
+
+// Subtract a word-form temp from another into a 3rd, modulo 2^nBits.
+
+void subWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits)
+{
+    size_t nWords = LWord::nWords(nBits);
+    size_t borrow = 0;
+    for (size_t k = 0; k < nWords; k++)
+    {
+        size_t a = src0->value[k];
+        size_t diff = a - src1->value[k];
+        size_t borrowOut = (diff > a);
+        dest->value[k] = diff - borrow;
+        borrow = borrowOut | (diff < borrow);
+    }
+    dest->value[nWords-1] &= topWordMask(nBits);
+    dest->known = TRUE;
+}
+
+// Multiply 2 words, returning the low word of the product and setting *hi
+// to the high word.
+
+static inline size_t mulWords(size_t a, size_t b, size_t* hi)
+{
+    const int half = bitsPerWord/2;
+    const size_t halfMask = wordMask(half);
+    size_t a0 = a & halfMask, a1 = a >> half;
+    size_t b0 = b & halfMask, b1 = b >> half;
+    size_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0;
+    size_t mid = (p00 >> half) + (p01 & halfMask) + (p10 & halfMask);
+    *hi = a1 * b1 + (p01 >> half) + (p10 >> half) + (mid >> half);
+    return (mid << half) | (p00 & halfMask);
+}
+
+// Multiply 2 word-form temps into a 3rd, modulo 2^nBits. Dest must not be
+// a source.
+
+void mulWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits)
+{
+    size_t nWords = LWord::nWords(nBits);
+    size_t k;
+    for (k = 0; k < nWords; k++)
+        dest->value[k] = 0;
+    for (size_t i = 0; i < nWords; i++)
+    {
+        size_t carry = 0;
+        for (k = i; k < nWords; k++)
+        {
+            size_t hi;
+            size_t lo = mulWords(src0->value[i], src1->value[k - i], &hi);
+            lo += carry;
+            hi += (lo < carry);
+            dest->value[k] += lo;
+            carry = hi + (dest->value[k] < lo);
+        }
+    }
+    dest->value[nWords-1] &= topWordMask(nBits);
+    dest->known = TRUE;
+}
+
+// Shift a word-form temp left by count bits into a 2nd one.
+
+void slaWord(size_t count, LWord* src, LWord* dest, size_t nBits)
+{
+    size_t nWords = LWord::nWords(nBits);
+    size_t wordShift = count / bitsPerWord;
+    size_t bitShift = count % bitsPerWord;
+    for (size_t k = nWords; k-- > 0; )
+    {
+        size_t value = 0;
+        if (k >= wordShift)
+        {
+            value = src->value[k - wordShift] << bitShift;
+            if (bitShift && k > wordShift)
+                value |= src->value[k - wordShift - 1] >>
+                         (bitsPerWord - bitShift);
+        }
+        dest->value[k] = value;
+    }
+    dest->value[nWords-1] &= topWordMask(nBits);
+    dest->known = TRUE;
+}
+
+// Shift a word-form temp right by count bits into a 2nd one.
+
+void sraWord(size_t count, LWord* src, LWord* dest, size_t nBits)
+{
+    size_t nWords = LWord::nWords(nBits);
+    size_t wordShift = count / bitsPerWord;
+    size_t bitShift = count % bitsPerWord;
+    for (size_t k = 0; k < nWords; k++)
+    {
+        size_t value = 0;
+        if (wordShift < nWords - k)
+        {
+            value = src->value[k + wordShift] >> bitShift;
+            if (bitShift && wordShift < nWords - k - 1)
+                value |= src->value[k + wordShift + 1] <<
+                         (bitsPerWord - bitShift);
+        }
+        dest->value[k] = value;
+    }
+    dest->known = TRUE;
+}
+
+// Compare 2 word-form temps, returning 0 if src0 < src1, 1 if they're equal,
+// or 2 if src0 > src1.
+
+size_t cmpWord(LWord* src0, LWord* src1, size_t nBits)
+{
+    for (size_t k = LWord::nWords(nBits); k-- > 0; )
+        if (src0->value[k] != src1->value[k])
+            return (src0->value[k] > src1->value[k] ? 2 : 0);
+    return 1;
+}
+
+// OR a part's value words into a concatenation word-form temp's, with the
+// part's LSB at bit lsb.
+
+static void catBits(size_t* value, size_t nBits, LWord* dest,
+                    size_t destBits, size_t lsb)
+{
+    size_t nWords = LWord::nWords(nBits);
+    size_t nDestWords = LWord::nWords(destBits);
+    size_t bitShift = lsb % bitsPerWord;
+    size_t* dp = dest->value + lsb / bitsPerWord;
+    for (size_t k = 0; k < nWords; k++, dp++)
+    {
+        *dp |= value[k] << bitShift;
+        if (bitShift && dp + 1 < dest->value + nDestWords)
+            dp[1] |= value[k] >> (bitsPerWord - bitShift);
+    }
+}
+
+// Concatenate a word-form temp into a concatenation word-form temp, which
+// was cleared by convIntToWord(), with the part's LSB at bit lsb. Once the
+// part or the concatenation has an unknown bit, the levels of this and each
+// later part are copied into the concatenation's LVector too.
+
+void catWord(LWord* part, size_t nBits, LWord* dest, size_t destBits,
+             size_t lsb)
+{
+    catBits(part->value, nBits, dest, destBits, lsb);
+    if (part->known && dest->known)
+        return;
+    if (dest->known)
+    {
+        convWordToLVec(dest, destBits);
+        dest->known = FALSE;
+    }
+    convWordToLVec(part, nBits);
+    memcpy(dest->levels(destBits) + destBits - lsb - nBits,
+           part->levels(nBits), nBits);
+}
+
+// Concatenate a Level into a concatenation word-form temp at bit lsb.
+
+void catLevelWord(size_t level, LWord* dest, size_t destBits, size_t lsb)
+{
+    if (level == LV_H)
+        dest->value[lsb / bitsPerWord] |= (size_t)1 << (lsb % bitsPerWord);
+    else if (level != LV_L && dest->known)
+    {
+        convWordToLVec(dest, destBits);
+        dest->known = FALSE;
+    }
+    if (!dest->known)
+        dest->levels(destBits)[destBits - 1 - lsb] = (Level)level;
+}
+
+//-----------------------------------------------------------------------------
+// After a write to element i of a memory, toggle the signals of the readers
+//  that last read that element. The memory's trigger signal is only toggled
+//  if something still depends on the whole memory, such as a task or a
+//  reference from another module.
+
+void postMemWrite(Model* model, size_t i, MemHead* head)
+{
+    for (MemWatch* w = head->watchers; w; w = w->next)
+        if (w->index == i)
+            model->addEventV(0, w->signal, inv(w->signal), CLEAN);
+
+    Signal* trigger = head->signal;
+    if (trigger->dependBegin() != trigger->dependEnd())
+        model->addEventV(0, trigger, inv(trigger), CLEAN);
 }
 
 //-----------------------------------------------------------------------------
@@ -254,9 +749,9 @@ void verStop(size_t n)
 {
     if (gTick/gTicksNS > 1000000) // int run times are in milliseconds
         display("\nSTOP #%d at %7.6f ms\n", n,
-                ((float)gTick/gTicksNS)/1000000.);
+                ((double)gTick/gTicksNS)/1000000.);
     else
-        display("\nSTOP #%d at %2.1f ns\n", n, (float)gTick/gTicksNS);
+        display("\nSTOP #%d at %2.1f ns\n", n, (double)gTick/gTicksNS);
     gTEnd = gTick;  // force end of simulation loop
 }
 
@@ -315,6 +810,25 @@ size_t verFOpen(char* fName)
     return (size_t)file;
 }
 
+//-----------------------------------------------------------------------------
+// fdisplay(file, fmt, ...): Write to a file opened by fopen().
+
+void verFDisplay(size_t file, const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf((FILE*)file, fmt, ap);
+    va_end(ap);
+}
+
+//-----------------------------------------------------------------------------
+// fclose(file): Close a file opened by fopen().
+
+void verFClose(size_t file)
+{
+    fclose((FILE*)file);
+}
+
 //-----------------------------------------------------------------------------
 // Read an Altera .mif memory initialization file into a memory element.
 
@@ -324,7 +838,7 @@ size_t ModelSysLib::scanNumber(size_t base)
     char anum[20];
     if (isToken(NUMBER_TOKEN))
     {
-        snprintf(anum, 19, "%d", gScToken->number);
+        snprintf(anum, 19, "%lld", gScToken->number);
         name = anum;
     }
     else
@@ -398,9 +912,11 @@ void ModelSysLib::readmemmif(char* mifName, Memory* mem)
             }
             else if (isName("CONTENT"))
             {
-                // skips over trigger signal pointer
+                // skips over memory's head
                 size_t* memArray = (size_t*)(this->instModule + mem->disp +
-                                             sizeof(Signal*));
+                                             sizeof(MemHead));
+                MemPages* pages = (mem->isPaged() ? *(MemPages**)memArray :
+                                                    0);
                 scan();
                 expectName("BEGIN");
                 scan();
@@ -436,7 +952,10 @@ void ModelSysLib::readmemmif(char* mifName, Memory* mem)
                         size_t value = scanNumber(dataBase);
                         expectSkip(';');
                         for ( ; adr <= endAdr; adr++)
-                            memArray[adr] = value;
+                            if (pages)
+                                stoMemPage(adr, value, pages);
+                            else
+                                memArray[adr] = value;
                     }
                     else
                     {
@@ -444,7 +963,10 @@ void ModelSysLib::readmemmif(char* mifName, Memory* mem)
                         expectSkip(':');
                         size_t value = scanNumber(dataBase);
                         expectSkip(';');
-                        memArray[adr] = value;
+                        if (pages)
+                            stoMemPage(adr, value, pages);
+                        else
+                            memArray[adr] = value;
                     }
                 }
                 expectName("END");
@@ -744,7 +1266,7 @@ void codeFunction(Expr* ex)
             codeCall((Subr*)display, nArgs, 0, 1);
             break;
         case sf_fdisplay:
-            codeCall((Subr*)fprintf, nArgs, 0, 2);
+            codeCall((Subr*)verFDisplay, nArgs, 0, 2);
             break;
         case sf_annotate:
             codeCall((Subr*)drawf, nArgs, 0, 2);
@@ -895,7 +1417,7 @@ void codeSystemCall()
     else if (strcmp(sysCallName, "fclose") == 0)
     {
         codeIntArgs(1);
-        codeCall((Subr*)fclose, 1);
+        codeCall((Subr*)verFClose, 1);
     }
 
     // annotate(signal, fmt, ...)
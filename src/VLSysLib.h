@@ -42,12 +42,16 @@ struct SysCall
 
 extern SysCall gSysCalls[];
 
+struct LWord;
+struct MemHead;
+
 // Verilog library routines
 
 size_t loadIndScalar(SignalVec* sigVec, size_t i, size_t iMax);
 void loadIndVector(SignalVec* sigVec, size_t i, size_t iMax,
                     Level* levVec, size_t n);
 void sampleVector(Level* levVec, size_t nBits);
+void copyLVec(Level* dest, const Level* src, size_t nBytes);
 void codeConcat(Expr* ex);
 void convIntToLVec(size_t value, Level* levVec, size_t nBits);
 size_t convLVecToInt(Level* levVec, size_t nBits);
@@ -56,9 +60,36 @@ size_t unandLVec(Level* levVec, size_t nBits);
 size_t uorLVec(Level* levVec, size_t nBits);
 size_t unorLVec(Level* levVec, size_t nBits);
 size_t uxorLVec(Level* levVec, size_t nBits);
-void unaryOpLVec(Level* src, Level* dest, size_t nBits, Level table[12]);
+void unaryOpLVec(Level* src, Level* dest, size_t nBits,
+                 const Level table[12]);
 void binaryOpLVec(Level* src0, Level* src1, Level* dest, size_t nBits,
-                  Level table[12][16]);
+                  const Level table[12][16]);
+size_t loadIndInt(SignalVec* sigVec, size_t i, size_t iMax, size_t nBits);
+void loadIndWord(SignalVec* sigVec, size_t i, size_t iMax,
+                 LWord* word, size_t nBits);
+void convIntToWord(size_t value, LWord* word, size_t nBits);
+void convLVecToWord(Level* levVec, LWord* word, size_t nBits);
+void convWordToLVec(LWord* word, size_t nBits);
+void resizeWord(LWord* src, size_t srcBits, LWord* dest, size_t destBits);
+size_t uandWord(LWord* word, size_t nBits);
+size_t unandWord(LWord* word, size_t nBits);
+size_t uorWord(LWord* word, size_t nBits);
+size_t unorWord(LWord* word, size_t nBits);
+size_t uxorWord(LWord* word, size_t nBits);
+void comWord(LWord* src, LWord* dest, size_t nBits);
+void andWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits);
+void orWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits);
+void xorWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits);
+void addWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits);
+void subWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits);
+void mulWord(LWord* src0, LWord* src1, LWord* dest, size_t nBits);
+void slaWord(size_t count, LWord* src, LWord* dest, size_t nBits);
+void sraWord(size_t count, LWord* src, LWord* dest, size_t nBits);
+size_t cmpWord(LWord* src0, LWord* src1, size_t nBits);
+void catWord(LWord* part, size_t nBits, LWord* dest, size_t destBits,
+             size_t lsb);
+void catLevelWord(size_t level, LWord* dest, size_t destBits, size_t lsb);
+void postMemWrite(Model* model, size_t i, MemHead* head);
 void verLine(size_t isrcLoc);
 void verBreakpoint(size_t ircLoc);
 
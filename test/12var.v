@@ -9,6 +9,10 @@ module main;
     reg         Reg1, Reg2;
     reg [1:0]   Vec1, Vec2;
     reg [1:0]   Mem1[0:1];
+    reg [15:0]  Mem2[0:16777215];
+    wire [1:0]  Mem1r;
+
+    assign Mem1r = Mem1[1];
 
     initial begin
         Int1 = 5678;
@@ -19,6 +23,8 @@ module main;
         Vec2 <= 1 + 2;
         Mem1[0] <= 3;
         Mem1[1] <= 1;
+        Mem2[5] = 16'h1234;
+        Mem2[16777215] = 16'hbeef;
         #1;
         $display("Int1 = %d (5678)", Int1);
         $display("Int2 = %d (12340000)", Int2);
@@ -28,6 +34,10 @@ module main;
         $display("Vec2 = %h (3)", Vec2);
         $display("Mem1[0] = %h (3)", Mem1[0]);
         $display("Mem1[1] = %h (1)", Mem1[1]);
+        $display("Mem1r = %h (1)", Mem1r);
+        $display("Mem2[5] = %h (1234)", Mem2[5]);
+        $display("Mem2[6] = %h (0)", Mem2[6]);
+        $display("Mem2[16777215] = %h (beef)", Mem2[16777215]);
         $display("expr int = %d (12345678)", Int1 + Int2);
         $display("expr 1b = %h (1)", Reg1 | Reg2);
         $display("expr vec = %h (4)", (Vec2 - Vec1) << 2);
@@ -37,6 +47,11 @@ module main;
         $display("expr mix = %h (3)",
             (Int2 == 0) ? {Reg1, ~Reg2} : Vec1 + Mem1[1]);
         
+        Mem1[0] <= 0;
+        Mem1[1] <= 2;
+        #1;
+        $display("Mem1r = %h (2)", Mem1r);
+
         $display("<done>");
     end
 
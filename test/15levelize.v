@@ -0,0 +1,45 @@
+// Verilog compiler test -- levelized zero-delay assigns
+
+`timescale 1 ps / 1 ps
+
+module main;
+    reg ErrFlag;
+
+    reg         A, B;
+    wire        N1, N2, N3, N4, Out;
+    wire [3:0]  V1, V2;
+
+    // a chain of hidden nets, set directly by the levelized sweep
+    assign N1 = A & B;
+    assign N2 = ~N1;
+    assign N3 = N2 | A;
+    assign N4 = N3 ^ N1;
+    assign Out = N4;
+
+    assign V1 = {A, B, N1, N2};
+    assign V2 = V1 + 4'd1;
+
+    initial begin
+        $timeformat(-12, 0, " ps", 6);
+        A = 0;
+        B = 0;
+        #1000;
+        // 1001 ps
+        $display("%t: Out    = %h (1)", $time, Out);
+        $display("%t: V2     = %h (2)", $time, V2);
+        A = 1;
+        B = 1;
+        #3;
+        // 1003 ps: the chain settled in the tick after its inputs changed
+        $display("%t: Out    = %h (0)", $time, Out);
+        $display("%t: V2     = %h (f)", $time, V2);
+        B = 0;
+        #3;
+        // 1005 ps
+        $display("%t: Out    = %h (1)", $time, Out);
+        $display("%t: V2     = %h (a)", $time, V2);
+
+        #10;
+        $display("<done>");
+    end
+endmodule
@@ -0,0 +1,375 @@
+// Verilog compiler test -- vectors wider than an integer
+
+`timescale 1 ns / 100 ps
+
+module wide72;
+    reg [71:0] A, B, R;
+
+    initial begin
+        #1;
+        A = 72'hf2c7859faeecc3f80c;
+        B = 72'he47682e64a37fa2d;
+        #0.01;
+        R <= A + B;
+        #0.01;
+        $display("72: A+B[71:64] = %h (f3)", R[71:64]);
+        $display("72: A+B[63:32] = %h (abfc2295)", R[63:32]);
+        $display("72: A+B[31:0] = %h (36fbf239)", R[31:0]);
+        R <= A - B;
+        #0.01;
+        $display("72: A-B[71:64] = %h (f1)", R[71:64]);
+        $display("72: A-B[63:32] = %h (e30f1cc8)", R[63:32]);
+        $display("72: A-B[31:0] = %h (a28bfddf)", R[31:0]);
+        R <= B - A;
+        #0.01;
+        $display("72: B-A[71:64] = %h (e)", R[71:64]);
+        $display("72: B-A[63:32] = %h (1cf0e337)", R[63:32]);
+        $display("72: B-A[31:0] = %h (5d740221)", R[31:0]);
+        R <= A * B;
+        #0.01;
+        $display("72: A*B[71:64] = %h (6)", R[71:64]);
+        $display("72: A*B[63:32] = %h (b1025b8c)", R[63:32]);
+        $display("72: A*B[31:0] = %h (c142521c)", R[31:0]);
+        R <= A << 1;
+        #0.01;
+        $display("72: A<<1[71:64] = %h (e5)", R[71:64]);
+        $display("72: A<<1[63:32] = %h (8f0b3f5d)", R[63:32]);
+        $display("72: A<<1[31:0] = %h (d987f018)", R[31:0]);
+        R <= A >> 1;
+        #0.01;
+        $display("72: A>>1[71:64] = %h (79)", R[71:64]);
+        $display("72: A>>1[63:32] = %h (63c2cfd7)", R[63:32]);
+        $display("72: A>>1[31:0] = %h (7661fc06)", R[31:0]);
+        R <= A << 31;
+        #0.01;
+        $display("72: A<<31[71:64] = %h (d7)", R[71:64]);
+        $display("72: A<<31[63:32] = %h (7661fc06)", R[63:32]);
+        $display("72: A<<31[31:0] = %h (0)", R[31:0]);
+        R <= A >> 31;
+        #0.01;
+        $display("72: A>>31[71:64] = %h (0)", R[71:64]);
+        $display("72: A>>31[63:32] = %h (1e5)", R[63:32]);
+        $display("72: A>>31[31:0] = %h (8f0b3f5d)", R[31:0]);
+        R <= A << 64;
+        #0.01;
+        $display("72: A<<64[71:64] = %h (c)", R[71:64]);
+        $display("72: A<<64[63:32] = %h (0)", R[63:32]);
+        $display("72: A<<64[31:0] = %h (0)", R[31:0]);
+        R <= A >> 64;
+        #0.01;
+        $display("72: A>>64[71:64] = %h (0)", R[71:64]);
+        $display("72: A>>64[63:32] = %h (0)", R[63:32]);
+        $display("72: A>>64[31:0] = %h (f2)", R[31:0]);
+        R <= A << 67;
+        #0.01;
+        $display("72: A<<67[71:64] = %h (60)", R[71:64]);
+        $display("72: A<<67[63:32] = %h (0)", R[63:32]);
+        $display("72: A<<67[31:0] = %h (0)", R[31:0]);
+        R <= A >> 67;
+        #0.01;
+        $display("72: A>>67[71:64] = %h (0)", R[71:64]);
+        $display("72: A>>67[63:32] = %h (0)", R[63:32]);
+        $display("72: A>>67[31:0] = %h (1e)", R[31:0]);
+        $display("72: A == B = %d (0)", A == B);
+        $display("72: B == A = %d (0)", B == A);
+        $display("72: A == A = %d (1)", A == A);
+        $display("72: A != B = %d (1)", A != B);
+        $display("72: B != A = %d (1)", B != A);
+        $display("72: A != A = %d (0)", A != A);
+        $display("72: A < B = %d (0)", A < B);
+        $display("72: B < A = %d (1)", B < A);
+        $display("72: A < A = %d (0)", A < A);
+        $display("72: A <= B = %d (0)", A <= B);
+        $display("72: B <= A = %d (1)", B <= A);
+        $display("72: A <= A = %d (1)", A <= A);
+        $display("72: A > B = %d (1)", A > B);
+        $display("72: B > A = %d (0)", B > A);
+        $display("72: A > A = %d (0)", A > A);
+        $display("72: A >= B = %d (1)", A >= B);
+        $display("72: B >= A = %d (0)", B >= A);
+        $display("72: A >= A = %d (1)", A >= A);
+    end
+endmodule
+
+module wide128;
+    reg [127:0] A, B, R;
+
+    initial begin
+        #2;
+        A = 128'h978f18a7045f21da156393d8d46375dc;
+        B = 128'h87b3d9611244c06c7ab5c94e86c4fa;
+        #0.01;
+        R <= A + B;
+        #0.01;
+        $display("128: A+B[127:96] = %h (9816cc80)", R[127:96]);
+        $display("128: A+B[95:64] = %h (6571669a)", R[95:64]);
+        $display("128: A+B[63:32] = %h (81de49a2)", R[63:32]);
+        $display("128: A+B[31:0] = %h (22ea3ad6)", R[31:0]);
+        R <= A - B;
+        #0.01;
+        $display("128: A-B[127:96] = %h (970764cd)", R[127:96]);
+        $display("128: A-B[95:64] = %h (a34cdd19)", R[95:64]);
+        $display("128: A-B[63:32] = %h (a8e8de0f)", R[63:32]);
+        $display("128: A-B[31:0] = %h (85dcb0e2)", R[31:0]);
+        R <= B - A;
+        #0.01;
+        $display("128: B-A[127:96] = %h (68f89b32)", R[127:96]);
+        $display("128: B-A[95:64] = %h (5cb322e6)", R[95:64]);
+        $display("128: B-A[63:32] = %h (571721f0)", R[63:32]);
+        $display("128: B-A[31:0] = %h (7a234f1e)", R[31:0]);
+        R <= A * B;
+        #0.01;
+        $display("128: A*B[127:96] = %h (f65d06e9)", R[127:96]);
+        $display("128: A*B[95:64] = %h (c282f60c)", R[95:64]);
+        $display("128: A*B[63:32] = %h (a3e9f410)", R[63:32]);
+        $display("128: A*B[31:0] = %h (488588d8)", R[31:0]);
+        R <= A << 1;
+        #0.01;
+        $display("128: A<<1[127:96] = %h (2f1e314e)", R[127:96]);
+        $display("128: A<<1[95:64] = %h (8be43b4)", R[95:64]);
+        $display("128: A<<1[63:32] = %h (2ac727b1)", R[63:32]);
+        $display("128: A<<1[31:0] = %h (a8c6ebb8)", R[31:0]);
+        R <= A >> 1;
+        #0.01;
+        $display("128: A>>1[127:96] = %h (4bc78c53)", R[127:96]);
+        $display("128: A>>1[95:64] = %h (822f90ed)", R[95:64]);
+        $display("128: A>>1[63:32] = %h (ab1c9ec)", R[63:32]);
+        $display("128: A>>1[31:0] = %h (6a31baee)", R[31:0]);
+        R <= A << 31;
+        #0.01;
+        $display("128: A<<31[127:96] = %h (822f90ed)", R[127:96]);
+        $display("128: A<<31[95:64] = %h (ab1c9ec)", R[95:64]);
+        $display("128: A<<31[63:32] = %h (6a31baee)", R[63:32]);
+        $display("128: A<<31[31:0] = %h (0)", R[31:0]);
+        R <= A >> 31;
+        #0.01;
+        $display("128: A>>31[127:96] = %h (1)", R[127:96]);
+        $display("128: A>>31[95:64] = %h (2f1e314e)", R[95:64]);
+        $display("128: A>>31[63:32] = %h (8be43b4)", R[63:32]);
+        $display("128: A>>31[31:0] = %h (2ac727b1)", R[31:0]);
+        R <= A << 64;
+        #0.01;
+        $display("128: A<<64[127:96] = %h (156393d8)", R[127:96]);
+        $display("128: A<<64[95:64] = %h (d46375dc)", R[95:64]);
+        $display("128: A<<64[63:32] = %h (0)", R[63:32]);
+        $display("128: A<<64[31:0] = %h (0)", R[31:0]);
+        R <= A >> 64;
+        #0.01;
+        $display("128: A>>64[127:96] = %h (0)", R[127:96]);
+        $display("128: A>>64[95:64] = %h (0)", R[95:64]);
+        $display("128: A>>64[63:32] = %h (978f18a7)", R[63:32]);
+        $display("128: A>>64[31:0] = %h (45f21da)", R[31:0]);
+        R <= A << 123;
+        #0.01;
+        $display("128: A<<123[127:96] = %h (e0000000)", R[127:96]);
+        $display("128: A<<123[95:64] = %h (0)", R[95:64]);
+        $display("128: A<<123[63:32] = %h (0)", R[63:32]);
+        $display("128: A<<123[31:0] = %h (0)", R[31:0]);
+        R <= A >> 123;
+        #0.01;
+        $display("128: A>>123[127:96] = %h (0)", R[127:96]);
+        $display("128: A>>123[95:64] = %h (0)", R[95:64]);
+        $display("128: A>>123[63:32] = %h (0)", R[63:32]);
+        $display("128: A>>123[31:0] = %h (12)", R[31:0]);
+        $display("128: A == B = %d (0)", A == B);
+        $display("128: B == A = %d (0)", B == A);
+        $display("128: A == A = %d (1)", A == A);
+        $display("128: A != B = %d (1)", A != B);
+        $display("128: B != A = %d (1)", B != A);
+        $display("128: A != A = %d (0)", A != A);
+        $display("128: A < B = %d (0)", A < B);
+        $display("128: B < A = %d (1)", B < A);
+        $display("128: A < A = %d (0)", A < A);
+        $display("128: A <= B = %d (0)", A <= B);
+        $display("128: B <= A = %d (1)", B <= A);
+        $display("128: A <= A = %d (1)", A <= A);
+        $display("128: A > B = %d (1)", A > B);
+        $display("128: B > A = %d (0)", B > A);
+        $display("128: A > A = %d (0)", A > A);
+        $display("128: A >= B = %d (1)", A >= B);
+        $display("128: B >= A = %d (0)", B >= A);
+        $display("128: A >= A = %d (1)", A >= A);
+    end
+endmodule
+
+module wide200;
+    reg [199:0] A, B, R;
+
+    initial begin
+        #3;
+        A = 200'h8371cf92e3447324943126b9c3b9d8249e215b88925bab1eec;
+        B = 200'h1b1c3f27065720cee6d30f0a747d0a2b9ec2d776389605fe;
+        #0.01;
+        R <= A + B;
+        #0.01;
+        $display("200: A+B[199:192] = %h (83)", R[199:192]);
+        $display("200: A+B[191:160] = %h (8cebd20a)", R[191:160]);
+        $display("200: A+B[159:128] = %h (4aca4563)", R[159:128]);
+        $display("200: A+B[127:96] = %h (17f9c8ce)", R[127:96]);
+        $display("200: A+B[95:64] = %h (2e552ec9)", R[95:64]);
+        $display("200: A+B[63:32] = %h (c01e6008)", R[63:32]);
+        $display("200: A+B[31:0] = %h (944124ea)", R[31:0]);
+        R <= A - B;
+        #0.01;
+        $display("200: A-B[199:192] = %h (83)", R[199:192]);
+        $display("200: A-B[191:160] = %h (56b353bc)", R[191:160]);
+        $display("200: A-B[159:128] = %h (3e1c03c5)", R[159:128]);
+        $display("200: A-B[127:96] = %h (4a53aab9)", R[127:96]);
+        $display("200: A-B[95:64] = %h (455b1a72)", R[95:64]);
+        $display("200: A-B[63:32] = %h (8298b11c)", R[63:32]);
+        $display("200: A-B[31:0] = %h (231518ee)", R[31:0]);
+        R <= B - A;
+        #0.01;
+        $display("200: B-A[199:192] = %h (7c)", R[199:192]);
+        $display("200: B-A[191:160] = %h (a94cac43)", R[191:160]);
+        $display("200: B-A[159:128] = %h (c1e3fc3a)", R[159:128]);
+        $display("200: B-A[127:96] = %h (b5ac5546)", R[127:96]);
+        $display("200: B-A[95:64] = %h (baa4e58d)", R[95:64]);
+        $display("200: B-A[63:32] = %h (7d674ee3)", R[63:32]);
+        $display("200: B-A[31:0] = %h (dceae712)", R[31:0]);
+        R <= A * B;
+        #0.01;
+        $display("200: A*B[199:192] = %h (82)", R[199:192]);
+        $display("200: A*B[191:160] = %h (1ee0b7c)", R[191:160]);
+        $display("200: A*B[159:128] = %h (e0d36146)", R[159:128]);
+        $display("200: A*B[127:96] = %h (6e9c1fd)", R[127:96]);
+        $display("200: A*B[95:64] = %h (daaf59e7)", R[95:64]);
+        $display("200: A*B[63:32] = %h (fafbf6d1)", R[63:32]);
+        $display("200: A*B[31:0] = %h (9ab4a28)", R[31:0]);
+        R <= A << 1;
+        #0.01;
+        $display("200: A<<1[199:192] = %h (6)", R[199:192]);
+        $display("200: A<<1[191:160] = %h (e39f25c6)", R[191:160]);
+        $display("200: A<<1[159:128] = %h (88e64928)", R[159:128]);
+        $display("200: A<<1[127:96] = %h (624d7387)", R[127:96]);
+        $display("200: A<<1[95:64] = %h (73b0493c)", R[95:64]);
+        $display("200: A<<1[63:32] = %h (42b71124)", R[63:32]);
+        $display("200: A<<1[31:0] = %h (b7563dd8)", R[31:0]);
+        R <= A >> 1;
+        #0.01;
+        $display("200: A>>1[199:192] = %h (41)", R[199:192]);
+        $display("200: A>>1[191:160] = %h (b8e7c971)", R[191:160]);
+        $display("200: A>>1[159:128] = %h (a239924a)", R[159:128]);
+        $display("200: A>>1[127:96] = %h (18935ce1)", R[127:96]);
+        $display("200: A>>1[95:64] = %h (dcec124f)", R[95:64]);
+        $display("200: A>>1[63:32] = %h (10adc449)", R[63:32]);
+        $display("200: A>>1[31:0] = %h (2dd58f76)", R[31:0]);
+        R <= A << 31;
+        #0.01;
+        $display("200: A<<31[199:192] = %h (71)", R[199:192]);
+        $display("200: A<<31[191:160] = %h (a239924a)", R[191:160]);
+        $display("200: A<<31[159:128] = %h (18935ce1)", R[159:128]);
+        $display("200: A<<31[127:96] = %h (dcec124f)", R[127:96]);
+        $display("200: A<<31[95:64] = %h (10adc449)", R[95:64]);
+        $display("200: A<<31[63:32] = %h (2dd58f76)", R[63:32]);
+        $display("200: A<<31[31:0] = %h (0)", R[31:0]);
+        R <= A >> 31;
+        #0.01;
+        $display("200: A>>31[199:192] = %h (0)", R[199:192]);
+        $display("200: A>>31[191:160] = %h (106)", R[191:160]);
+        $display("200: A>>31[159:128] = %h (e39f25c6)", R[159:128]);
+        $display("200: A>>31[127:96] = %h (88e64928)", R[127:96]);
+        $display("200: A>>31[95:64] = %h (624d7387)", R[95:64]);
+        $display("200: A>>31[63:32] = %h (73b0493c)", R[63:32]);
+        $display("200: A>>31[31:0] = %h (42b71124)", R[31:0]);
+        R <= A << 64;
+        #0.01;
+        $display("200: A<<64[199:192] = %h (94)", R[199:192]);
+        $display("200: A<<64[191:160] = %h (3126b9c3)", R[191:160]);
+        $display("200: A<<64[159:128] = %h (b9d8249e)", R[159:128]);
+        $display("200: A<<64[127:96] = %h (215b8892)", R[127:96]);
+        $display("200: A<<64[95:64] = %h (5bab1eec)", R[95:64]);
+        $display("200: A<<64[63:32] = %h (0)", R[63:32]);
+        $display("200: A<<64[31:0] = %h (0)", R[31:0]);
+        R <= A >> 64;
+        #0.01;
+        $display("200: A>>64[199:192] = %h (0)", R[199:192]);
+        $display("200: A>>64[191:160] = %h (0)", R[191:160]);
+        $display("200: A>>64[159:128] = %h (83)", R[159:128]);
+        $display("200: A>>64[127:96] = %h (71cf92e3)", R[127:96]);
+        $display("200: A>>64[95:64] = %h (44732494)", R[95:64]);
+        $display("200: A>>64[63:32] = %h (3126b9c3)", R[63:32]);
+        $display("200: A>>64[31:0] = %h (b9d8249e)", R[31:0]);
+        R <= A << 195;
+        #0.01;
+        $display("200: A<<195[199:192] = %h (60)", R[199:192]);
+        $display("200: A<<195[191:160] = %h (0)", R[191:160]);
+        $display("200: A<<195[159:128] = %h (0)", R[159:128]);
+        $display("200: A<<195[127:96] = %h (0)", R[127:96]);
+        $display("200: A<<195[95:64] = %h (0)", R[95:64]);
+        $display("200: A<<195[63:32] = %h (0)", R[63:32]);
+        $display("200: A<<195[31:0] = %h (0)", R[31:0]);
+        R <= A >> 195;
+        #0.01;
+        $display("200: A>>195[199:192] = %h (0)", R[199:192]);
+        $display("200: A>>195[191:160] = %h (0)", R[191:160]);
+        $display("200: A>>195[159:128] = %h (0)", R[159:128]);
+        $display("200: A>>195[127:96] = %h (0)", R[127:96]);
+        $display("200: A>>195[95:64] = %h (0)", R[95:64]);
+        $display("200: A>>195[63:32] = %h (0)", R[63:32]);
+        $display("200: A>>195[31:0] = %h (10)", R[31:0]);
+        $display("200: A == B = %d (0)", A == B);
+        $display("200: B == A = %d (0)", B == A);
+        $display("200: A == A = %d (1)", A == A);
+        $display("200: A != B = %d (1)", A != B);
+        $display("200: B != A = %d (1)", B != A);
+        $display("200: A != A = %d (0)", A != A);
+        $display("200: A < B = %d (0)", A < B);
+        $display("200: B < A = %d (1)", B < A);
+        $display("200: A < A = %d (0)", A < A);
+        $display("200: A <= B = %d (0)", A <= B);
+        $display("200: B <= A = %d (1)", B <= A);
+        $display("200: A <= A = %d (1)", A <= A);
+        $display("200: A > B = %d (1)", A > B);
+        $display("200: B > A = %d (0)", B > A);
+        $display("200: A > A = %d (0)", A > A);
+        $display("200: A >= B = %d (1)", A >= B);
+        $display("200: B >= A = %d (0)", B >= A);
+        $display("200: A >= A = %d (1)", A >= A);
+    end
+endmodule
+
+module main;
+    reg ErrFlag;
+    reg [71:0] A72, B72;
+    reg [127:0] A128, B128, R128;
+    reg [199:0] R200;
+
+    wide72 w72();
+    wide128 w128();
+    wide200 w200();
+
+    initial begin
+        #4;
+        A72 = 72'hf2c7859faeecc3f80c;
+        B72 = 72'he47682e64a37fa2d;
+        A128 = 128'h978f18a7045f21da156393d8d46375dc;
+        B128 = 128'h87b3d9611244c06c7ab5c94e86c4fa;
+        #0.01;
+        R128 <= {A72[39:0], B128[87:0]};
+        #0.01;
+        $display("cat: {A72[39:0],B128[87:0]}[127:96] = %h (aeecc3f8)", R128[127:96]);
+        $display("cat: {A72[39:0],B128[87:0]}[95:64] = %h (c1244c0)", R128[95:64]);
+        $display("cat: {A72[39:0],B128[87:0]}[63:32] = %h (6c7ab5c9)", R128[63:32]);
+        $display("cat: {A72[39:0],B128[87:0]}[31:0] = %h (4e86c4fa)", R128[31:0]);
+        R200 <= {A128, A72};
+        #0.01;
+        $display("cat: {A128,A72}[199:192] = %h (97)", R200[199:192]);
+        $display("cat: {A128,A72}[191:160] = %h (8f18a704)", R200[191:160]);
+        $display("cat: {A128,A72}[159:128] = %h (5f21da15)", R200[159:128]);
+        $display("cat: {A128,A72}[127:96] = %h (6393d8d4)", R200[127:96]);
+        $display("cat: {A128,A72}[95:64] = %h (6375dcf2)", R200[95:64]);
+        $display("cat: {A128,A72}[63:32] = %h (c7859fae)", R200[63:32]);
+        $display("cat: {A128,A72}[31:0] = %h (ecc3f80c)", R200[31:0]);
+        R200 <= {8'h5a, B72, 1'b1, A72[70:0], 48'h123456789abc};
+        #0.01;
+        $display("cat: {8'h5a,B72,1'b1,A72[70:0],48'h123456789abc}[199:192] = %h (5a)", R200[199:192]);
+        $display("cat: {8'h5a,B72,1'b1,A72[70:0],48'h123456789abc}[191:160] = %h (e47682)", R200[191:160]);
+        $display("cat: {8'h5a,B72,1'b1,A72[70:0],48'h123456789abc}[159:128] = %h (e64a37fa)", R200[159:128]);
+        $display("cat: {8'h5a,B72,1'b1,A72[70:0],48'h123456789abc}[127:96] = %h (2df2c785)", R200[127:96]);
+        $display("cat: {8'h5a,B72,1'b1,A72[70:0],48'h123456789abc}[95:64] = %h (9faeecc3)", R200[95:64]);
+        $display("cat: {8'h5a,B72,1'b1,A72[70:0],48'h123456789abc}[63:32] = %h (f80c1234)", R200[63:32]);
+        $display("cat: {8'h5a,B72,1'b1,A72[70:0],48'h123456789abc}[31:0] = %h (56789abc)", R200[31:0]);
+        $display("<done>");
+    end
+endmodule
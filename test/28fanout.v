@@ -0,0 +1,70 @@
+// Verilog compiler test -- a signal with hundreds of dependents
+
+`timescale 1 ns / 100 ps
+
+module main;
+    reg ErrFlag;
+    reg En;
+    reg Inv;
+    reg [299:0] D;
+    tri [299:0] T;
+    wire [299:0] W;
+
+    // En and Inv each fan out to 300 bit signals
+    assign T = En ? D : 300'bz;
+    assign W = Inv ? ~D : D;
+
+    initial begin
+        En = 0;
+        Inv = 0;
+        D = 300'h23015ceb3a10b3510b0b46ee1da317017a6205738d16018366cf658f7a75ed34fe53a096533;
+        #1 En = 1;
+        Inv = 0;
+        #1;
+        $display("0: T[31:0] = %h (3a096533)", T[31:0]);
+        $display("0: W[31:0] = %h (3a096533)", W[31:0]);
+        $display("0: T[159:128] = %h (205738d1)", T[159:128]);
+        $display("0: W[159:128] = %h (205738d1)", W[159:128]);
+        $display("0: T[299:268] = %h (23015ceb)", T[299:268]);
+        $display("0: W[299:268] = %h (23015ceb)", W[299:268]);
+        En = 0;
+        #1;
+        D = 300'h7cc7589ca4a07c15471a4517d6c6694f229359b154881a0d5b3ffc6e35ccfaf00103f584ad4;
+        #1 En = 1;
+        Inv = 1;
+        #1;
+        $display("1: T[31:0] = %h (3f584ad4)", T[31:0]);
+        $display("1: W[31:0] = %h (c0a7b52b)", W[31:0]);
+        $display("1: T[159:128] = %h (359b1548)", T[159:128]);
+        $display("1: W[159:128] = %h (ca64eab7)", W[159:128]);
+        $display("1: T[299:268] = %h (7cc7589c)", T[299:268]);
+        $display("1: W[299:268] = %h (8338a763)", W[299:268]);
+        En = 0;
+        #1;
+        D = 300'h7c216edc5d467164890d49d0ac1e5b8063831360a4092b850ad7eb72f8263f65da874007cb4;
+        #1 En = 1;
+        Inv = 0;
+        #1;
+        $display("2: T[31:0] = %h (74007cb4)", T[31:0]);
+        $display("2: W[31:0] = %h (74007cb4)", W[31:0]);
+        $display("2: T[159:128] = %h (31360a40)", T[159:128]);
+        $display("2: W[159:128] = %h (31360a40)", W[159:128]);
+        $display("2: T[299:268] = %h (7c216edc)", T[299:268]);
+        $display("2: W[299:268] = %h (7c216edc)", W[299:268]);
+        En = 0;
+        #1;
+        D = 300'he94e6edaf80796d3bc4685ca8af852a5fba444adf42b37f5722051e2670c24f6aa83bf36a14;
+        #1 En = 1;
+        Inv = 1;
+        #1;
+        $display("3: T[31:0] = %h (3bf36a14)", T[31:0]);
+        $display("3: W[31:0] = %h (c40c95eb)", W[31:0]);
+        $display("3: T[159:128] = %h (444adf42)", T[159:128]);
+        $display("3: W[159:128] = %h (bbb520bd)", W[159:128]);
+        $display("3: T[299:268] = %h (e94e6eda)", T[299:268]);
+        $display("3: W[299:268] = %h (16b19125)", W[299:268]);
+        En = 0;
+        #1;
+        $display("<done>");
+    end
+endmodule
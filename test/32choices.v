@@ -0,0 +1,34 @@
+// Verilog compiler test -- test choices, each run alone or all by -a
+
+`timescale 1 ns / 100 ps
+
+module main;
+    reg ErrFlag;
+    reg [7:0] Count;
+
+    initial begin
+`ifdef ONE
+        Count = 11;
+`endif
+`ifdef TWO
+        Count = 12;
+`endif
+`ifdef THREE
+        Count = 13;
+`endif
+        #1;
+`ifdef ONE
+        $display("ONE: Count = %d (11)", Count);
+        $display("ONE: TEST_CHOICE = %s (ONE)", `TEST_CHOICE);
+`endif
+`ifdef TWO
+        $display("TWO: Count = %d (12)", Count);
+        $display("TWO: TEST_CHOICE = %s (TWO)", `TEST_CHOICE);
+`endif
+`ifdef THREE
+        $display("THREE: Count = %d (13)", Count);
+        $display("THREE: TEST_CHOICE = %s (THREE)", `TEST_CHOICE);
+`endif
+        $display("<done>");
+    end
+endmodule
@@ -11,7 +11,7 @@
 #
 ###############################################################################
 
-import sys, os, string, time, re
+import sys, os, string, time, re, shutil
 import subprocess as sb
 
 pvsim = "../pvsimu"
@@ -57,23 +57,26 @@ expErrPat1 = re.compile(r".*<experr>([^<]+)</experr>.*")
 expErrPat2 = re.compile(r"^// ... ERROR.*")
 expErrPat3 = re.compile(r"^// ... *(.+)")
 
-# Run a simulation of each Verilog .psim file, and check that resulting output
-# lines match their expect values
+# Return a test's event file lines, less those that change on every run
 
-for vfile in vfiles:
-    print(59*"=")
-    print("=== TEST", vfile)
-    print(59*"=")
-    vfilebase, ext = os.path.splitext(vfile)
-    pr = sb.Popen([pvsim, "-q", vfilebase + ".psim"],
-                  stdout=sb.PIPE, stderr=sb.STDOUT)
-    ofile = pr.stdout
+def readEvents(vfilebase):
+    try:
+        lines = open(vfilebase + ".events").readlines()
+    except IOError:
+        return None
+    return [l for l in lines if not re.match(r"(RunDate|CompiledDate):", l)]
+
+defaultEvents = {}
+
+# Check a test's output lines against their expect values. Returns the number
+# of errors found
+
+def checkOutput(lines):
     testErrs = 0
     expectErrMsgState = 0
     done = False
 
-    for i, line in enumerate(ofile.readlines()):
-        line = line.decode('utf-8').strip()  # Decode the bytes to a string and strip whitespace
+    for line in lines:
         m = resultPat.match(line)
         if m:
             # line is a test result: check it
@@ -116,10 +119,198 @@ for vfile in vfiles:
     if not done:
         reportErr("End of file")
         testErrs += 1
-    ofile.close()
+    return testErrs
+
+# Run a simulation of each Verilog .psim file, with the given extra pvsim
+# options and environment, and check that resulting output lines match their
+# expect values, and that its events match those of the default run
+
+def runTest(vfile, opts, env):
+    print(59*"=")
+    print("=== TEST", vfile, " ".join(opts))
+    print(59*"=")
+    vfilebase, ext = os.path.splitext(vfile)
+    runEnv = dict(os.environ)
+    runEnv.update(env)
+    pr = sb.Popen([pvsim, "-q"] + opts + [vfilebase + ".psim"],
+                  stdout=sb.PIPE, stderr=sb.STDOUT, env=runEnv)
+    # Decode the bytes to strings and strip whitespace
+    lines = [l.decode('utf-8').strip() for l in pr.stdout.readlines()]
+    pr.wait()
+    testErrs = checkOutput(lines)
+    events = readEvents(vfilebase)
+    if not opts:
+        defaultEvents[vfile] = events
+    elif events != defaultEvents.get(vfile):
+        reportErr("Events differ from default run")
+        testErrs += 1
     print("Test done, %d error%s.\n" % \
           (testErrs, ("s", "")[testErrs == 1]))
-    totalErrs += testErrs
+    return testErrs
+
+# Each test is run in the default mode, then again in each of these modes,
+# which must all give the same results. Native code is built in a directory
+# of its own, and again in an empty one without a compiler, so that it falls
+# back to interpreting.
+
+nativeDir = "native"
+noCompilerDir = "native_nocc"
+if os.path.isdir(noCompilerDir):
+    shutil.rmtree(noCompilerDir)
+for d in (nativeDir, noCompilerDir):
+    if not os.path.isdir(d):
+        os.mkdir(d)
+
+modes = [
+    ([], {}),
+    (["-j4"], {}),              # parallel evaluation of large fanouts
+    (["-p"], {}),               # activity profiler
+    (["-p", "-j4"], {}),        # profiler with parallel evaluation
+    (["-s1"], {}),              # scheduler telemetry every ns
+    (["-n"], {}),               # P-code not optimized
+    (["-x" + nativeDir], {}),   # native code
+    (["-x" + noCompilerDir], {"CXX": "/nonexistent/c++"}),
+]
+
+for opts, env in modes:
+    for vfile in vfiles:
+        totalErrs += runTest(vfile, opts, env)
+
+# Native mode must have built both P-code and gate equation libraries, when
+# running the whole suite
+
+if len(sys.argv) == 1:
+    for prefix, what in (("pvnat_", "P-code"), ("pveq_", "gate equation")):
+        if not [f for f in os.listdir(nativeDir)
+                if f.startswith(prefix) and f.endswith(".so")]:
+            reportErr("No native %s library built" % what)
+            totalErrs += 1
+
+# Each test is run twice more with a design cache, and again with native
+# code as well: the first pass must write each design's cache file, and the
+# second must read it back instead of compiling, leaving the file as is.
+
+cacheDir = "design_cache"
+if os.path.isdir(cacheDir):
+    shutil.rmtree(cacheDir)
+os.mkdir(cacheDir)
+
+def cacheFiles():
+    files = {}
+    for f in os.listdir(cacheDir):
+        st = os.stat(os.path.join(cacheDir, f))
+        files[f] = (st.st_ino, st.st_mtime_ns)
+    return files
+
+for opts in (["-k" + cacheDir], ["-k" + cacheDir, "-x" + nativeDir]):
+    for vfile in vfiles:
+        totalErrs += runTest(vfile, opts, {})
+    written = cacheFiles()
+    for vfile in vfiles:
+        totalErrs += runTest(vfile, opts, {})
+    if not written or cacheFiles() != written:
+        reportErr("Design cache not reused with %s" % " ".join(opts))
+        totalErrs += 1
+
+# Run all the test choices of each test that declares them with -a, and check
+# the output of each choice
+
+testsDonePat = re.compile(r"^\[(\d+) tests, (\d+) failed")
+
+def testChoicesTest(vfile):
+    vfilebase, ext = os.path.splitext(vfile)
+    psim = vfilebase + ".psim"
+    choices = [l.split()[1] for l in open(psim).readlines()
+               if l.startswith("test_choice")]
+    if not choices:
+        return 0
+    print(59*"=")
+    print("=== TEST CHOICES", vfile, " ".join(choices))
+    print(59*"=")
+    testErrs = 0
+    logNames = ["%s_%s.log" % (vfilebase, choice) for choice in choices]
+    for logName in logNames:
+        if os.path.exists(logName):
+            os.remove(logName)
+    pr = sb.Popen([pvsim, "-q", "-a2", psim], stdout=sb.PIPE, stderr=sb.STDOUT)
+    lines = [l.decode('utf-8').strip() for l in pr.stdout.readlines()]
+    pr.wait()
+    summary = [m for m in map(testsDonePat.match, lines) if m]
+    for line in lines:
+        print(line)
+    if not summary or summary[0].groups() != (str(len(choices)), "0"):
+        reportErr("Not all test choices passed")
+        testErrs += 1
+    for choice, logName in zip(choices, logNames):
+        print("--- choice", choice)
+        if not os.path.exists(logName):
+            reportErr("No log for test choice " + choice)
+            testErrs += 1
+            continue
+        lines = [l.strip() for l in open(logName).readlines()]
+        testErrs += checkOutput(lines)
+    print("Test done, %d error%s.\n" % \
+          (testErrs, ("s", "")[testErrs == 1]))
+    return testErrs
+
+for vfile in vfiles:
+    totalErrs += testChoicesTest(vfile)
+
+# Checkpoint each test partway through, restore the checkpoint in a new run,
+# and check that the restored run's output after the checkpoint, and its
+# event file's bar signal, match those of the first run
+
+checkpointNS = 1
+skipPat = re.compile(r"^(\[.*|done\.|.*Kevents.*|\*\*\* .*WARNING.*|)$")
+
+def runOutput(args, startPat):
+    pr = sb.Popen([pvsim] + args, stdout=sb.PIPE, stderr=sb.STDOUT)
+    lines = [l.decode('utf-8').strip() for l in pr.stdout.readlines()]
+    pr.wait()
+    for i, line in enumerate(lines):
+        if startPat in line:
+            return [l for l in lines[i+1:] if not skipPat.match(l)]
+    return None
+
+def barSignal(vfilebase):
+    for line in open(vfilebase + ".events").readlines():
+        if line.startswith("BarSignal:"):
+            return line.strip()
+    return None
+
+def checkpointTest(vfile):
+    print(59*"=")
+    print("=== CHECKPOINT", vfile, "at", checkpointNS, "ns")
+    print(59*"=")
+    vfilebase, ext = os.path.splitext(vfile)
+    psim = vfilebase + ".psim"
+    ckpt = vfilebase + ".ckpt"
+    if os.path.exists(ckpt):
+        os.remove(ckpt)
+    testErrs = 0
+    first = runOutput(["-c%d" % checkpointNS, psim], "wrote checkpoint")
+    if first is None:
+        print("no checkpoint written")
+        return 0
+    firstBar = barSignal(vfilebase)
+    restored = runOutput(["-r" + ckpt, psim], "simulating from")
+    if restored != first:
+        for line in restored or []:
+            print(line)
+        reportErr("Restored output differs after checkpoint")
+        testErrs += 1
+    else:
+        print("%d lines after checkpoint OK" % len(first))
+    if barSignal(vfilebase) != firstBar:
+        reportErr("Restored bar signal differs")
+        testErrs += 1
+    os.remove(ckpt)
+    print("Test done, %d error%s.\n" % \
+          (testErrs, ("s", "")[testErrs == 1]))
+    return testErrs
+
+for vfile in vfiles:
+    totalErrs += checkpointTest(vfile)
 
 print(59*"=")
 print("==== All test done, %d error%s total." % \